@@ -0,0 +1,517 @@
+/**
+ * @file bench.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host benchmark of the portable layers. Prints one JSON object per line:
+ * @code {"bench":"<name>",<parameters>,"calls":<n>,"ns_per_call":<average>,"max_ns":<worst>} @endcode
+ * - encode_frame: a full frame through @ref displayStrip, that is the ConvertLeds kernel over @ref NLEDS leds
+ * - encode_kernel: both encoder kernels (@ref rgbw_GetKernel) over the same @ref NLEDS leds, without the stream.
+ *   The bench fails if their output differs
+ * - apply_brightness: a palette rebuild, applyBrightness of every palette color
+ * - render: @ref showFull + @ref dispStrips
+ * - pixel_write: every led written one by one (@ref ledStrip_FillPixels), the color copied from the palette and
+ *   scaled at every write as it was before the palette. "ns_per_pixel" is the cost of one write
+ * - timeline: one 100ms step of the timeline processing, over a pit stop timeline whose phases do nothing
+ *   (@ref led_control_TimelineStep)
+ * - led_control: one 100ms step of every mode, the timelines and the strip encoding included
+ * - config: one step of the config walk with the button pressed at power on and tapped later
+ * - phase_c, phase_pattern: one 100ms step of a phase in C as it was before user-017 (ref_phases.c) and of its pattern
+ *   program from @ref led_control_GetPatterns. Both must put the same strip at every step, the bench fails if they don't.
+ *   The phases run their whole time with --quick too. "flash_bytes" is the bytecode size for the pattern, that is the size on the target, and the host code size of the
+ *   C phase, it's only for comparing as the target code is thumb
+ * - kf_live, kf_player: one 100ms step of a mode run live by led_control and of the same frames played from a keyframe
+ *   stream (keyframe.h) that the host exporter (keyframe_export.h) made of the live run, with the strip update of
+ *   the step. The time saved per step is the difference of the two. "stream_bytes" is the flash the stream would take. Modes whose rows differ can't be exported and are
+ *   skipped. Pit invite is played from its hand-written stream in the firmware, so both of its figures are a player
+ * - frame_time: wire time of the frames sent by led_control, from the first bit to the end of the stream on the slowest
+ *   channel. It's counted from the CCR stream of the timer fake, so it's the target time of the @ref STRIP_LAYOUT
+ *   the bench is built with (bench_parallel is built with @ref STRIP_LAYOUT_PARALLEL)
+ * Other times are of the host cpu, they are for comparing changes, not for the target budget.
+ * Every mode runs in its own process as the modes keep state in static variables.
+ * Usage: bench [--quick]
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host.h"
+#include "sim.h"
+#include "buttons.h"
+#include "led_strip.h"
+#include "clock.h"
+#include "led_control.h"
+#include "pattern.h"
+#include "ref_phases.h"
+#include "keyframe.h"
+#include "keyframe_export.h"
+#include "timer_dma.h"
+#include "rgbw.h"
+#include "project_conf.h"
+
+enum
+{
+	STEP_MS = 100,            /**< led_control step */
+	RUN_MS = 600000,          /**< Simulated time of one mode */
+	QUICK_RUN_MS = 60000,     /**< Simulated time of one mode with --quick */
+	KERNEL_CALLS = 20000,     /**< Calls of the kernel benchmarks */
+	QUICK_KERNEL_CALLS = 1000, /**< Calls of the kernel benchmarks with --quick */
+	KF_RUN_MS = 120000,       /**< Exported time of a mode */
+	KF_PLAY_START = 1000000,  /**< Tick when the stream playback starts */
+	KF_STREAM_SIZE = 64 * 1024 /**< Stream buffer size */
+};
+
+/**
+ * @brief Timing of one benchmark
+ */
+typedef struct
+{
+	uint32_t calls; /**< Number of calls */
+	uint64_t total; /**< Total ns */
+	uint64_t max;   /**< Worst ns */
+} Bench_t;
+
+static uint8_t quick = 0;
+static uint32_t waveBits[STRIP_CHANNELS]; /**< Bit periods sent on every channel since the last frame_time sample */
+
+/**
+ * @brief Wave hook of the strip fake, counts the bit periods sent
+ * @param ch channel
+ * @param ccr CCR values
+ * @param n number of values
+ */
+static void countWave(const uint8_t ch, const uint8_t * const ccr, const uint16_t n)
+{
+	(void)ccr;
+	waveBits[ch] += n;
+}
+
+/**
+ * @brief Takes the wire time of the frames sent since the last call
+ * @param b frame_time timing
+ */
+static void frameTimeAdd(Bench_t * const b)
+{
+	uint32_t bits = 0;
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		bits = (waveBits[ch] > bits) ? waveBits[ch] : bits;
+		waveBits[ch] = 0;
+	}
+	if (bits != 0)
+	{
+		const uint64_t ns = (uint64_t)bits * STRIP_BIT_TICKS * 1000000000u / STRIP_TIMER_CLOCK_HZ;
+		b->calls++;
+		b->total += ns;
+		b->max = (ns > b->max) ? ns : b->max;
+	}
+}
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void benchAdd(Bench_t * const b, const uint64_t start)
+{
+	const uint64_t ns = nowNs() - start;
+	b->calls++;
+	b->total += ns;
+	b->max = (ns > b->max) ? ns : b->max;
+}
+
+/**
+ * @brief Prints the result line
+ * @param name benchmark name
+ * @param params extra JSON members with the trailing comma or an empty string
+ * @param b timing
+ */
+static void benchPrint(const char * const name, const char * const params, const Bench_t * const b)
+{
+	printf("{\"bench\":\"%s\",%s\"calls\":%u,\"ns_per_call\":%llu,\"max_ns\":%llu}\n", name, params, b->calls,
+			(unsigned long long)((b->calls != 0) ? b->total / b->calls : 0), (unsigned long long)b->max);
+	fflush(stdout);
+}
+
+static void benchEncode(void)
+{
+	static Led_t Leds[NLEDS];
+	uint16_t nleds[STRIP_CHANNELS];
+	char params[64];
+	Bench_t b = {0};
+	const uint32_t calls = (quick != 0) ? QUICK_KERNEL_CALLS : KERNEL_CALLS;
+	for (uint16_t i = 0; i < NLEDS; i++)
+	{
+		Leds[i].R = (uint8_t)(i * 7u);
+		Leds[i].G = (uint8_t)(i * 13u);
+		Leds[i].B = (uint8_t)(i * 29u);
+	}
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		nleds[ch] = CHANNEL_LEDS;
+	}
+	Host_StripCapture(0);
+	for (uint32_t i = 0; i < calls; i++)
+	{
+		const uint64_t start = nowNs();
+		displayStrip(Leds, nleds);
+		benchAdd(&b, start);
+	}
+	Host_StripCapture(!0);
+	snprintf(params, sizeof(params), "\"encoder\":\"%s\",\"leds\":%u,",
+			(LED_ENCODER == ENCODER_TABLE) ? "table" : "bitwise", (unsigned)NLEDS);
+	benchPrint("encode_frame", params, &b);
+}
+
+/**
+ * @brief Times both encoder kernels on the same leds
+ * @return zero if they give the same CCR values
+ */
+static int benchKernels(void)
+{
+	static Led_t Leds[NLEDS];
+	static uint32_t Bits[2][NLEDS * sizeof(Led_t) * 8 / sizeof(uint32_t)]; /* Word aligned as the table kernel needs */
+	static const uint8_t Encoders[2] = {ENCODER_BITWISE, ENCODER_TABLE};
+	char params[64];
+	const uint32_t calls = (quick != 0) ? QUICK_KERNEL_CALLS : KERNEL_CALLS;
+	for (uint16_t i = 0; i < NLEDS; i++)
+	{
+		uint8_t * const colors = (uint8_t *)&Leds[i];
+		for (uint8_t c = 0; c < sizeof(Led_t); c++)
+		{
+			colors[c] = (uint8_t)(i * 7u + c * 61u);
+		}
+	}
+	for (uint8_t e = 0; e < sizeof(Encoders); e++)
+	{
+		Bench_t b = {0};
+		const pRgbwKernel_t kernel = rgbw_GetKernel(Encoders[e]);
+		for (uint32_t i = 0; i < calls; i++)
+		{
+			const uint64_t start = nowNs();
+			kernel(Leds, (uint8_t *)Bits[e], NLEDS);
+			benchAdd(&b, start);
+		}
+		snprintf(params, sizeof(params), "\"encoder\":\"%s\",\"leds\":%u,",
+				(Encoders[e] == ENCODER_TABLE) ? "table" : "bitwise", (unsigned)NLEDS);
+		benchPrint("encode_kernel", params, &b);
+	}
+	return (memcmp(Bits[0], Bits[1], sizeof(Bits[0])) == 0) ? 0 : 1;
+}
+
+static void benchBrightness(void)
+{
+	Bench_t b = {0};
+	const uint32_t calls = (quick != 0) ? QUICK_KERNEL_CALLS : KERNEL_CALLS;
+	for (uint32_t i = 0; i < calls; i++)
+	{
+		const uint64_t start = nowNs();
+		setBrightness((uint8_t)(i & 1u)); /* Every change rebuilds the palette */
+		benchAdd(&b, start);
+	}
+	benchPrint("apply_brightness", "", &b);
+}
+
+static void benchPixels(void)
+{
+	char params[64];
+	const uint32_t calls = (quick != 0) ? QUICK_KERNEL_CALLS : KERNEL_CALLS;
+	setBrightness(MAX_BRIGHNESS_LEVELS - 2);
+	for (uint8_t scaled = 0; scaled < 2; scaled++)
+	{
+		Bench_t b = {0};
+		for (uint32_t i = 0; i < calls; i++)
+		{
+			const uint64_t start = nowNs();
+			ledStrip_FillPixels(((i & 1u) != 0) ? RED : BLUE, scaled); /* Every led is changed */
+			benchAdd(&b, start);
+		}
+		snprintf(params, sizeof(params), "\"path\":\"%s\",\"ns_per_pixel\":%.1f,", (scaled != 0) ? "scaled" : "palette",
+				(double)b.total / b.calls / NLEDS);
+		benchPrint("pixel_write", params, &b);
+	}
+}
+
+static void benchRender(void)
+{
+	Bench_t b = {0};
+	const uint32_t calls = (quick != 0) ? QUICK_KERNEL_CALLS : KERNEL_CALLS;
+	setBrightness(MAX_BRIGHNESS_LEVELS - 2);
+	for (uint32_t i = 0; i < calls; i++)
+	{
+		const uint64_t start = nowNs();
+		showFull(((i & 1u) != 0) ? RED : BLUE);
+		dispStrips(GREEN,5);
+		benchAdd(&b, start);
+	}
+	benchPrint("render", "", &b);
+}
+
+static void benchTimeline(void)
+{
+	Bench_t b = {0};
+	const uint32_t calls = (quick != 0) ? QUICK_KERNEL_CALLS : KERNEL_CALLS;
+	uint32_t ms = 0;
+	for (uint32_t i = 0; i < calls; i++)
+	{
+		uint8_t ended;
+		const uint64_t start = nowNs();
+		led_control_TimelineStep(ms, &ended);
+		benchAdd(&b, start);
+		ms = (ended != 0) ? 0 : ms + STEP_MS;
+	}
+	benchPrint("timeline", "", &b);
+}
+
+/**
+ * @brief Runs the C phase and its pattern program side by side
+ * @param ref C phase
+ * @return zero if both put the same strip at every step
+ */
+static int benchPhase(const Ref_Phase_t * const ref)
+{
+	static Led_t Expected[NLEDS];
+	char params[96];
+	Bench_t c = {0};
+	Bench_t pat = {0};
+	Pattern_t p;
+	uint8_t n;
+	uint32_t mismatch = 0;
+	const Pattern_Desc_t * const all = led_control_GetPatterns(&n);
+	const Pattern_Desc_t * desc = NULL;
+	for (uint8_t i = 0; i < n && desc == NULL; i++)
+	{
+		desc = (strcmp(all[i].name, ref->name) == 0) ? all + i : NULL;
+	}
+	if (desc == NULL)
+	{
+		printf("{\"bench\":\"phase\",\"phase\":\"%s\",\"error\":\"no pattern\"}\n", ref->name);
+		return 1;
+	}
+	const uint32_t base = GetTicksCounter() + STEP_MS; /* The ticks only go forward */
+	for (uint32_t ms = base; ms < base + ref->runMs; ms += STEP_MS)
+	{
+		Host_SetTicks(ms);
+		uint64_t start = nowNs();
+		ref->phase(ms == base);
+		benchAdd(&c, start);
+		sendDataToStrip();
+		memcpy(Expected, Host_GetStrip(), sizeof(Expected));
+
+		start = nowNs();
+		if (ms == base)
+		{
+			Pattern_Start(&p, desc->prog, NULL, ms);
+		}
+		Pattern_Run(&p, ms);
+		benchAdd(&pat, start);
+		sendDataToStrip();
+		mismatch += (memcmp(Expected, Host_GetStrip(), sizeof(Expected)) != 0 || p.fault != 0);
+	}
+	snprintf(params, sizeof(params), "\"phase\":\"%s\",\"flash_bytes\":%u,\"mismatches\":%u,", ref->name,
+			(unsigned)(ref->codeEnd - ref->codeStart), (unsigned)mismatch);
+	benchPrint("phase_c", params, &c);
+	snprintf(params, sizeof(params), "\"phase\":\"%s\",\"flash_bytes\":%u,\"mismatches\":%u,", ref->name,
+			(unsigned)desc->size, (unsigned)mismatch);
+	benchPrint("phase_pattern", params, &pat);
+	return (mismatch == 0) ? 0 : 1;
+}
+
+/**
+ * @brief Button level of the config walk: held at power on, then a tap every 1.5s and a long press every 10s
+ * @param ms time
+ * @return nonzero if pressed
+ */
+static uint8_t configButton(const uint32_t ms)
+{
+	uint8_t pressed;
+	if (ms < 500)
+	{
+		pressed = !0;
+	}
+	else if (ms % 10000 < 2500)
+	{
+		pressed = ms % 10000 >= 200;
+	}
+	else
+	{
+		pressed = ms % 1500 < 200;
+	}
+	return pressed;
+}
+
+/**
+ * @brief Runs led_control steps of one boot
+ * @param name benchmark name
+ * @param mode mode
+ * @param config nonzero to walk the config instead of the mode
+ */
+static void benchMode(const char * const name, const Working_Mode_t mode, const uint8_t config)
+{
+	char params[64];
+	Bench_t b = {0};
+	Bench_t frames = {0};
+	const Config_t conf = Sim_DefaultConfig(mode);
+	const uint32_t run = (quick != 0) ? QUICK_RUN_MS : RUN_MS;
+	Sim_Boot(&conf, 0x1234, config);
+	Host_StripCapture(0);
+	Host_SetWaveHook(countWave);
+	for (uint32_t ms = 0; ms < run; ms += STEP_MS)
+	{
+		Host_SetTicks(ms);
+		if (config != 0)
+		{
+			Host_SetButton(configButton(ms));
+		}
+		Button_Process(B_CONFIG);
+		const uint64_t start = nowNs();
+		led_control(ms);
+		benchAdd(&b, start);
+		frameTimeAdd(&frames);
+	}
+	Host_SetWaveHook(NULL);
+	snprintf(params, sizeof(params), "\"mode\":\"%s\",", Sim_ModeName(mode));
+	benchPrint(name, params, &b);
+	snprintf(params, sizeof(params), "\"layout\":\"%s\",\"mode\":\"%s\",",
+			(STRIP_LAYOUT == STRIP_LAYOUT_PARALLEL) ? "parallel" : "serial", Sim_ModeName(mode));
+	benchPrint("frame_time", params, &frames);
+}
+
+/**
+ * @brief Runs the mode live, then exports its frames and plays the stream. Both are stepped as led_control is and
+ * are timed without the strip capture of the host. The live run is timed in its own process, as the export run
+ * needs the capture and the mode can run only once in a process
+ * @param name not used, the names are kf_live and kf_player
+ * @param mode mode
+ * @param config not used
+ */
+static void benchKeyframes(const char * const name, const Working_Mode_t mode, const uint8_t config)
+{
+	static Kfx_Capture_t capture;
+	static uint8_t stream[KF_STREAM_SIZE];
+	char params[96];
+	Keyframe_Player_t p;
+	(void)name;
+	(void)config;
+	const Config_t conf = Sim_DefaultConfig(mode);
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		Bench_t live = {0};
+		Sim_Boot(&conf, 0x1234, 0);
+		Host_StripCapture(0);
+		for (uint32_t ms = 0; ms < KF_RUN_MS; ms += STEP_MS)
+		{
+			Host_SetTicks(ms);
+			Button_Process(B_CONFIG);
+			const uint64_t start = nowNs();
+			led_control(ms);
+			benchAdd(&live, start);
+		}
+		snprintf(params, sizeof(params), "\"mode\":\"%s\",", Sim_ModeName(mode));
+		benchPrint("kf_live", params, &live);
+		_exit(0);
+	}
+	if (pid > 0)
+	{
+		waitpid(pid, NULL, 0);
+	}
+
+	Kfx_Start(&capture, conf.brightness);
+	Sim_Boot(&conf, 0x1234, 0);
+	for (uint32_t ms = 0; ms < KF_RUN_MS; ms += STEP_MS)
+	{
+		Host_SetTicks(ms);
+		Button_Process(B_CONFIG);
+		led_control(ms);
+	}
+	Kfx_Stop();
+	const uint32_t size = (capture.error[0] == 0) ? Kfx_Encode(&capture, stream, sizeof(stream)) : 0;
+	if (size == 0)
+	{
+		printf("{\"bench\":\"kf_player\",\"mode\":\"%s\",\"skipped\":\"%s\"}\n", Sim_ModeName(mode),
+				(capture.error[0] != 0) ? capture.error : "stream too long");
+		return;
+	}
+	Bench_t player = {0};
+	Host_StripCapture(0);
+	Keyframe_Start(&p, stream, BLACK, NULL, KF_PLAY_START);
+	for (uint32_t ms = 0; ms < KF_RUN_MS; ms += STEP_MS)
+	{
+		Host_SetTicks(KF_PLAY_START + ms);
+		const uint64_t start = nowNs();
+		if (Keyframe_Run(&p, KF_PLAY_START + ms) != 0)
+		{
+			sendDataToStrip();
+		}
+		else
+		{
+			refreshStrip();
+		}
+		benchAdd(&player, start);
+	}
+	snprintf(params, sizeof(params), "\"mode\":\"%s\",\"stream_bytes\":%u,", Sim_ModeName(mode), (unsigned)size);
+	benchPrint("kf_player", params, &player);
+}
+
+/**
+ * @brief Runs the benchmark in a child process so it starts with the initial static state
+ * @param bench benchmark
+ * @param name benchmark name
+ * @param mode mode
+ * @param config nonzero to walk the config
+ * @return zero if the child succeeded
+ */
+static int forkMode(void (*bench)(const char * const, const Working_Mode_t, const uint8_t), const char * const name,
+		const Working_Mode_t mode, const uint8_t config)
+{
+	int status = -1;
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		bench(name, mode, config);
+		_exit(0);
+	}
+	if (pid > 0)
+	{
+		waitpid(pid, &status, 0);
+	}
+	return (status == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	int failed = 0;
+	quick = (argc > 1 && strcmp(argv[1], "--quick") == 0);
+	const Config_t conf = Sim_DefaultConfig(MODE_PIT);
+	Sim_Boot(&conf, 0x1234, 0);
+	benchEncode();
+	failed |= benchKernels();
+	benchBrightness();
+	benchPixels();
+	benchRender();
+	benchTimeline();
+	for (uint8_t mode = 0; mode < MODE_TOTAL; mode++)
+	{
+		failed |= forkMode(benchMode, "led_control", (Working_Mode_t)mode, 0);
+	}
+	failed |= forkMode(benchMode, "config", MODE_PIT, !0);
+	for (uint8_t mode = 0; mode < MODE_TOTAL; mode++)
+	{
+		failed |= forkMode(benchKeyframes, "", (Working_Mode_t)mode, 0);
+	}
+	/* The modes run in their own processes, so the ticks of this one are still at the start */
+	uint8_t nref;
+	const Ref_Phase_t * const refs = Ref_GetPhases(&nref);
+	for (uint8_t i = 0; i < nref; i++)
+	{
+		failed |= benchPhase(refs + i);
+	}
+	return failed;
+}
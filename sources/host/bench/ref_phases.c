@@ -0,0 +1,143 @@
+/**
+ * @file ref_phases.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief C versions of tlight, ironB1_29 and ironB30 of led_control.c as they were before user-017 ported them to
+ * patterns. Every phase is put to its own section, so its code size is the size of the section
+ */
+#include <stddef.h>
+#include "ref_phases.h"
+#include "clock.h"
+#include "project_conf.h"
+
+/**
+ * @brief Puts the function to the section of the phase. The linker defines __start_ and __stop_ of it
+ */
+#define REF_SECTION(phase) __attribute__((section("ref_" #phase), noinline))
+
+extern const char __start_ref_tlight[], __stop_ref_tlight[];
+extern const char __start_ref_ironB1_29[], __stop_ref_ironB1_29[];
+extern const char __start_ref_ironB30[], __stop_ref_ironB30[];
+
+static const uint16_t S = 1000u; /**< millisecons per second */
+
+REF_SECTION(tlight) static void dispRedStrips(const uint8_t nstrips)
+{
+	dispStrips(RED,nstrips);
+}
+
+REF_SECTION(tlight) static uint8_t tlight(const uint8_t init)
+{
+	static uint8_t nstrips;
+	uint8_t changed = 0;
+	static uint32_t timer;
+	if (init != 0)
+	{
+		nstrips = 5;
+		ResetTimer(&timer);
+		dispRedStrips(nstrips);
+		changed = !0;
+	}
+	if (IsExpiredTimer(&timer,1000) != 0)
+	{
+		changed = !0;
+		nstrips = (nstrips == 0) ? 0 : nstrips - 1;
+		dispRedStrips(nstrips);
+		ResetTimer(&timer);
+	}
+	return changed;
+}
+
+REF_SECTION(ironB1_29) static uint8_t ironB1_29(const uint8_t _init)
+{
+    static uint8_t subphase = 0; /* 0 based, 0:29 */
+    static uint8_t on = 0;
+    static uint32_t blinkTimer = 0;
+    static uint32_t subphaseTimer = 0;
+    const uint32_t subphasePeriod = 24 * S;
+    const uint8_t nphases = 30;
+    const uint32_t blinkPeriod = 1 * S;
+    uint8_t retval = 0;
+
+    if (_init != 0)
+    {
+        subphase = 0;
+        ResetTimer(&blinkTimer);
+        ResetTimer(&subphaseTimer);
+        on = 0;
+    }
+    if (IsExpiredTimer(&subphaseTimer, subphasePeriod) != 0)
+    {
+        subphase = (subphase >= nphases - 1 ) ? nphases - 1 : subphase + 1;
+        ResetTimer(&subphaseTimer);
+    }
+    if (IsExpiredTimer(&blinkTimer, blinkPeriod) != 0)
+    {
+        ResetTimer(&blinkTimer);
+        showFull(BLACK);
+        if (on != 0)
+        {
+            for (uint8_t i = subphase; i <= subphase + 6; i += 2)
+            {
+                put2pixels(RED,i);
+                put2pixels(RED,71 - i);
+            }
+        }
+        retval = !0;
+        on = !on;
+    }
+    return retval;
+}
+
+REF_SECTION(ironB30) static uint8_t ironB30row(const uint8_t _init, const uint8_t _row)
+{
+    uint8_t changed = 0;
+    if (_init != 0)
+    {
+        showFull(BLACK);
+        for (uint8_t i = 29; i <= 29 + 6; i += 2)
+        {
+            putPixel(_row, i, RED);
+            putPixel(_row, 71 - i, RED);
+        }
+
+        changed = !0;
+    }
+    return changed;
+}
+
+REF_SECTION(ironB30) static uint8_t ironB30row0(const uint8_t _init)
+{
+    return ironB30row(_init, 0);
+}
+
+REF_SECTION(ironB30) static uint8_t ironB30row1(const uint8_t _init)
+{
+    return ironB30row(_init, 1);
+}
+
+REF_SECTION(ironB30) static uint8_t ironB30(const uint8_t _init)
+{
+    static const Blink_t blinkDesc =
+            {
+                    .on = S / 2,
+                    .off = S / 2,
+                    .pOnPhase = ironB30row0,
+                    .pOffPhase = ironB30row1
+            };
+    return blink(_init,&blinkDesc);
+}
+
+const Ref_Phase_t * Ref_GetPhases(uint8_t * const n)
+{
+	static const Ref_Phase_t Phases[] =
+	{
+			{"tlight", tlight, 10000, __start_ref_tlight, __stop_ref_tlight},
+			{"ironB1_29", ironB1_29, 30 * 24 * 1000, __start_ref_ironB1_29, __stop_ref_ironB1_29},
+			{"ironB30", ironB30, 60000, __start_ref_ironB30, __stop_ref_ironB30}
+	};
+	*n = sizeof(Phases) / sizeof(Phases[0]);
+	return Phases;
+}
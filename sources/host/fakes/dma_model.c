@@ -0,0 +1,289 @@
+/**
+ * @file dma_model.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Timing model of the strip timers, their dma channels and the dma interrupts (see dma_model.h).
+ * The time is in cpu cycles, the timers run from the cpu clock. Both timers are started together by tim2_Init, so
+ * their updates come at the same time. The strip interrupts have the same priority: one handler runs at a time,
+ * the lower channel first
+ */
+#include <stddef.h>
+#include <string.h>
+#include "stm32f1xx.h"
+#include "gpio.h"
+#include "timer_dma.h"
+#include "rgbw.h"
+#include "dma_model.h"
+
+enum
+{
+	STREAM_MAX = 8 * (CHANNEL_LEDS + 16) * 32, /**< CCR1 values kept per channel, a few frames with their tails */
+	FLAGS_POS_STEP = 4, /**< Distance of the flags of two dma channels in DMA1->ISR */
+	FLAGS_POS_CH0 = 4   /**< Flags of dma channel 2 */
+};
+
+RCC_TypeDef hostRcc;
+TIM_TypeDef hostTim[2];
+DMA_Channel_TypeDef hostDmaChannel[2];
+DMA_TypeDef hostDma;
+static GPIO_TypeDef gpio;
+
+void DMA1_Channel2_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+
+/**
+ * @brief Dma channel state that is not in the registers
+ */
+typedef struct
+{
+	uint8_t running;  /**< Nonzero while the channel is enabled */
+	uint32_t reload;  /**< CNDTR at enable, reloaded after every round */
+	uint32_t pos;     /**< Next byte of the round */
+	uint64_t flagAt;  /**< Time the pending flags were set */
+	uint8_t irqOn;    /**< Nonzero if the interrupt is enabled in the NVIC */
+} Channel_t;
+
+static Channel_t Channels[STRIP_CHANNELS];
+static uint8_t Stream[STRIP_CHANNELS][STREAM_MAX];
+static Model_IsrCost_t Cost;
+static Model_Stats_t Stats;
+static uint64_t now = 0;        /**< Current time */
+static uint64_t nextUpdate = 0; /**< Time of the next timer update, 0 before the timers are started */
+static uint64_t cpuFree = 0;    /**< The cpu is taken by something else up to this time */
+static int8_t isrCh = -1;       /**< Channel whose handler is running, -1 if none */
+static uint64_t isrEnd = 0;     /**< End of the running handler */
+
+/**
+ * @brief Returns the dma flags of the channel
+ * @param ch channel
+ * @return flags shifted to the channel 1 position
+ */
+static uint32_t flags(const uint8_t ch)
+{
+	return (DMA1->ISR >> (FLAGS_POS_CH0 + ch * FLAGS_POS_STEP)) & (DMA_ISR_HTIF1 | DMA_ISR_TCIF1);
+}
+
+/**
+ * @brief Sets the dma flags of the channel
+ * @param ch channel
+ * @param f flags at the channel 1 position
+ * @param t time
+ */
+static void setFlags(const uint8_t ch, const uint32_t f, const uint64_t t)
+{
+	if (flags(ch) == 0)
+	{
+		Channels[ch].flagAt = t;
+	}
+	DMA1->ISR |= (f | DMA_ISR_GIF1) << (FLAGS_POS_CH0 + ch * FLAGS_POS_STEP);
+}
+
+/**
+ * @brief Applies the flag clear register
+ * @param more flags to clear along with the ones written to IFCR
+ */
+static void clearFlags(const uint32_t more)
+{
+	DMA1->ISR &= ~(DMA1->IFCR | more);
+	DMA1->IFCR = 0;
+}
+
+/**
+ * @brief Ends the handlers that are done by the time and starts the pending ones
+ * @param t time
+ */
+static void serviceIrqs(const uint64_t t)
+{
+	for (;;)
+	{
+		if (isrCh < 0)
+		{
+			for (uint8_t ch = 0; ch < STRIP_CHANNELS && isrCh < 0; ch++)
+			{
+				if (Channels[ch].irqOn != 0 && flags(ch) != 0)
+				{
+					const uint64_t start = (Channels[ch].flagAt > cpuFree) ? Channels[ch].flagAt : cpuFree;
+					/* Every refill is taken as a full half of leds */
+					const uint32_t leds = Channels[ch].reload / 2u / (8u * sizeof(Led_t));
+					isrCh = (int8_t)ch;
+					isrEnd = start + Cost.entry + Cost.fixed + Cost.perLed * leds;
+				}
+			}
+		}
+		if (isrCh < 0 || isrEnd > t)
+		{
+			break;
+		}
+		/* The refill is done at the end of the handler */
+		const uint32_t response = (uint32_t)(isrEnd - Channels[isrCh].flagAt);
+		Stats.maxResponse = (response > Stats.maxResponse) ? response : Stats.maxResponse;
+		Stats.isrCalls++;
+		const uint32_t seen = DMA1->ISR & ((DMA_ISR_HTIF1 | DMA_ISR_TCIF1) << (FLAGS_POS_CH0 + isrCh * FLAGS_POS_STEP));
+		DMA1->IFCR = 0;
+		if (isrCh == 0)
+		{
+			DMA1_Channel2_IRQHandler();
+		}
+#if STRIP_CHANNELS > 1
+		else
+		{
+			DMA1_Channel3_IRQHandler();
+		}
+#endif
+		/* The handler writes IFCR once per flag and the register keeps only the last write, so the flags it was called
+		 * with are taken as cleared if it cleared any */
+		clearFlags((DMA1->IFCR != 0) ? seen : 0);
+		cpuFree = isrEnd;
+		isrCh = -1;
+	}
+}
+
+/**
+ * @brief One timer update: every running dma channel moves the next byte to CCR1
+ * @param t time
+ */
+static void update(const uint64_t t)
+{
+	clearFlags(0); /* The clear of tim2_TransferBits */
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		Channel_t * const c = Channels + ch;
+		DMA_Channel_TypeDef * const dma = hostDmaChannel + ch;
+		TIM_TypeDef * const tim = hostTim + ch;
+		if ((dma->CCR & DMA_CCR_EN) == 0 || (tim->CR1 & TIM_CR1_CEN) == 0 || (tim->DIER & TIM_DIER_UDE) == 0)
+		{
+			c->running = 0;
+			continue;
+		}
+		if (c->running == 0)
+		{
+			c->running = !0;
+			c->reload = dma->CNDTR;
+			c->pos = 0;
+			Stats.halfCycles = (tim->ARR + 1u) * (tim->PSC + 1u) * (c->reload / 2u);
+		}
+		tim->CCR1 = ((const uint8_t *)(uintptr_t)dma->CMAR)[c->pos];
+		if (Stats.sent[ch] < STREAM_MAX)
+		{
+			Stream[ch][Stats.sent[ch]] = (uint8_t)tim->CCR1;
+		}
+		Stats.sent[ch]++;
+		c->pos++;
+		dma->CNDTR--;
+		if (dma->CNDTR == c->reload / 2 && (dma->CCR & DMA_CCR_HTIE) != 0)
+		{
+			setFlags(ch, DMA_ISR_HTIF1, t);
+		}
+		if (dma->CNDTR == 0)
+		{
+			if ((dma->CCR & DMA_CCR_TCIE) != 0)
+			{
+				setFlags(ch, DMA_ISR_TCIF1, t);
+			}
+			dma->CNDTR = c->reload; /* Circular */
+			c->pos = 0;
+		}
+	}
+}
+
+void Model_Init(const Model_IsrCost_t * const cost)
+{
+	Cost = *cost;
+	memset(&Stats, 0, sizeof(Stats));
+	memset(Channels, 0, sizeof(Channels));
+	memset(hostTim, 0, sizeof(hostTim));
+	memset(hostDmaChannel, 0, sizeof(hostDmaChannel));
+	memset(&hostDma, 0, sizeof(hostDma));
+	now = 0;
+	nextUpdate = 0;
+	cpuFree = 0;
+	isrCh = -1;
+}
+
+void Model_Run(const uint32_t cycles)
+{
+	const uint64_t end = now + cycles;
+	const uint32_t period = (TIM2->ARR + 1u) * (TIM2->PSC + 1u);
+	if (nextUpdate == 0 && (TIM2->CR1 & TIM_CR1_CEN) != 0)
+	{
+		nextUpdate = now + period;
+	}
+	while (nextUpdate != 0 && nextUpdate <= end)
+	{
+		serviceIrqs(nextUpdate);
+		update(nextUpdate);
+		nextUpdate += period;
+	}
+	serviceIrqs(end);
+	now = end;
+}
+
+uint8_t Model_RunIdle(const uint32_t maxCycles)
+{
+	const uint32_t step = STRIP_BIT_TICKS;
+	uint8_t idle = 0;
+	for (uint32_t t = 0; t < maxCycles && idle == 0; t += step)
+	{
+		Model_Run(step);
+		idle = (isrCh < 0);
+		for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+		{
+			idle = idle && (hostDmaChannel[ch].CCR & DMA_CCR_EN) == 0 && flags(ch) == 0;
+		}
+	}
+	return idle;
+}
+
+void Model_Block(const uint32_t cycles)
+{
+	cpuFree = ((cpuFree > now) ? cpuFree : now) + cycles;
+	if (isrCh >= 0)
+	{
+		isrEnd += cycles; /* Preempted */
+	}
+}
+
+const uint8_t * Model_GetStream(const uint8_t ch, uint32_t * const n)
+{
+	*n = (Stats.sent[ch] < STREAM_MAX) ? Stats.sent[ch] : STREAM_MAX;
+	return Stream[ch];
+}
+
+const Model_Stats_t * Model_GetStats(void)
+{
+	return &Stats;
+}
+
+void NVIC_EnableIRQ(const IRQn_Type irq)
+{
+	const uint8_t ch = (irq == DMA1_Channel3_IRQn) ? 1u : 0u;
+	if (ch < STRIP_CHANNELS)
+	{
+		Channels[ch].irqOn = !0;
+	}
+}
+
+void NVIC_DisableIRQ(const IRQn_Type irq)
+{
+	const uint8_t ch = (irq == DMA1_Channel3_IRQn) ? 1u : 0u;
+	if (ch < STRIP_CHANNELS)
+	{
+		Channels[ch].irqOn = 0;
+	}
+}
+
+void __DSB(void)
+{
+}
+
+void __ISB(void)
+{
+}
+
+void Gpio_Get_Alt_PortPin(const Gpio_Desc_t Gpio,GPIO_TypeDef ** const Port,uint8_t * const Pin)
+{
+	*Port = &gpio;
+	*Pin = (uint8_t)Gpio;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file fake_adc.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host fake of the adc. Battery voltage and entropy are set by the host
+ */
+#include "adc.h"
+#include "host.h"
+
+static uint16_t voltage = 8000;
+static uint32_t entropy = 0;
+
+void Host_SetVoltage(const uint16_t mv)
+{
+	voltage = mv;
+}
+
+void Host_SetEntropy(const uint32_t value)
+{
+	entropy = value;
+}
+
+void Adc_Init(void)
+{
+}
+
+uint16_t GetAdc_Voltage(void)
+{
+	return voltage;
+}
+
+uint32_t getEntropy(void)
+{
+	return entropy;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file fake_core.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.10
+ * @brief Host fake of the core peripherals under clock.c. The time is virtual cpu cycles: it moves only by
+ * @ref Host_AdvanceCycles and the functions built on it, and by __WFI that jumps to the next systick reload.
+ * The systick counts down the cycles and reloads from LOAD as the real one does, the reload sets PENDSTSET and
+ * the interrupt handler of clock.c is called unless interrupts are masked. The timer runs from power on with the
+ * 1ms period that @ref Systick_Init sets, so tests of single modules need no init. The cycle counter is the only
+ * part that does not run by the virtual time: code takes no virtual time, so it counts the host time in cpu cycles
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "stm32f1xx.h"
+#include "clock.h"
+#include "host.h"
+
+enum
+{
+	TICK_CYCLES = CPU_FREQ / SYSTICK_FREQ, /**< Cpu cycles per tick */
+	SYSTICK_ON = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_CLKSOURCE_Msk /**< CTRL of a running timer */
+};
+
+RCC_TypeDef hostRcc = {.CR = RCC_CR_HSIRDY | RCC_CR_HSERDY | RCC_CR_PLLRDY}; /* Clocks are ready at once */
+FLASH_TypeDef hostFlash;
+SysTick_Type hostSysTick = {.CTRL = SYSTICK_ON, .LOAD = TICK_CYCLES - 1, .VAL = TICK_CYCLES - 1};
+SCB_Type hostScb;
+DBGMCU_TypeDef hostDbgmcu;
+CoreDebug_Type hostCoreDebug;
+static DWT_Type hostDwt;
+
+/**
+ * @brief Virtual cycles from power on
+ */
+static uint64_t cycles = 0;
+static uint8_t irqMasked = 0;            /**< Nonzero between __disable_irq and __enable_irq */
+static pHostHook_t irqOffHook = NULL;    /**< Called by __disable_irq */
+static uint64_t dwtStamp = 0;            /**< Host time of the last update of the cycle counter in cpu cycles */
+
+void SysTick_Handler(void);
+
+/**
+ * @brief Takes the systick interrupt if it's pending and not masked
+ */
+static void takeIrq(void)
+{
+	if (irqMasked == 0 && (hostScb.ICSR & SCB_ICSR_PENDSTSET_Msk) != 0)
+	{
+		hostScb.ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+		SysTick_Handler();
+	}
+}
+
+void Host_AdvanceCycles(uint32_t n)
+{
+	while (n != 0)
+	{
+		uint32_t step = n;
+		if ((hostSysTick.CTRL & SysTick_CTRL_ENABLE_Msk) != 0)
+		{
+			if (n <= hostSysTick.VAL)
+			{
+				hostSysTick.VAL -= n;
+			}
+			else
+			{
+				/* Counts down to zero and reloads at the next cycle */
+				step = hostSysTick.VAL + 1;
+				hostSysTick.VAL = hostSysTick.LOAD;
+				hostScb.ICSR |= SCB_ICSR_PENDSTSET_Msk;
+			}
+		}
+		cycles += step;
+		n -= step;
+		takeIrq();
+	}
+}
+
+void Host_Advance(const uint32_t ms)
+{
+	for (uint32_t i = 0; i < ms; i++)
+	{
+		Host_AdvanceCycles(TICK_CYCLES);
+	}
+}
+
+void Host_SetTicks(const uint32_t ticks)
+{
+	const uint64_t target = (uint64_t)ticks * TICK_CYCLES;
+	if (target < cycles)
+	{
+		fprintf(stderr, "Host_SetTicks: tick %u is in the past\n", (unsigned)ticks);
+		abort();
+	}
+	while (cycles < target)
+	{
+		Host_AdvanceCycles((target - cycles > TICK_CYCLES) ? TICK_CYCLES : (uint32_t)(target - cycles));
+	}
+}
+
+void Host_SetIrqOffHook(const pHostHook_t hook)
+{
+	irqOffHook = hook;
+}
+
+uint32_t SysTick_Config(const uint32_t ticks)
+{
+	hostSysTick.LOAD = ticks - 1;
+	hostSysTick.VAL = 0;
+	hostSysTick.CTRL = SYSTICK_ON;
+	return 0;
+}
+
+void __disable_irq(void)
+{
+	irqMasked = !0;
+	if (irqOffHook != NULL)
+	{
+		irqOffHook();
+	}
+}
+
+void __enable_irq(void)
+{
+	irqMasked = 0;
+	takeIrq();
+}
+
+void __WFI(void)
+{
+	if ((hostScb.ICSR & SCB_ICSR_PENDSTSET_Msk) == 0 && (hostSysTick.CTRL & SysTick_CTRL_ENABLE_Msk) != 0)
+	{
+		Host_AdvanceCycles(hostSysTick.VAL + 1);
+	}
+}
+
+DWT_Type * Host_Dwt(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	const uint64_t now = ((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec) * (CPU_FREQ / 1000000u) / 1000u;
+	if (dwtStamp != 0)
+	{
+		hostDwt.CYCCNT += (uint32_t)(now - dwtStamp);
+	}
+	dwtStamp = now;
+	return &hostDwt;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file fake_flash.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host fake of the flash driver. Jobs are queued as by flash.c and are done in order by @ref Flash_Process,
+ * "flash" is the ram the pointers point to. NOR rules of the F103 are kept: a halfword can be programmed only if
+ * it's erased or to zero, otherwise it's left as it is and the job fails as on PGERR. Erases are counted per page.
+ * Jobs take no time by default. With @ref Host_SetFlashLatency a job takes virtual time, the next one starts when
+ * it ends as from the flash interrupt, and waits of the driver move the virtual time
+ */
+#include <stddef.h>
+#include "flash.h"
+#include "host.h"
+#include "clock.h"
+
+/**
+ * @brief Job types
+ */
+typedef enum
+{
+	FLASH_JOB_ERASE = 0, /**< Page erase */
+	FLASH_JOB_PROGRAM    /**< Halfwords programming */
+}Flash_Job_Type_t;
+
+/**
+ * @brief Queued job
+ */
+typedef struct
+{
+	Flash_Job_Type_t type; /**< Job type */
+	volatile uint16_t * addr; /**< Page or the first halfword address */
+	uint16_t data[FLASH_JOB_HALFWORDS]; /**< Data to program */
+	uint8_t n; /**< Number of halfwords to program */
+	pFlashDone_t done; /**< Completion callback */
+} Flash_Job_t;
+
+enum
+{
+	MAX_PAGES = 8 /**< Maximal number of pages whose erases are counted */
+};
+
+static Flash_Job_t queue[FLASH_QUEUE_LEN];
+static uint8_t head = 0; /**< Next job to run */
+static uint8_t count = 0; /**< Number of queued jobs */
+static Host_Flash_Page_t erasedPages[MAX_PAGES]; /**< Erased pages in the order of the first erase */
+static uint8_t nPages = 0; /**< Number of erased pages */
+static uint32_t programErrors = 0; /**< Halfwords that were not programmed */
+static uint16_t eraseMs = 0; /**< Page erase time */
+static uint16_t programMs = 0; /**< Program job time */
+static uint8_t running = 0; /**< Nonzero if the first queued job is started */
+static uint32_t started = 0; /**< Tick when the first queued job was started */
+
+/**
+ * @brief Counts the page erase
+ * @param page page
+ */
+static void countErase(const volatile uint16_t * const page)
+{
+	uint8_t i = 0;
+	while (i < nPages && erasedPages[i].page != page)
+	{
+		i++;
+	}
+	if (i == nPages && nPages < MAX_PAGES)
+	{
+		erasedPages[nPages].page = page;
+		erasedPages[nPages].erases = 0;
+		nPages++;
+	}
+	if (i < nPages)
+	{
+		erasedPages[i].erases++;
+	}
+}
+
+/**
+ * @brief Returns the time the job takes
+ * @param job job
+ * @return ms
+ */
+static uint16_t latencyOf(const Flash_Job_t * const job)
+{
+	return (job->type == FLASH_JOB_ERASE) ? eraseMs : programMs;
+}
+
+/**
+ * @brief Does the job or its first part
+ * @param job job
+ * @param done part done: 0..256, 256 for the whole job. A cut program leaves the next halfword half programmed
+ * @return nonzero if all the halfwords could be programmed
+ */
+static uint8_t applyJob(const Flash_Job_t * const job, const uint16_t done)
+{
+	uint8_t ok = !0;
+	if (job->type == FLASH_JOB_ERASE)
+	{
+		const uint16_t n = (uint16_t)(FLASH_PAGE_SIZE / sizeof(uint16_t) * done / 256u);
+		for (uint16_t i = 0; i < n; i++)
+		{
+			job->addr[i] = 0xFFFF;
+		}
+	}
+	else
+	{
+		const uint8_t n = (uint8_t)(job->n * done / 256u);
+		for (uint8_t i = 0; i < job->n && i <= n; i++)
+		{
+			const uint16_t data = (i < n) ? job->data[i] : (uint16_t)(job->data[i] | 0xF0F0);
+			if (job->addr[i] == 0xFFFF || data == 0)
+			{
+				job->addr[i] = data;
+			}
+			else
+			{
+				programErrors++;
+				ok = 0;
+			}
+		}
+	}
+	return ok;
+}
+
+/**
+ * @brief Does the first queued job and removes it from the queue. The next job starts when this one ends
+ */
+static void runJob(void)
+{
+	const Flash_Job_t * const job = queue + head;
+	const uint8_t ok = applyJob(job, 256);
+	if (job->type == FLASH_JOB_ERASE)
+	{
+		countErase(job->addr);
+	}
+	const pFlashDone_t done = job->done;
+	started += latencyOf(job);
+	head = (uint8_t)((head + 1u) % FLASH_QUEUE_LEN);
+	count--;
+	running = (count != 0) ? !0 : 0;
+	if (done != NULL)
+	{
+		done(ok);
+	}
+}
+
+/**
+ * @brief Waits while the queue is longer than the length, the time goes on as the driver spins
+ * @param len queue length
+ */
+static void waitQueue(const uint8_t len)
+{
+	Flash_Process();
+	while (count > len)
+	{
+		Host_Advance(1);
+		Flash_Process();
+	}
+}
+
+/**
+ * @brief Adds a job and starts it if the flash is idle. Waits while the queue is full
+ * @param job job
+ */
+static void addJob(const Flash_Job_t * const job)
+{
+	waitQueue(FLASH_QUEUE_LEN - 1);
+	queue[(head + count) % FLASH_QUEUE_LEN] = *job;
+	count++;
+	Flash_Process();
+}
+
+void Flash_Init(void)
+{
+}
+
+void Flash_Erase(volatile uint16_t * const page, const pFlashDone_t done)
+{
+	const Flash_Job_t job = {.type = FLASH_JOB_ERASE, .addr = page, .done = done};
+	addJob(&job);
+}
+
+void Flash_Program(volatile uint16_t * const dst, const uint16_t * const src, const uint8_t n, const pFlashDone_t done)
+{
+	Flash_Job_t job = {.type = FLASH_JOB_PROGRAM, .addr = dst, .n = (n > FLASH_JOB_HALFWORDS) ? FLASH_JOB_HALFWORDS : n, .done = done};
+	for (uint8_t i = 0; i < job.n; i++)
+	{
+		job.data[i] = src[i];
+	}
+	addJob(&job);
+}
+
+void Flash_Process(void)
+{
+	const uint32_t now = GetTicksCounter();
+	if (running == 0 && count != 0)
+	{
+		running = !0;
+		started = now;
+	}
+	while (count != 0 && now - started >= latencyOf(queue + head))
+	{
+		runJob();
+	}
+}
+
+uint8_t Flash_IsBusy(void)
+{
+	return count != 0;
+}
+
+void Flash_Flush(void)
+{
+	waitQueue(0);
+}
+
+const Host_Flash_Page_t * Host_GetFlashPage(const uint8_t i)
+{
+	return (i < nPages) ? erasedPages + i : NULL;
+}
+
+uint32_t Host_GetFlashErrors(void)
+{
+	return programErrors;
+}
+
+void Host_SetFlashLatency(const uint16_t erase, const uint16_t program)
+{
+	eraseMs = erase;
+	programMs = program;
+}
+
+void Host_FlashPowerCut(void)
+{
+	if (running != 0 && count != 0)
+	{
+		const Flash_Job_t * const job = queue + head;
+		const uint32_t latency = latencyOf(job);
+		const uint32_t elapsed = GetTicksCounter() - started;
+		if (latency != 0 && elapsed < latency)
+		{
+			(void)applyJob(job, (uint16_t)(elapsed * 256u / latency));
+		}
+	}
+	head = 0;
+	count = 0;
+	running = 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file fake_gpio.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host fake of gpio and of the interrupt controller. The button pin is set by @ref Host_SetButton that
+ * calls the EXTI interrupt handler of buttons.c on every change of the level once the interrupt is enabled
+ */
+#include <stddef.h>
+#include "gpio.h"
+#include "host.h"
+
+EXTI_TypeDef hostExti;
+
+/**
+ * @brief Pin levels
+ */
+static uint8_t Levels[GPIO_TOTAL];
+static uint8_t extiEnabled = 0; /**< Nonzero if the button interrupt is enabled */
+
+void EXTI2_IRQHandler(void);
+
+void NVIC_EnableIRQ(const IRQn_Type irq)
+{
+	if (irq == EXTI2_IRQn)
+	{
+		extiEnabled = !0;
+	}
+}
+
+void NVIC_DisableIRQ(const IRQn_Type irq)
+{
+	if (irq == EXTI2_IRQn)
+	{
+		extiEnabled = 0;
+	}
+}
+
+void Gpio_Init(void)
+{
+}
+
+void Gpio_Set_Bit(Gpio_Desc_t Gpio)
+{
+	Levels[Gpio] = 1;
+}
+
+void Gpio_Clear_Bit(Gpio_Desc_t Gpio)
+{
+	Levels[Gpio] = 0;
+}
+
+uint8_t Gpio_Read_Bit(Gpio_Desc_t Gpio)
+{
+	return Levels[Gpio];
+}
+
+void Gpio_Get_Alt_PortPin(const Gpio_Desc_t Gpio,GPIO_TypeDef ** const Port,uint8_t * const Pin)
+{
+	*Port = NULL;
+	*Pin = (uint8_t)Gpio;
+}
+
+void Gpio_Exti_Init(const Gpio_Desc_t Gpio)
+{
+	(void)Gpio;
+}
+
+void Host_SetButton(const uint8_t pressed)
+{
+	const uint8_t level = (pressed != 0) ? 1u : 0u; /* Button is NC, if pressed, high level is on the pin */
+	if (level != Levels[GPIO_BUTTON])
+	{
+		Levels[GPIO_BUTTON] = level;
+		if (extiEnabled != 0)
+		{
+			EXTI->PR |= EXTI_PR_PR2;
+			EXTI2_IRQHandler();
+		}
+	}
+}
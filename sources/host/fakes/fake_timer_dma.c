@@ -0,0 +1,183 @@
+/**
+ * @file fake_timer_dma.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host fake of the strip timer+dma driver. A transfer is done synchronously: halves are "sent" and refilled
+ * in the order the dma interrupts would do it until the refill callback stops the stream.
+ * Sent CCR values are decoded back to bits the way the strip does it: a long high pulse is one, a zero CCR (low out)
+ * is the reset that latches the frame. There is no timing here, so there are no underruns: test_dma runs timer_dma.c
+ * over the dma timing model for them
+ */
+#include <stddef.h>
+#include "timer_dma.h"
+#include "host.h"
+
+/**
+ * @brief Output channel state
+ */
+typedef struct
+{
+	uint8_t *baddr; /**< Circular buffer */
+	uint16_t bsize; /**< Circular buffer size */
+	pFillHalf_t pFill; /**< Refill callback */
+	uint16_t pos; /**< Decoded bytes of the current frame */
+	uint8_t bits; /**< Decoded bits of the current byte */
+	uint8_t byte; /**< Current byte */
+} Out_State_t;
+
+static Out_State_t Out_State[STRIP_CHANNELS];
+
+/**
+ * @brief Leds as they are shown by the strip
+ */
+static Led_t Strip[NLEDS];
+static uint8_t capture = !0;
+static pHostFrame_t frameHook = NULL;
+static pHostWave_t waveHook = NULL;
+static uint32_t frames = 0;
+
+/**
+ * @brief Decodes one sent half
+ * @param ch channel
+ * @param half the half
+ * @param size size in bytes
+ */
+static void decode(const uint8_t ch, const uint8_t * const half, const uint16_t size)
+{
+	Out_State_t * const state = Out_State + ch;
+	uint8_t * const leds = (uint8_t *)(Strip + ch * CHANNEL_LEDS);
+	for (uint16_t i = 0; i < size; i++)
+	{
+		if (half[i] != 0)
+		{
+			state->byte = (uint8_t)((state->byte << 1) | ((half[i] > STRIP_BIT_TICKS / 3u) ? 1u : 0u));
+			state->bits++;
+			if (state->bits == 8)
+			{
+				if (state->pos < CHANNEL_LEDS * sizeof(Led_t))
+				{
+					leds[state->pos] = state->byte;
+				}
+				state->pos++;
+				state->bits = 0;
+			}
+		}
+		else if (state->pos != 0 || state->bits != 0)
+		{
+			state->pos = 0;
+			state->bits = 0;
+			if (ch == 0)
+			{
+				frames++;
+			}
+			if (frameHook != NULL)
+			{
+				frameHook(ch);
+			}
+		}
+	}
+}
+
+/**
+ * @brief "Sends" one half
+ * @param ch channel
+ * @param half the half
+ * @param size size in bytes
+ */
+static void send(const uint8_t ch, const uint8_t * const half, const uint16_t size)
+{
+	if (waveHook != NULL)
+	{
+		waveHook(ch, half, size);
+	}
+	if (capture != 0)
+	{
+		decode(ch, half, size);
+	}
+}
+
+void tim2_Init(void)
+{
+}
+
+void tim2_set_data(const uint8_t ch, uint8_t * const addr, const uint16_t size, pFillHalf_t const fill)
+{
+	if (ch < STRIP_CHANNELS && addr != NULL && size != 0 && fill != NULL)
+	{
+		Out_State[ch].baddr = addr;
+		Out_State[ch].bsize = size;
+		Out_State[ch].pFill = fill;
+	}
+}
+
+void tim2_TransferBits(const uint8_t ch)
+{
+	if (ch < STRIP_CHANNELS && Out_State[ch].baddr != NULL && Out_State[ch].bsize != 0)
+	{
+		Out_State_t * const state = Out_State + ch;
+		const uint16_t half = state->bsize / 2;
+		if (state->pFill(ch, state->baddr, half) != 0)
+		{
+			state->pFill(ch, state->baddr + half, half);
+			for (;;)
+			{
+				send(ch, state->baddr, half);
+				if (state->pFill(ch, state->baddr, half) == 0)
+				{
+					break;
+				}
+				send(ch, state->baddr + half, half);
+				if (state->pFill(ch, state->baddr + half, half) == 0)
+				{
+					break;
+				}
+			}
+		}
+	}
+}
+
+uint8_t tim2_IsBusy(const uint8_t ch)
+{
+	(void)ch;
+	return 0;
+}
+
+void tim2_DisableIrq(void)
+{
+}
+
+void tim2_EnableIrq(void)
+{
+}
+
+uint32_t tim2_GetUnderruns(void)
+{
+	return 0;
+}
+
+void Host_StripCapture(const uint8_t on)
+{
+	capture = on;
+}
+
+void Host_SetFrameHook(const pHostFrame_t hook)
+{
+	frameHook = hook;
+}
+
+void Host_SetWaveHook(const pHostWave_t hook)
+{
+	waveHook = hook;
+}
+
+const Led_t * Host_GetStrip(void)
+{
+	return Strip;
+}
+
+uint32_t Host_GetStripFrames(void)
+{
+	return frames;
+}
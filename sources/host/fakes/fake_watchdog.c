@@ -0,0 +1,17 @@
+/**
+ * @file fake_watchdog.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host fake of the watchdog. Does nothing
+ */
+#include "watchdog.h"
+
+void watchdog_Init(void)
+{
+}
+
+void Reset_Watchdog(void)
+{
+}
@@ -0,0 +1,73 @@
+#ifndef SOURCES_HOST_INCLUDE_DMA_MODEL_H_
+#define SOURCES_HOST_INCLUDE_DMA_MODEL_H_
+/**
+ * @file dma_model.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Timing model of the strip timers, their dma channels and the dma interrupts. It runs timer_dma.c as it is
+ * instead of fake_timer_dma.c: on every timer update the dma channel moves the next byte of the circular buffer to
+ * CCR1 and sets the half and full transfer flags, the interrupt handler of timer_dma.c runs after its cost in cycles.
+ * The refill is taken as done at the end of the handler, so a half that is sent before that is sent with the old
+ * data and timer_dma.c counts the underrun when it sees both flags
+ */
+#include <stdint.h>
+#include "project_conf.h"
+
+/**
+ * @brief Cpu cost of the strip dma interrupt
+ */
+typedef struct
+{
+	uint32_t entry;  /**< Cycles from the flag to the first instruction of the handler */
+	uint32_t fixed;  /**< Cycles of the handler without the leds */
+	uint32_t perLed; /**< Cycles of one converted led */
+} Model_IsrCost_t;
+
+/**
+ * @brief Counters of the model
+ */
+typedef struct
+{
+	uint32_t isrCalls;     /**< Strip dma interrupts run */
+	uint32_t maxResponse;  /**< Worst cycles from the flag to the end of the handler */
+	uint32_t halfCycles;   /**< Cycles to send one half of the buffer, the deadline of the refill */
+	uint32_t sent[STRIP_CHANNELS]; /**< Bytes moved to CCR1 */
+} Model_Stats_t;
+
+/**
+ * @brief Resets the time, the registers and the captured streams
+ * @param cost cost of the interrupt handler
+ */
+void Model_Init(const Model_IsrCost_t * const cost);
+/**
+ * @brief Runs the timers, the dma and the interrupts
+ * @param cycles cpu cycles to run
+ */
+void Model_Run(const uint32_t cycles);
+/**
+ * @brief Runs until the stream of every channel is stopped
+ * @param maxCycles limit
+ * @return nonzero if every channel has stopped
+ */
+uint8_t Model_RunIdle(const uint32_t maxCycles);
+/**
+ * @brief Keeps the cpu from the strip interrupt for a while, as a higher priority interrupt or a critical section does
+ * @param cycles cycles
+ */
+void Model_Block(const uint32_t cycles);
+/**
+ * @brief Returns the CCR1 values sent on the channel since @ref Model_Init
+ * @param ch channel
+ * @param n set to the number of values
+ * @return the values
+ */
+const uint8_t * Model_GetStream(const uint8_t ch, uint32_t * const n);
+/**
+ * @brief Returns the counters
+ * @return counters
+ */
+const Model_Stats_t * Model_GetStats(void);
+
+#endif /* SOURCES_HOST_INCLUDE_DMA_MODEL_H_ */
@@ -0,0 +1,29 @@
+#ifndef SOURCES_HOST_INCLUDE_FRAME_DIFF_H_
+#define SOURCES_HOST_INCLUDE_FRAME_DIFF_H_
+/**
+ * @file frame_diff.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the comparison of two frame logs written by @ref Sim_LogFrames. Lines starting with '#' are
+ * comments, every other line is "<tick> <hash>"
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+enum
+{
+	FDIFF_REPORT_LEN = 256 /**< Maximal report length */
+};
+
+/**
+ * @brief Finds the first frame that differs in the tick or in the hash, or that is in one log only
+ * @param expected expected log
+ * @param actual actual log
+ * @param report the first divergence and the last common frame, empty if the logs are the same. @ref FDIFF_REPORT_LEN bytes
+ * @return nonzero if the logs differ
+ */
+uint8_t Fdiff_First(FILE * const expected, FILE * const actual, char * const report);
+
+#endif /* SOURCES_HOST_INCLUDE_FRAME_DIFF_H_ */
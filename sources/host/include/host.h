@@ -0,0 +1,145 @@
+#ifndef SOURCES_HOST_INCLUDE_HOST_H_
+#define SOURCES_HOST_INCLUDE_HOST_H_
+/**
+ * @file host.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains control functions of the hal fakes used by the host build. The fakes implement hal/include
+ * headers: time is virtual cpu cycles of the systick fake under clock.c and moves only when it's told to, the strip transfer is done synchronously and
+ * the sent bits are decoded back to leds, flash jobs are done in order on @ref Flash_Process with the NOR rules of the F103
+ */
+#include <stdint.h>
+#include "rgbw.h"
+
+/**
+ * @brief Called after a frame was decoded from the strip output
+ * @param ch channel
+ */
+typedef void (*pHostFrame_t)(const uint8_t ch);
+
+/**
+ * @brief Called with every half of the circular buffer when it's sent, before it's decoded
+ * @param ch channel
+ * @param ccr CCR values of the half, one per bit period
+ * @param n number of values
+ */
+typedef void (*pHostWave_t)(const uint8_t ch, const uint8_t * const ccr, const uint16_t n);
+
+/**
+ * @brief Hook called by the fakes
+ */
+typedef void (*pHostHook_t)(void);
+
+/**
+ * @brief Erase counter of a flash page
+ */
+typedef struct
+{
+	const volatile uint16_t * page; /**< Page address */
+	uint32_t erases;                /**< Number of erases */
+} Host_Flash_Page_t;
+
+/**
+ * @brief Moves the virtual time forward to the start of the tick. The ticks are counted by clock.c from the systick
+ * interrupts, so the time can't go back: the process is aborted then
+ * @param ticks ms
+ */
+void Host_SetTicks(const uint32_t ticks);
+
+/**
+ * @brief Moves the virtual time forward. Systick interrupts are taken on the way unless they are masked
+ * @param ms ms
+ */
+void Host_Advance(const uint32_t ms);
+
+/**
+ * @brief Moves the virtual time forward by cpu cycles
+ * @param cycles cycles
+ */
+void Host_AdvanceCycles(const uint32_t cycles);
+
+/**
+ * @brief Sets the hook called by __disable_irq, a test moves the time there to hit a race of the masked code
+ * @param hook hook or NULL
+ */
+void Host_SetIrqOffHook(const pHostHook_t hook);
+
+/**
+ * @brief Sets the button pin. A change raises the EXTI interrupt at the current virtual time
+ * @param pressed nonzero if pressed
+ */
+void Host_SetButton(const uint8_t pressed);
+
+/**
+ * @brief Sets the battery voltage returned by @ref GetAdc_Voltage
+ * @param mv mV
+ */
+void Host_SetVoltage(const uint16_t mv);
+
+/**
+ * @brief Sets the value returned by @ref getEntropy
+ * @param entropy value
+ */
+void Host_SetEntropy(const uint32_t entropy);
+
+/**
+ * @brief Turns decoding of the strip output on or off. It's on by default. When off the refill callback is still
+ * called until the end of the stream but nothing is decoded
+ * @param on nonzero to decode
+ */
+void Host_StripCapture(const uint8_t on);
+
+/**
+ * @brief Sets the frame callback
+ * @param hook callback or NULL
+ */
+void Host_SetFrameHook(const pHostFrame_t hook);
+
+/**
+ * @brief Sets the callback that gets the raw CCR stream of the strip output
+ * @param hook callback or NULL
+ */
+void Host_SetWaveHook(const pHostWave_t hook);
+
+/**
+ * @brief Returns leds as they are shown by the strip: every decoded frame overwrites as many leds as it has
+ * @return @ref NLEDS leds in the order of @ref displayStrip input
+ */
+const Led_t * Host_GetStrip(void);
+
+/**
+ * @brief Returns the number of frames decoded from channel 0
+ * @return frames
+ */
+uint32_t Host_GetStripFrames(void);
+
+/**
+ * @brief Returns the erase counter of a page. Pages are numbered in the order of their first erase
+ * @param i page number
+ * @return counter, NULL if fewer pages were erased
+ */
+const Host_Flash_Page_t * Host_GetFlashPage(const uint8_t i);
+
+/**
+ * @brief Returns the number of halfwords that were not programmed because they were not erased
+ * @return halfwords
+ */
+uint32_t Host_GetFlashErrors(void);
+
+/**
+ * @brief Sets the time flash jobs take. Zero makes a job done at once
+ * @param erase page erase ms
+ * @param program ms of a program job
+ */
+void Host_SetFlashLatency(const uint16_t erase, const uint16_t program);
+
+/**
+ * @brief Cuts the power of the flash at the current tick: the running job is left half done, an erase leaves the
+ * part of the page that is not erased yet as it was, a program leaves the current halfword half programmed.
+ * Queued jobs are dropped without callbacks
+ */
+void Host_FlashPowerCut(void);
+
+#endif /* SOURCES_HOST_INCLUDE_HOST_H_ */
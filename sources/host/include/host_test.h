@@ -0,0 +1,39 @@
+#ifndef SOURCES_HOST_INCLUDE_HOST_TEST_H_
+#define SOURCES_HOST_INCLUDE_HOST_TEST_H_
+/**
+ * @file host_test.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains check macros of the host tests. A failed check is printed and the test goes on,
+ * the exit code of the test is @ref TEST_RESULT
+ */
+#include <stdio.h>
+#include <string.h>
+
+static unsigned testFailures = 0; /**< Number of failed checks */
+
+/**
+ * @brief Checks the condition
+ */
+#define CHECK(cond) do { if (!(cond)) { testFailures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while (0)
+
+/**
+ * @brief Checks that two integers are equal
+ */
+#define CHECK_EQ(a, b) do { const long long a_ = (long long)(a); const long long b_ = (long long)(b); \
+	if (a_ != b_) { testFailures++; printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, a_, b_); } } while (0)
+
+/**
+ * @brief Checks that two strings are equal
+ */
+#define CHECK_STR(a, b) do { const char * const a_ = (a); const char * const b_ = (b); \
+	if (strcmp(a_, b_) != 0) { testFailures++; printf("%s:%d: CHECK_STR(%s, %s) failed: \"%s\" != \"%s\"\n", __FILE__, __LINE__, #a, #b, a_, b_); } } while (0)
+
+/**
+ * @brief Exit code of the test
+ */
+#define TEST_RESULT ((testFailures == 0) ? 0 : 1)
+
+#endif /* SOURCES_HOST_INCLUDE_HOST_TEST_H_ */
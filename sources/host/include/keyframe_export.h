@@ -0,0 +1,75 @@
+#ifndef SOURCES_HOST_INCLUDE_KEYFRAME_EXPORT_H_
+#define SOURCES_HOST_INCLUDE_KEYFRAME_EXPORT_H_
+/**
+ * @file keyframe_export.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the keyframe exporter: frames that the firmware sends to the strip are captured on the host,
+ * their leds are mapped back to @ref Colors_t and every frame is stored as runs of changed pixels in the format of keyframe.h.
+ * Spans are put on both rows, so a mode that shows different rows can't be exported
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include "led_strip.h"
+#include "project_conf.h"
+
+enum
+{
+	KFX_ROW = NLEDS / 2,    /**< Pixels in a row */
+	KFX_MAX_FRAMES = 20000, /**< Maximal number of captured frames */
+	KFX_ERROR_LEN = 128     /**< Maximal error message length */
+};
+
+/**
+ * @brief Captured frame
+ */
+typedef struct
+{
+	uint32_t time;          /**< Tick when the frame was sent */
+	uint8_t colors[KFX_ROW]; /**< @ref Colors_t of the row pixels */
+} Kfx_Frame_t;
+
+/**
+ * @brief Capture of one run
+ */
+typedef struct
+{
+	Kfx_Frame_t frames[KFX_MAX_FRAMES]; /**< Frames in time order. Frames equal to the previous one are dropped */
+	uint32_t n;                 /**< Number of frames */
+	char error[KFX_ERROR_LEN];  /**< Why the run can't be exported, empty if it can */
+} Kfx_Capture_t;
+
+/**
+ * @brief Starts capturing. The palette of the brightness level is found by showing every color once,
+ * after that the strip is black as at power on. Must be called before the firmware runs
+ * @param capture capture
+ * @param brightness brightness level of the run
+ */
+void Kfx_Start(Kfx_Capture_t * const capture, const uint8_t brightness);
+
+/**
+ * @brief Stops capturing
+ */
+void Kfx_Stop(void);
+
+/**
+ * @brief Encodes the capture to a keyframe stream. The first frame waits from time 0, the last one is followed by @ref KF_END
+ * @param capture capture
+ * @param out stream
+ * @param size stream buffer size
+ * @return stream size, 0 if it doesn't fit
+ */
+uint32_t Kfx_Encode(const Kfx_Capture_t * const capture, uint8_t * const out, const uint32_t size);
+
+/**
+ * @brief Prints the stream as a C array written with KF_xxx macros
+ * @param out output file
+ * @param name array name
+ * @param stream stream
+ * @param size stream size
+ */
+void Kfx_PrintC(FILE * const out, const char * const name, const uint8_t * const stream, const uint32_t size);
+
+#endif /* SOURCES_HOST_INCLUDE_KEYFRAME_EXPORT_H_ */
@@ -0,0 +1,74 @@
+#ifndef SOURCES_HOST_INCLUDE_PATTERN_COMPILER_H_
+#define SOURCES_HOST_INCLUDE_PATTERN_COMPILER_H_
+/**
+ * @file pattern_compiler.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the compiler of the text pattern language to the bytecode of pattern.h. One op per line,
+ * arguments are separated by commas, # starts a comment:
+ * @code
+ * const on = 200        # named constant
+ * loop 0
+ *     fill GREEN
+ *     wait on
+ *     fill BLACK
+ *     dots ROWS|FROM_N, RED, NLEDS/2 - 1, NLEDS/2 - 1, 1
+ *     wait 1000 - on
+ * next
+ * @endcode
+ * Ops are the PAT_xxx macros in lower case: end, fill, strip, strips, strips_rev, dots, power, set, inc, dec, wait, loop, next.
+ * Arguments are integer expressions with + - * / | and parentheses over numbers, constants, color names of
+ * @ref Colors_t, dots flags without the PAT_DOTS_ prefix and NLEDS.
+ * Besides the argument ranges the compiler checks that loops are closed and not nested deeper than
+ * @ref PATTERN_LOOP_DEPTH, that every endless loop waits and that the program can't run past its end
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+enum
+{
+	PATC_MAX_CODE = 1024, /**< Maximal program size in bytes */
+	PATC_ERROR_LEN = 128  /**< Maximal error message length */
+};
+
+/**
+ * @brief Compiler output
+ */
+typedef struct
+{
+	uint8_t code[PATC_MAX_CODE]; /**< Bytecode */
+	uint16_t size;               /**< Bytecode size */
+	uint16_t line;               /**< Line of the error */
+	char error[PATC_ERROR_LEN];  /**< Error message, empty if there is no error */
+} Patc_Result_t;
+
+/**
+ * @brief Compiles the program text
+ * @param text program text
+ * @param res output
+ * @return nonzero if compiled, @ref Patc_Result_t::error has the reason otherwise
+ */
+uint8_t Patc_Compile(const char * const text, Patc_Result_t * const res);
+
+/**
+ * @brief Checks the bytecode of a program that was written with the PAT_xxx macros the way @ref Patc_Compile checks
+ * the text. @ref Patc_Result_t::line is the number of the op with the error, the code is copied to the result
+ * @param code bytecode
+ * @param size bytecode size
+ * @param res output
+ * @return nonzero if the program is right, @ref Patc_Result_t::error has the reason otherwise
+ */
+uint8_t Patc_Check(const uint8_t * const code, const uint16_t size, Patc_Result_t * const res);
+
+/**
+ * @brief Prints the bytecode as a C array written with the PAT_xxx macros
+ * @param out output file
+ * @param name array name
+ * @param code bytecode
+ * @param size bytecode size
+ */
+void Patc_PrintC(FILE * const out, const char * const name, const uint8_t * const code, const uint16_t size);
+
+#endif /* SOURCES_HOST_INCLUDE_PATTERN_COMPILER_H_ */
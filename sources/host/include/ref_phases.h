@@ -0,0 +1,34 @@
+#ifndef SOURCES_HOST_INCLUDE_REF_PHASES_H_
+#define SOURCES_HOST_INCLUDE_REF_PHASES_H_
+/**
+ * @file ref_phases.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the C versions of led_control.c phases as they were before they were written as patterns.
+ * The bench runs them against the pattern programs: the strip must be the same at every step
+ */
+#include <stdint.h>
+#include "led_strip.h"
+
+/**
+ * @brief C version of a pattern phase
+ */
+typedef struct
+{
+	const char * name;        /**< Phase name, the same as in @ref led_control_GetPatterns */
+	pPhase_t phase;           /**< Phase function */
+	uint32_t runMs;           /**< Time to run it to cover its behaviour */
+	const char * codeStart;   /**< Start of the phase code, its functions are in their own section */
+	const char * codeEnd;     /**< End of the phase code */
+} Ref_Phase_t;
+
+/**
+ * @brief Returns the C versions of the phases
+ * @param n set to the number of phases
+ * @return phases
+ */
+const Ref_Phase_t * Ref_GetPhases(uint8_t * const n);
+
+#endif /* SOURCES_HOST_INCLUDE_REF_PHASES_H_ */
@@ -0,0 +1,112 @@
+#ifndef SOURCES_HOST_INCLUDE_SIM_H_
+#define SOURCES_HOST_INCLUDE_SIM_H_
+/**
+ * @file sim.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains the host runner of the firmware: the init and the main loop of main.c over the hal fakes.
+ * The loop sleeps by jumping the virtual time to the next task. Modes keep their state in static variables,
+ * so one process runs one boot
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include "eeemu.h"
+#include "led_control.h"
+
+/**
+ * @brief Button edge of a script
+ */
+typedef struct
+{
+	uint32_t time;   /**< Tick of the edge */
+	uint8_t pressed; /**< Nonzero if the button is pressed after the edge */
+} Sim_Edge_t;
+
+enum
+{
+	SIM_CONFIG_WALK_EDGES = 7 /**< Number of edges of @ref Sim_ConfigWalk */
+};
+
+/**
+ * @brief Config walk that changes values, the button is held at power on: it's released after the diag pages are started,
+ * the first value is tapped twice, the second one is long pressed for 3s, the rest time out. The config is saved once
+ */
+extern const Sim_Edge_t Sim_ConfigWalk[SIM_CONFIG_WALK_EDGES];
+
+/**
+ * @brief Statistics of @ref Sim_Run
+ */
+typedef struct
+{
+	uint32_t iterations; /**< Main loop iterations */
+	uint32_t frames;     /**< Frames sent to the strip */
+	uint64_t wallNs;     /**< Host time */
+} Sim_Stats_t;
+
+/**
+ * @brief Returns a config with usual values for the mode
+ * @param mode mode
+ * @return config
+ */
+Config_t Sim_DefaultConfig(const Working_Mode_t mode);
+
+/**
+ * @brief Returns the mode name as it is in @ref Working_Mode_t
+ * @param mode mode
+ * @return name
+ */
+const char * Sim_ModeName(const Working_Mode_t mode);
+
+/**
+ * @brief Finds the mode by its name (MODE_SC) or number
+ * @param arg name or number
+ * @return mode, @ref MODE_TOTAL if there is no such mode
+ */
+Working_Mode_t Sim_ParseMode(const char * const arg);
+
+/**
+ * @brief Does the firmware init at time 0. The config and the seed are stored as if they were left by the previous run
+ * @param conf config
+ * @param seed prng seed
+ * @param pressed nonzero if the button is pressed at power on, that starts config
+ */
+void Sim_Boot(const Config_t * const conf, const uint16_t seed, const uint8_t pressed);
+
+/**
+ * @brief Does the main loop of main.c up to the sleep. The frames sent by the tasks are logged by @ref Sim_LogFrames
+ */
+void Sim_LoopBody(void);
+
+/**
+ * @brief Does one main loop iteration and sleeps to the next task
+ */
+void Sim_Iteration(void);
+
+/**
+ * @brief Runs the main loop until the tick. Every sleep jumps to the next task or to the next edge of the script,
+ * whichever comes first, so the loop runs as many times as the firmware does and not once per ms
+ * @param until tick to stop at
+ * @param script button edges sorted by time, edges before the current tick are skipped. NULL if none
+ * @param n number of edges
+ * @param stats statistics of the run or NULL
+ */
+void Sim_Run(const uint32_t until, const Sim_Edge_t * const script, const uint16_t n, Sim_Stats_t * const stats);
+
+/**
+ * @brief FNV-1a hash of the strip as it's shown. The leds are taken in the display order (row 0 forward, then row 1
+ * backward), the colors of a led in the GRBW order. So the hash does not depend on @ref STRIP_LAYOUT and is the same for
+ * @ref PIXEL_FORMAT_GRBW and @ref PIXEL_FORMAT_RGBW
+ * @return hash
+ */
+uint32_t Sim_StripHash(void);
+
+/**
+ * @brief Starts or stops the frame log. A line "<tick> <hash>" is written for every frame that differs
+ * from the previous one, after the main loop iteration that sent it. Sets the frame hook of the strip fake
+ * @param out log file, NULL stops the log and clears the hook
+ */
+void Sim_LogFrames(FILE * const out);
+
+#endif /* SOURCES_HOST_INCLUDE_SIM_H_ */
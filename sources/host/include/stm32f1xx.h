@@ -0,0 +1,273 @@
+#ifndef SOURCES_HOST_INCLUDE_STM32F1XX_H_
+#define SOURCES_HOST_INCLUDE_STM32F1XX_H_
+/**
+ * @file stm32f1xx.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Host replacement of the device header. Contains only what is used by the hal files that are built for the host
+ * as they are (buttons.c, clock.c, timer_dma.c in test_dma). Registers are plain variables, the ones that change by themselves (SysTick, DWT)
+ * are updated by the core fake when the virtual time moves (see fake_core.c)
+ */
+#include <stdint.h>
+
+/**
+ * @brief Interrupt numbers
+ */
+typedef enum
+{
+	EXTI2_IRQn = 8,          /**< EXTI line 2 interrupt */
+	DMA1_Channel2_IRQn = 12, /**< DMA1 channel 2 interrupt */
+	DMA1_Channel3_IRQn = 13  /**< DMA1 channel 3 interrupt */
+} IRQn_Type;
+
+/**
+ * @brief General purpose I/O
+ */
+typedef struct
+{
+	volatile uint32_t CRL;
+	volatile uint32_t CRH;
+	volatile uint32_t IDR;
+	volatile uint32_t ODR;
+	volatile uint32_t BSRR;
+	volatile uint32_t BRR;
+	volatile uint32_t LCKR;
+} GPIO_TypeDef;
+
+/**
+ * @brief External interrupt/event controller
+ */
+typedef struct
+{
+	volatile uint32_t IMR;
+	volatile uint32_t EMR;
+	volatile uint32_t RTSR;
+	volatile uint32_t FTSR;
+	volatile uint32_t SWIER;
+	volatile uint32_t PR;
+} EXTI_TypeDef;
+
+/**
+ * @brief Reset and clock control
+ */
+typedef struct
+{
+	volatile uint32_t CR;
+	volatile uint32_t CFGR;
+	volatile uint32_t CIR;
+	volatile uint32_t AHBENR;
+	volatile uint32_t APB1ENR;
+} RCC_TypeDef;
+
+/**
+ * @brief General purpose timer
+ */
+typedef struct
+{
+	volatile uint32_t CR1;
+	volatile uint32_t DIER;
+	volatile uint32_t EGR;
+	volatile uint32_t CCMR1;
+	volatile uint32_t CCER;
+	volatile uint32_t PSC;
+	volatile uint32_t ARR;
+	volatile uint32_t CCR1;
+} TIM_TypeDef;
+
+/**
+ * @brief DMA channel. The address registers are 32 bit as on the device: the host build that runs timer_dma.c
+ * keeps its data below 4GB (see test_dma)
+ */
+typedef struct
+{
+	volatile uint32_t CCR;
+	volatile uint32_t CNDTR;
+	volatile uint32_t CPAR;
+	volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+/**
+ * @brief DMA controller
+ */
+typedef struct
+{
+	volatile uint32_t ISR;
+	volatile uint32_t IFCR;
+} DMA_TypeDef;
+
+/**
+ * @brief Flash interface
+ */
+typedef struct
+{
+	volatile uint32_t ACR;
+} FLASH_TypeDef;
+
+/**
+ * @brief System timer
+ */
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+	volatile uint32_t CALIB;
+} SysTick_Type;
+
+/**
+ * @brief System control block
+ */
+typedef struct
+{
+	volatile uint32_t ICSR;
+} SCB_Type;
+
+/**
+ * @brief Debug MCU configuration
+ */
+typedef struct
+{
+	volatile uint32_t CR;
+} DBGMCU_TypeDef;
+
+/**
+ * @brief Core debug
+ */
+typedef struct
+{
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/**
+ * @brief Data watchpoint and trace unit
+ */
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern EXTI_TypeDef hostExti;
+extern RCC_TypeDef hostRcc;
+extern FLASH_TypeDef hostFlash;
+extern SysTick_Type hostSysTick;
+extern SCB_Type hostScb;
+extern DBGMCU_TypeDef hostDbgmcu;
+extern TIM_TypeDef hostTim[2];
+extern DMA_Channel_TypeDef hostDmaChannel[2];
+extern DMA_TypeDef hostDma;
+extern CoreDebug_Type hostCoreDebug;
+
+/**
+ * @brief Returns the cycle counter unit with CYCCNT brought up to date. The counter runs by the host monotonic time
+ * scaled to the cpu clock, so the profiler measures the time the code really takes on the host
+ * @return unit
+ */
+DWT_Type * Host_Dwt(void);
+
+#define EXTI (&hostExti)
+#define EXTI_PR_PR2 (1u << 2)
+
+#define RCC (&hostRcc)
+#define RCC_CR_HSION          (1u << 0)
+#define RCC_CR_HSIRDY         (1u << 1)
+#define RCC_CR_HSEON          (1u << 16)
+#define RCC_CR_HSERDY         (1u << 17)
+#define RCC_CR_PLLON          (1u << 24)
+#define RCC_CR_PLLRDY         (1u << 25)
+#define RCC_CFGR_SW_0         (1u << 0)
+#define RCC_CFGR_SW_1         (1u << 1)
+#define RCC_CFGR_SW           (RCC_CFGR_SW_0 | RCC_CFGR_SW_1)
+#define RCC_CFGR_PPRE1_2      (1u << 10)
+#define RCC_CFGR_ADCPRE_DIV8  (3u << 14)
+#define RCC_CFGR_PLLSRC       (1u << 16)
+#define RCC_CFGR_PLLMULL8     (6u << 18)
+
+#define RCC_AHBENR_DMA1EN     (1u << 0)
+#define RCC_APB1ENR_TIM2EN    (1u << 0)
+#define RCC_APB1ENR_TIM3EN    (1u << 1)
+
+#define TIM2 (&hostTim[0])
+#define TIM3 (&hostTim[1])
+#define TIM_CR1_CEN           (1u << 0)
+#define TIM_CR1_ARPE          (1u << 7)
+#define TIM_DIER_UDE          (1u << 8)
+#define TIM_EGR_UG            (1u << 0)
+#define TIM_CCMR1_OC1PE       (1u << 3)
+#define TIM_CCMR1_OC1M_0      (1u << 4)
+#define TIM_CCMR1_OC1M_1      (1u << 5)
+#define TIM_CCMR1_OC1M_2      (1u << 6)
+#define TIM_CCER_CC1E         (1u << 0)
+
+#define DMA1 (&hostDma)
+#define DMA1_Channel2 (&hostDmaChannel[0])
+#define DMA1_Channel3 (&hostDmaChannel[1])
+#define DMA_CCR_EN            (1u << 0)
+#define DMA_CCR_TCIE          (1u << 1)
+#define DMA_CCR_HTIE          (1u << 2)
+#define DMA_CCR_DIR           (1u << 4)
+#define DMA_CCR_CIRC          (1u << 5)
+#define DMA_CCR_MINC          (1u << 7)
+#define DMA_CCR_PSIZE_0       (1u << 8)
+#define DMA_CCR_PL_1          (1u << 13)
+#define DMA_ISR_GIF1          (1u << 0)
+#define DMA_ISR_TCIF1         (1u << 1)
+#define DMA_ISR_HTIF1         (1u << 2)
+#define DMA_IFCR_CGIF1        (7u << 0)
+#define DMA_IFCR_CTCIF1       (1u << 1)
+#define DMA_IFCR_CHTIF1       (1u << 2)
+
+#define FLASH (&hostFlash)
+#define FLASH_ACR_LATENCY_1   (1u << 1)
+
+#define SysTick (&hostSysTick)
+#define SysTick_CTRL_ENABLE_Msk    (1u << 0)
+#define SysTick_CTRL_TICKINT_Msk   (1u << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk (1u << 2)
+
+#define SCB (&hostScb)
+#define SCB_ICSR_PENDSTSET_Msk (1u << 26)
+
+#define DBGMCU (&hostDbgmcu)
+#define DBGMCU_CR_DBG_SLEEP (1u << 0)
+
+#define CoreDebug (&hostCoreDebug)
+#define CoreDebug_DEMCR_TRCENA_Msk (1u << 24)
+
+#define DWT (Host_Dwt())
+#define DWT_CTRL_CYCCNTENA_Msk (1u << 0)
+
+void NVIC_EnableIRQ(const IRQn_Type irq);
+void NVIC_DisableIRQ(const IRQn_Type irq);
+
+/**
+ * @brief Barriers, they do nothing on the host
+ */
+void __DSB(void);
+void __ISB(void);
+
+/**
+ * @brief Starts the system timer as CMSIS does: the period is loaded at the next cycle
+ * @param ticks period in cycles
+ * @return 0
+ */
+uint32_t SysTick_Config(const uint32_t ticks);
+
+/**
+ * @brief Masks interrupts. Calls the hook set by @ref Host_SetIrqOffHook
+ */
+void __disable_irq(void);
+
+/**
+ * @brief Unmasks interrupts. A pending systick interrupt is taken at once
+ */
+void __enable_irq(void);
+
+/**
+ * @brief Waits for an interrupt: the virtual time jumps to the next systick reload unless one is pending already
+ */
+void __WFI(void);
+
+#endif /* SOURCES_HOST_INCLUDE_STM32F1XX_H_ */
@@ -0,0 +1,259 @@
+/**
+ * @file sim.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains the host runner of the firmware
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "host.h"
+#include "bll.h"
+#include "clock.h"
+#include "gpio.h"
+#include "buttons.h"
+#include "timer_dma.h"
+#include "flash.h"
+#include "crc.h"
+#include "adc.h"
+#include "watchdog.h"
+#include "profiler.h"
+#include "project_conf.h"
+#include "stm32f1xx.h"
+
+const Sim_Edge_t Sim_ConfigWalk[SIM_CONFIG_WALK_EDGES] =
+{
+		{500, 0},
+		{6000, !0}, {6200, 0},
+		{7000, !0}, {7200, 0},
+		{20000, !0}, {23000, 0}
+};
+
+Config_t Sim_DefaultConfig(const Working_Mode_t mode)
+{
+	const Config_t conf =
+	{
+			.brightness = MAX_BRIGHNESS_LEVELS - 1,
+			.mode = (uint8_t)mode,
+			.tseq = 60,
+			.t1 = 30,
+			.t2 = 15,
+			.tlightMin = 10,
+			.tlightMax = 30,
+			.podnosModeTime = 10,
+			.pitInviteColor = 0
+	};
+	return conf;
+}
+
+const char * Sim_ModeName(const Working_Mode_t mode)
+{
+	static const char * const names[MODE_TOTAL] =
+	{
+			[MODE_PIT] = "MODE_PIT",
+			[MODE_TLIGHT] = "MODE_TLIGHT",
+			[MODE_PODNOS] = "MODE_PODNOS",
+			[MODE_SC] = "MODE_SC",
+			[MODE_KART2H] = "MODE_KART2H",
+			[MODE_PITINVITE] = "MODE_PITINVITE",
+			[MODE_IRONMAN] = "MODE_IRONMAN",
+			[MODE_PIT2] = "MODE_PIT2"
+	};
+	return (mode < MODE_TOTAL) ? names[mode] : "MODE_UNKNOWN";
+}
+
+Working_Mode_t Sim_ParseMode(const char * const arg)
+{
+	Working_Mode_t mode = MODE_TOTAL;
+	for (uint8_t m = 0; m < MODE_TOTAL; m++)
+	{
+		if (strcmp(arg, Sim_ModeName((Working_Mode_t)m)) == 0)
+		{
+			mode = (Working_Mode_t)m;
+		}
+	}
+	if (mode == MODE_TOTAL)
+	{
+		char * end;
+		const long n = strtol(arg, &end, 0);
+		mode = (*end == 0 && n >= 0 && n < MODE_TOTAL) ? (Working_Mode_t)n : MODE_TOTAL;
+	}
+	return mode;
+}
+
+void Sim_Boot(const Config_t * const conf, const uint16_t seed, const uint8_t pressed)
+{
+	Host_SetTicks(0);
+	Host_SetButton(pressed);
+	Gpio_Init();
+	Buttons_Init();
+	tim2_Init();
+	Flash_Init();
+	Crc_Init();
+	eeemu_Init();
+	eeemu_write(conf);
+	eeemuSeedSet(seed);
+	Flash_Flush();
+	Adc_Init();
+	watchdog_Init();
+}
+
+/**
+ * @brief Sleeps as the main loop of main.c does. With zero time the loop spins until the tick changes: code takes
+ * no time on the host, so the spin is a jump to the next systick interrupt
+ * @param ms time to the next task
+ */
+static void sleepMs(const uint32_t ms)
+{
+	if (ms != 0)
+	{
+		Clock_Sleep(ms);
+	}
+	else
+	{
+		__WFI();
+	}
+}
+
+static void logFrames(void);
+
+void Sim_LoopBody(void)
+{
+#ifdef PROFILING
+	if (MainLoop_Iteration() != 0)
+	{
+		Profiler_Update();
+	}
+#else
+	MainLoop_Iteration();
+#endif
+	logFrames();
+	Flash_Process();
+	Reset_Watchdog();
+}
+
+void Sim_Iteration(void)
+{
+	Sim_LoopBody();
+	sleepMs(MainLoop_TimeToNextTask());
+}
+
+/**
+ * @brief Host monotonic time
+ * @return ns
+ */
+static uint64_t wallNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void Sim_Run(const uint32_t until, const Sim_Edge_t * const script, const uint16_t n, Sim_Stats_t * const stats)
+{
+	const uint64_t start = wallNs();
+	const uint32_t frames = Host_GetStripFrames();
+	uint32_t iterations = 0;
+	uint16_t next = 0;
+	while (next < n && script[next].time < GetTicksCounter())
+	{
+		next++;
+	}
+	while (GetTicksCounter() < until)
+	{
+		const uint32_t now = GetTicksCounter();
+		while (next < n && script[next].time == now)
+		{
+			Host_SetButton(script[next].pressed);
+			next++;
+		}
+		Sim_LoopBody();
+		uint32_t ms = MainLoop_TimeToNextTask();
+		if (next < n && script[next].time - now < ms)
+		{
+			ms = script[next].time - now;
+		}
+		if (until - now < ms)
+		{
+			ms = until - now;
+		}
+		sleepMs(ms);
+		iterations++;
+	}
+	if (stats != NULL)
+	{
+		stats->iterations += iterations;
+		stats->frames += Host_GetStripFrames() - frames;
+		stats->wallNs += wallNs() - start;
+	}
+}
+
+uint32_t Sim_StripHash(void)
+{
+	const Led_t * const strip = Host_GetStrip();
+	uint32_t hash = 2166136261u;
+	for (uint16_t i = 0; i < NLEDS; i++)
+	{
+		/* Display order: row 0 forward, then row 1 backward */
+#if STRIP_LAYOUT == STRIP_LAYOUT_PARALLEL
+		const uint16_t led = (i < NLEDS / 2) ? i : NLEDS - 1 - (i - NLEDS / 2);
+#else
+		const uint16_t led = i;
+#endif
+		/* Colors in the GRBW wire order whatever the @ref PIXEL_FORMAT is */
+#if PIXEL_HAS_W
+		const uint8_t colors[] = {strip[led].G, strip[led].R, strip[led].B, strip[led].W};
+#else
+		const uint8_t colors[] = {strip[led].G, strip[led].R, strip[led].B};
+#endif
+		for (uint8_t j = 0; j < sizeof(colors); j++)
+		{
+			hash = (hash ^ colors[j]) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+static FILE * frameLog = NULL;       /**< Frame log or NULL */
+static uint32_t lastHash = 0;        /**< Hash of the last logged frame */
+static uint8_t logged = 0;           /**< Nonzero if a frame was logged */
+static uint8_t framesDone = 0;       /**< Nonzero if a frame was decoded since the last log check */
+
+/**
+ * @brief Frame hook of the log. The frame is logged by @ref logFrames when every channel that is sent is done
+ * @param ch channel
+ */
+static void frameDone(const uint8_t ch)
+{
+	(void)ch;
+	framesDone = !0;
+}
+
+/**
+ * @brief Logs the strip if a frame was decoded and it differs from the last one
+ */
+static void logFrames(void)
+{
+	if (frameLog != NULL && framesDone != 0)
+	{
+		const uint32_t hash = Sim_StripHash();
+		framesDone = 0;
+		if (logged == 0 || hash != lastHash)
+		{
+			fprintf(frameLog, "%u %08x\n", (unsigned)GetTicksCounter(), (unsigned)hash);
+			lastHash = hash;
+			logged = !0;
+		}
+	}
+}
+
+void Sim_LogFrames(FILE * const out)
+{
+	frameLog = out;
+	logged = 0;
+	framesDone = 0;
+	Host_SetFrameHook((out != NULL) ? frameDone : NULL);
+}
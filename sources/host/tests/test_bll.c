@@ -0,0 +1,77 @@
+/**
+ * @file test_bll.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the task switcher: no late runs while the loop keeps up. After a stall longer than a period
+ * the heartbeat (TASK_CATCH_UP) does every missed run late, one per tick, and led control (TASK_SKIP) runs once
+ * and skips the missed periods
+ */
+#include "host_test.h"
+#include "host.h"
+#include "sim.h"
+#include "bll.h"
+#include "clock.h"
+
+enum
+{
+	TASK_HEARTBEAT = 0,  /**< Heartbeat task number */
+	TASK_LED_CONTROL = 1, /**< Led control task number */
+	HEARTBEAT_PERIOD = 500,
+	HEARTBEAT_PHASE = 3,
+	STALL_MS = 1250 /**< Loop stall */
+};
+
+int main(void)
+{
+	const Config_t conf = Sim_DefaultConfig(MODE_SC);
+	Sim_Boot(&conf, 0x1234, 0);
+	while (GetTicksCounter() < 10000)
+	{
+		Sim_Iteration();
+	}
+	const Task_Stats_t * const hb = GetTaskStats(TASK_HEARTBEAT);
+	const Task_Stats_t * const lc = GetTaskStats(TASK_LED_CONTROL);
+	CHECK(GetTaskStats(2) == NULL);
+	CHECK_EQ(hb->LateRuns, 0);
+	CHECK_EQ(lc->LateRuns, 0);
+	CHECK_EQ(hb->SkippedRuns, 0);
+	CHECK_EQ(lc->SkippedRuns, 0);
+
+	/* Stall: the loop comes back after more than two heartbeat periods */
+	const uint32_t hbDeadline = hb->Deadline;
+	Host_SetTicks(hbDeadline + STALL_MS);
+	MainLoop_Iteration();
+	const uint32_t now = GetTicksCounter();
+	CHECK_EQ(hb->LateRuns, 1);
+	CHECK_EQ(hb->WorstLateness, STALL_MS);
+	CHECK_EQ(hb->SkippedRuns, 0);
+	CHECK_EQ(hb->Deadline, hbDeadline + HEARTBEAT_PERIOD);
+	CHECK_EQ(lc->LateRuns, 1);
+	CHECK(lc->SkippedRuns > 0);
+	CHECK(lc->Deadline > now);
+
+	/* The heartbeat catches up one run per tick, the loop doesn't sleep meanwhile */
+	CHECK_EQ(MainLoop_TimeToNextTask(), 0);
+	for (uint32_t run = 1; run <= STALL_MS / HEARTBEAT_PERIOD; run++)
+	{
+		Host_SetTicks(now + run);
+		MainLoop_Iteration();
+		CHECK_EQ(hb->LateRuns, 1 + run);
+	}
+	CHECK_EQ(hb->SkippedRuns, 0);
+	CHECK(hb->Deadline > GetTicksCounter());
+	CHECK(hb->Deadline - now <= HEARTBEAT_PERIOD);
+	CHECK_EQ(hb->Deadline % HEARTBEAT_PERIOD, HEARTBEAT_PHASE);
+	CHECK_EQ(lc->LateRuns, 1);
+
+	/* The loop keeps up again: no more late runs */
+	while (GetTicksCounter() < now + 10000)
+	{
+		Sim_Iteration();
+	}
+	CHECK_EQ(hb->LateRuns, 1 + STALL_MS / HEARTBEAT_PERIOD);
+	CHECK_EQ(lc->LateRuns, 1);
+	return TEST_RESULT;
+}
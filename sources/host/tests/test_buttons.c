@@ -0,0 +1,124 @@
+/**
+ * @file test_buttons.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Replays button edges through the EXTI interrupt of buttons.c and checks the debounced events:
+ * bounces give one event, taps shorter than the @ref Button_Process period and long presses are not lost
+ */
+#include "host_test.h"
+#include "host.h"
+#include "buttons.h"
+#include "clock.h"
+
+enum
+{
+	PROCESS_MS = 100, /**< Button_Process period, the led control step */
+	LOG_LEN = 128
+};
+
+/**
+ * @brief Edge of the replayed script
+ */
+typedef struct
+{
+	uint32_t time; /**< ms from the script start */
+	uint8_t level; /**< Level after the edge, nonzero if pressed */
+} Script_Edge_t;
+
+static uint32_t now = 0; /**< Replay time */
+static char eventLog[LOG_LEN]; /**< Events as letters: P - press, R - release, L - long */
+static uint8_t logLen = 0;
+
+static void drainEvents(void)
+{
+	ButtonEvent_t event;
+	while ((event = Button_GetEvent(B_CONFIG)) != BUTTON_EVENT_NONE)
+	{
+		static const char letters[] = {[BUTTON_EVENT_PRESS] = 'P', [BUTTON_EVENT_RELEASE] = 'R', [BUTTON_EVENT_LONG] = 'L'};
+		if (logLen < LOG_LEN - 1)
+		{
+			eventLog[logLen++] = letters[event];
+			eventLog[logLen] = 0;
+		}
+	}
+}
+
+/**
+ * @brief Replays edges ms by ms, the button is processed every @p period ms and the events are taken every time
+ * @param edges edges sorted by time
+ * @param n number of edges
+ * @param length replay length in ms
+ * @param period Button_Process period
+ * @return events of the replay
+ */
+static const char * replay(const Script_Edge_t * const edges, const uint16_t n, const uint32_t length, const uint32_t period)
+{
+	const uint32_t start = now;
+	uint16_t next = 0;
+	logLen = 0;
+	eventLog[0] = 0;
+	for (; now < start + length; now++)
+	{
+		Host_SetTicks(now);
+		while (next < n && start + edges[next].time == now)
+		{
+			Host_SetButton(edges[next].level);
+			next++;
+		}
+		if ((now - start) % period == 0)
+		{
+			Button_Process(B_CONFIG);
+			drainEvents();
+		}
+	}
+	return eventLog;
+}
+
+int main(void)
+{
+	Host_SetTicks(now);
+	Buttons_Init();
+	CHECK(IsPressed(B_CONFIG) == 0);
+
+	static const Script_Edge_t clean[] = {{10, 1}, {300, 0}};
+	CHECK_STR(replay(clean, 2, 1000, PROCESS_MS), "PR");
+
+	/* Contact bounce at both edges */
+	static const Script_Edge_t bouncy[] = {{10, 1}, {11, 0}, {12, 1}, {14, 0}, {15, 1}, {400, 0}, {401, 1}, {403, 0}, {404, 1}, {406, 0}};
+	CHECK_STR(replay(bouncy, sizeof(bouncy) / sizeof(bouncy[0]), 1000, PROCESS_MS), "PR");
+	CHECK(IsReleased(B_CONFIG) != 0 || IsSteadyReleased(B_CONFIG) != 0);
+
+	/* A tap that starts and ends between two Button_Process calls */
+	static const Script_Edge_t tap[] = {{110, 1}, {180, 0}};
+	CHECK_STR(replay(tap, 2, 1000, PROCESS_MS), "PR");
+
+	/* Long press */
+	static const Script_Edge_t longPress[] = {{10, 1}, {2600, 0}};
+	CHECK_STR(replay(longPress, 2, 3000, PROCESS_MS), "PLR");
+	CHECK(IsLongPressed(B_CONFIG) == 0);
+
+	/* Eight bouncy taps in a row: every led control step gets several edges, events are not lost */
+	Script_Edge_t taps[8 * 4];
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		taps[i * 4 + 0] = (Script_Edge_t){.time = 10u + i * 120u, .level = 1};
+		taps[i * 4 + 1] = (Script_Edge_t){.time = 11u + i * 120u, .level = 0};
+		taps[i * 4 + 2] = (Script_Edge_t){.time = 12u + i * 120u, .level = 1};
+		taps[i * 4 + 3] = (Script_Edge_t){.time = 70u + i * 120u, .level = 0};
+	}
+	CHECK_STR(replay(taps, sizeof(taps) / sizeof(taps[0]), 1100, PROCESS_MS), "PRPRPRPRPRPRPRPR");
+	CHECK_EQ(Button_GetOverflows(), 0);
+
+	/* A burst longer than the edge queue: the level is recovered from the pin, the press is still reported */
+	Script_Edge_t burst[41];
+	for (uint8_t i = 0; i < 41; i++)
+	{
+		burst[i] = (Script_Edge_t){.time = 10u + i, .level = (uint8_t)((i & 1u) == 0)};
+	}
+	CHECK_STR(replay(burst, sizeof(burst) / sizeof(burst[0]), 500, PROCESS_MS), "P");
+	CHECK(Button_GetOverflows() > 0);
+	CHECK(IsPressed(B_CONFIG) != 0);
+	return TEST_RESULT;
+}
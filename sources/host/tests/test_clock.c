@@ -0,0 +1,88 @@
+/**
+ * @file test_clock.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the tick compensation of clock.c over the systick fake: the ticks read in the middle of a stretched
+ * systick period, the wake up at the end of a sleep, a reload that comes while the sleep is being set up
+ * and the sleep percentage
+ */
+#include "host_test.h"
+#include "host.h"
+#include "clock.h"
+#include "stm32f1xx.h"
+
+enum
+{
+	TICK_CYCLES = CPU_FREQ / SYSTICK_FREQ, /**< Cpu cycles per tick */
+	SLEEP_MS = 50,    /**< Sleep of the stretched period test */
+	RACE_MS = 100,    /**< Sleep of the race test */
+	LOAD_MS = 2500    /**< Time of the sleep percentage test */
+};
+
+/**
+ * @brief Hook of __disable_irq: the 1 tick period ends right after the interrupts are masked
+ */
+static void reloadWhileMasked(void)
+{
+	Host_SetIrqOffHook(NULL);
+	Host_AdvanceCycles(SysTick->VAL + 1);
+}
+
+int main(void)
+{
+	/* 1 tick periods */
+	CHECK_EQ(GetTicksCounter(), 0);
+	Host_AdvanceCycles(TICK_CYCLES / 2);
+	CHECK_EQ(GetTicksCounter(), 0);
+	Host_AdvanceCycles(TICK_CYCLES / 2);
+	CHECK_EQ(GetTicksCounter(), 1);
+
+	/* The sleep ends the current period first, then the stretched one is counted by the elapsed part of it */
+	uint32_t start = GetTicksCounter();
+	Clock_Sleep(SLEEP_MS);
+	CHECK_EQ(GetTicksCounter(), start + 1);
+	CHECK_EQ(SysTick->LOAD, TICK_CYCLES - 1);
+	CHECK_EQ(SysTick->VAL, (SLEEP_MS - 1) * TICK_CYCLES - 1);
+	Host_AdvanceCycles(TICK_CYCLES / 2);
+	for (uint32_t i = 1; i < SLEEP_MS - 1; i++)
+	{
+		CHECK_EQ(GetTicksCounter(), start + i);
+		Host_AdvanceCycles(TICK_CYCLES);
+	}
+	CHECK_EQ(GetTicksCounter(), start + SLEEP_MS - 1);
+	/* The period is not shortened and is not extended */
+	Clock_Sleep(1);
+	CHECK_EQ(GetTicksCounter(), start + SLEEP_MS);
+	CHECK_EQ(SysTick->VAL, TICK_CYCLES - 1);
+	Host_Advance(1);
+	CHECK_EQ(GetTicksCounter(), start + SLEEP_MS + 1);
+
+	/* The 1 tick period reloads after the check of the sleep set up: the stretched period must not be taken for it */
+	start = GetTicksCounter();
+	Host_SetIrqOffHook(reloadWhileMasked);
+	Clock_Sleep(RACE_MS);
+	CHECK_EQ(GetTicksCounter(), start + 1);
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		Host_AdvanceCycles(TICK_CYCLES / 2);
+		CHECK_EQ(GetTicksCounter(), start + 1 + i);
+		Host_AdvanceCycles(TICK_CYCLES / 2);
+	}
+	CHECK_EQ(GetTicksCounter(), start + 4);
+	Clock_Sleep(RACE_MS);
+	Clock_Sleep(RACE_MS - 1);
+	CHECK_EQ(GetTicksCounter(), start + 4 + RACE_MS);
+
+	/* 1 tick awake, 4 asleep: 80% */
+	start = GetTicksCounter();
+	while (GetTicksCounter() < start + LOAD_MS)
+	{
+		Host_Advance(1);
+		Clock_Sleep(4);
+		Clock_Sleep(3);
+	}
+	CHECK_EQ(Clock_GetSleepPercent(), 80);
+	return TEST_RESULT;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file test_crc.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the software crc32 against CRC-32/MPEG-2, the crc of the STM32F1 crc unit. A bitwise reference over
+ * bytes is checked by the catalogue value of "123456789", then the table crc must give the same for words fed most
+ * significant byte first, and 0x12345678 must give 0xDF8A8A2B as on the crc unit
+ */
+#include "host_test.h"
+#include "crc.h"
+
+enum
+{
+	RANDOM_WORDS = 64 /**< Length of the random data */
+};
+
+/**
+ * @brief Bitwise CRC-32/MPEG-2
+ * @param data bytes
+ * @param len number of bytes
+ * @return crc
+ */
+static uint32_t mpeg2(const uint8_t * const data, const uint16_t len)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for (uint16_t i = 0; i < len; i++)
+	{
+		crc ^= (uint32_t)data[i] << 24;
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = ((crc & 0x80000000u) != 0) ? (crc << 1) ^ 0x04C11DB7u : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief Makes words of bytes, most significant byte first as the crc unit takes them
+ * @param bytes bytes, 4 per word
+ * @param words out parameter
+ * @param nwords number of words
+ */
+static void toWords(const uint8_t * const bytes, uint32_t * const words, const uint16_t nwords)
+{
+	for (uint16_t i = 0; i < nwords; i++)
+	{
+		words[i] = ((uint32_t)bytes[4 * i] << 24) | ((uint32_t)bytes[4 * i + 1] << 16) | ((uint32_t)bytes[4 * i + 2] << 8) | bytes[4 * i + 3];
+	}
+}
+
+int main(void)
+{
+	Crc_Init();
+	CHECK_EQ(mpeg2((const uint8_t *)"123456789", 9), 0x0376E6E7);
+
+	const uint32_t st = 0x12345678;
+	CHECK_EQ(Crc32(&st, 1), 0xDF8A8A2B);
+	CHECK_EQ(Crc32(NULL, 0), 0xFFFFFFFF);
+
+	uint32_t words[RANDOM_WORDS];
+	toWords((const uint8_t *)"12345678", words, 2);
+	CHECK_EQ(Crc32(words, 2), mpeg2((const uint8_t *)"12345678", 8));
+
+	uint8_t bytes[RANDOM_WORDS * 4];
+	uint32_t x = 0x2545F491;
+	for (uint16_t i = 0; i < sizeof(bytes); i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		bytes[i] = (uint8_t)x;
+	}
+	toWords(bytes, words, RANDOM_WORDS);
+	for (uint16_t n = 1; n <= RANDOM_WORDS; n++)
+	{
+		CHECK_EQ(Crc32(words, n), mpeg2(bytes, (uint16_t)(n * 4)));
+	}
+	return TEST_RESULT;
+}
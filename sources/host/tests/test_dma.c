@@ -0,0 +1,173 @@
+/**
+ * @file test_dma.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Is built for 144, 300 and 600 leds by -DSTRIP_LEDS. Runs rgbw.c and timer_dma.c over the dma timing model
+ * (dma_model.c) at 64MHz: a frame and two frames back to back must be sent with no underrun and the CCR stream must
+ * decode to the frames. Then the strip interrupt is kept from the cpu for longer than a half, that must be counted
+ * as an underrun. Prints the timing as a JSON line
+ */
+#include <stdint.h>
+#include "host_test.h"
+#include "stm32f1xx.h"
+#include "dma_model.h"
+#include "rgbw.h"
+#include "timer_dma.h"
+
+#ifndef STRIP_LEDS
+#error test_dma must be built with -DSTRIP_LEDS
+#endif
+
+enum
+{
+	SYSTICK_PERIOD = 64000, /**< Cycles between systick interrupts */
+	SYSTICK_CYCLES = 300    /**< Systick interrupt with the clock update and the button debounce, it preempts the strip */
+};
+
+/**
+ * @brief Cost of the strip interrupt. The bitwise kernel is the slower one, 400 cycles per led is its bound at two
+ * flash wait states (rgbw_Benchmark measures it on the target)
+ */
+static const Model_IsrCost_t Cost =
+{
+		.entry = 12,
+		.fixed = 200,
+		.perLed = 400
+};
+
+/**
+ * @brief Runs the model with the systick interrupts until the strip is idle
+ * @param maxCycles limit
+ * @return nonzero if the strip went idle
+ */
+static uint8_t runIdle(const uint32_t maxCycles)
+{
+	uint8_t idle = 0;
+	for (uint32_t t = 0; t < maxCycles && idle == 0; t += SYSTICK_PERIOD)
+	{
+		Model_Block(SYSTICK_CYCLES);
+		idle = Model_RunIdle(SYSTICK_PERIOD);
+	}
+	return idle;
+}
+
+/**
+ * @brief Decodes the next frame of the CCR stream: a long pulse is one, the frame ends at the first zero
+ * @param ccr stream
+ * @param n stream length
+ * @param pos position in the stream, is moved past the frame
+ * @param bytes decoded bytes
+ * @param size size of bytes
+ * @return number of decoded bits
+ */
+static uint32_t decodeFrame(const uint8_t * const ccr, const uint32_t n, uint32_t * const pos, uint8_t * const bytes,
+		const uint32_t size)
+{
+	uint32_t bits = 0;
+	while (*pos < n && ccr[*pos] == 0)
+	{
+		(*pos)++;
+	}
+	while (*pos < n && ccr[*pos] != 0)
+	{
+		if (bits / 8 < size)
+		{
+			bytes[bits / 8] = (uint8_t)((bytes[bits / 8] << 1) | ((ccr[*pos] > STRIP_BIT_TICKS / 2u) ? 1u : 0u));
+		}
+		bits++;
+		(*pos)++;
+	}
+	return bits;
+}
+
+/**
+ * @brief Checks that the stream of every channel is the given frames
+ * @param frames frames
+ * @param count number of frames
+ */
+static void checkStream(const Led_t (* const frames)[NLEDS], const uint8_t count)
+{
+	static uint8_t bytes[CHANNEL_LEDS * sizeof(Led_t)];
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		uint32_t n;
+		uint32_t pos = 0;
+		const uint8_t * const ccr = Model_GetStream(ch, &n);
+		for (uint8_t f = 0; f < count; f++)
+		{
+			memset(bytes, 0, sizeof(bytes));
+			CHECK_EQ(decodeFrame(ccr, n, &pos, bytes, sizeof(bytes)), 8 * sizeof(bytes));
+			CHECK(memcmp(bytes, frames[f] + ch * CHANNEL_LEDS, sizeof(bytes)) == 0);
+			/* The frame is followed by the reset pulse, a whole zero half */
+			uint32_t zeros = 0;
+			while (pos < n && ccr[pos] == 0)
+			{
+				zeros++;
+				pos++;
+			}
+			CHECK(zeros * STRIP_BIT_TICKS >= Model_GetStats()->halfCycles);
+		}
+		CHECK_EQ(pos, n);
+	}
+}
+
+int main(void)
+{
+	static Led_t Frames[2][NLEDS];
+	uint16_t nleds[STRIP_CHANNELS];
+	for (uint32_t i = 0; i < sizeof(Frames); i++)
+	{
+		((uint8_t *)Frames)[i] = (uint8_t)(i * 37u + 1u);
+	}
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		nleds[ch] = CHANNEL_LEDS;
+	}
+	/* timer_dma.c keeps the addresses in 32 bit registers */
+	CHECK((uintptr_t)Frames < UINT32_MAX);
+	CHECK((uintptr_t)TIM3 < UINT32_MAX);
+
+	/* One frame */
+	Model_Init(&Cost);
+	tim2_Init();
+	CHECK_EQ(DMA1_Channel2->CPAR, (uint32_t)(uintptr_t)&TIM2->CCR1);
+	displayStrip(Frames[0], nleds);
+	CHECK(runIdle(1000u * SYSTICK_PERIOD) != 0);
+	checkStream(Frames, 1);
+	CHECK_EQ(tim2_GetUnderruns(), 0);
+	const uint32_t frameUs = (uint32_t)((uint64_t)Model_GetStats()->sent[0] * STRIP_BIT_TICKS * 1000000u / STRIP_TIMER_CLOCK_HZ);
+
+	/* Two frames back to back: the second one is pending when the first one is being sent */
+	Model_Init(&Cost);
+	tim2_Init();
+	displayStrip(Frames[0], nleds);
+	Model_Run(STRIP_BIT_TICKS); /* The first update takes the buffer size */
+	Model_Run(Model_GetStats()->halfCycles * 3u);
+	displayStrip(Frames[1], nleds);
+	CHECK(runIdle(1000u * SYSTICK_PERIOD) != 0);
+	checkStream(Frames, 2);
+	const uint32_t underruns = tim2_GetUnderruns();
+	CHECK_EQ(underruns, 0);
+	const Model_Stats_t stats = *Model_GetStats();
+	CHECK(stats.maxResponse < stats.halfCycles);
+
+	/* The interrupt is late by more than a half */
+	Model_Init(&Cost);
+	tim2_Init();
+	displayStrip(Frames[0], nleds);
+	Model_Run(STRIP_BIT_TICKS); /* The first update takes the buffer size */
+	Model_Run(Model_GetStats()->halfCycles * 3u);
+	Model_Block(Model_GetStats()->halfCycles * 2u);
+	CHECK(runIdle(1000u * SYSTICK_PERIOD) != 0);
+	CHECK(tim2_GetUnderruns() != 0);
+
+	printf("{\"leds\":%u,\"channels\":%u,\"half_cycles\":%u,\"isr_cycles\":%u,\"worst_response_cycles\":%u,"
+			"\"slack_cycles\":%d,\"isr_calls\":%u,\"frame_us\":%u,\"underruns\":%u}\n", (unsigned)NLEDS,
+			(unsigned)STRIP_CHANNELS, (unsigned)stats.halfCycles,
+			(unsigned)(Cost.entry + Cost.fixed + Cost.perLed * stats.halfCycles / STRIP_BIT_TICKS / (8u * sizeof(Led_t))),
+			(unsigned)stats.maxResponse, (int)stats.halfCycles - (int)stats.maxResponse, (unsigned)stats.isrCalls,
+			(unsigned)frameUs, (unsigned)underruns);
+	return TEST_RESULT;
+}
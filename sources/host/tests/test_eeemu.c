@@ -0,0 +1,386 @@
+/**
+ * @file test_eeemu.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Compares the config journal of eeemu.c with the single page store of the firmware before it on the NOR
+ * flash fake. Both stores get the same configs, every one is followed by a reboot. The erases of every page and the
+ * boot time with a full page are printed as JSON lines. The single page store is rebuilt here as it was: one
+ * 1 KB page of 10 byte elements with crc8, erased when full, and every element is checked by crc8 at boot.
+ * It's run with 16 byte elements too, the size of the journal record since the config got a version and crc32.
+ * Before that the migration is checked: a page written by the baseline firmware, without a header and with crc8
+ * elements, and a journal page full of version 0 records must give their last config, and the next write must go to
+ * the other page
+ */
+#include <time.h>
+#include "host_test.h"
+#include "eeemu.h"
+#include "flash.h"
+#include "crc.h"
+#include "host.h"
+
+enum
+{
+	WRITES = 1000,     /**< Configs written */
+	OLD_HALFWORDS = 5, /**< Element size of the firmware before the journal */
+	NEW_HALFWORDS = 8, /**< Config record size of the journal */
+	MAX_HALFWORDS = 8, /**< Maximal element size */
+	BOOTS = 20000,     /**< Boots timed */
+	MAX_PAGES = 8,     /**< Maximal number of erased pages */
+	JOURNAL_RECORDS = FLASH_PAGE_SIZE / (NEW_HALFWORDS * 2), /**< Records in a journal page, the first one is the header */
+	JOURNAL_MAGIC = 0xEE5B,  /**< The first halfword of the journal page header */
+	JOURNAL_ERASES = 5,      /**< Erase counter of the journal page header */
+	BASELINE_CONFIGS = 3     /**< Configs in the page of the baseline firmware, the last one is cut by a power loss */
+};
+
+/**
+ * @brief Single page store
+ */
+typedef struct
+{
+	volatile uint16_t * page; /**< Flash page */
+	uint8_t halfwords;        /**< Element size, the last byte is crc8 */
+	uint16_t next;            /**< The first element that did not pass the crc check at boot */
+} Single_Page_t;
+
+static volatile uint16_t __attribute__((aligned(FLASH_PAGE_SIZE))) oldPage[FLASH_PAGE_SIZE / sizeof(uint16_t)];
+static volatile uint16_t __attribute__((aligned(FLASH_PAGE_SIZE))) widePage[FLASH_PAGE_SIZE / sizeof(uint16_t)];
+static Single_Page_t oldStore = {oldPage, OLD_HALFWORDS, 0};   /**< As the firmware before the journal */
+static Single_Page_t wideStore = {widePage, NEW_HALFWORDS, 0}; /**< With the record size of the journal */
+
+/**
+ * @brief crc8 of the single page store
+ * @param data data
+ * @param len length
+ * @return crc8
+ */
+static uint8_t crc8(const uint8_t * const data, const uint8_t len)
+{
+	uint8_t crc = 0xff;
+	for (uint8_t i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		for (uint8_t j = 0; j < 8; j++)
+		{
+			crc = ((crc & 0x80) != 0) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief Returns the number of elements in the page
+ * @param store store
+ * @return elements
+ */
+static uint16_t elements(const Single_Page_t * const store)
+{
+	return (uint16_t)(FLASH_PAGE_SIZE / (store->halfwords * sizeof(uint16_t)));
+}
+
+/**
+ * @brief Boot of the single page store: elements are checked by crc8 until the first bad one
+ * @param store store
+ */
+static void singleInit(Single_Page_t * const store)
+{
+	const uint8_t len = (uint8_t)(store->halfwords * sizeof(uint16_t) - 1);
+	uint16_t i;
+	for (i = 0; i < elements(store); i++)
+	{
+		uint16_t raw[MAX_HALFWORDS];
+		for (uint8_t j = 0; j < store->halfwords; j++)
+		{
+			raw[j] = store->page[i * store->halfwords + j];
+		}
+		const uint8_t * const bytes = (const uint8_t *)raw;
+		if (bytes[len] != crc8(bytes, len))
+		{
+			break;
+		}
+	}
+	store->next = i;
+}
+
+/**
+ * @brief Write of the single page store: the page is erased if the next element is not erased or the page is full
+ * @param store store
+ * @param config config
+ */
+static void singleWrite(Single_Page_t * const store, const Config_t * const config)
+{
+	const uint8_t len = (uint8_t)(store->halfwords * sizeof(uint16_t) - 1);
+	uint8_t erased = store->next < elements(store);
+	for (uint8_t j = 0; erased != 0 && j < store->halfwords; j++)
+	{
+		erased = store->page[store->next * store->halfwords + j] == 0xFFFF;
+	}
+	if (erased == 0)
+	{
+		Flash_Erase(store->page, NULL);
+		store->next = 0;
+	}
+	uint16_t raw[MAX_HALFWORDS];
+	uint8_t * const bytes = (uint8_t *)raw;
+	memset(raw, 0xFF, sizeof(raw));
+	memcpy(bytes, config, sizeof(Config_t));
+	bytes[len] = crc8(bytes, len);
+	Flash_Program(store->page + store->next * store->halfwords, raw, store->halfwords, NULL);
+	store->next++;
+}
+
+/**
+ * @brief Boot of the single page store as the firmware before the journal
+ */
+static void oldInit(void)
+{
+	singleInit(&oldStore);
+}
+
+/**
+ * @brief Host monotonic time
+ * @return ns
+ */
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Times the boot
+ * @param init boot function
+ * @return ns per boot
+ */
+static double timeBoot(void (*init)(void))
+{
+	const uint64_t start = nowNs();
+	for (uint32_t i = 0; i < BOOTS; i++)
+	{
+		init();
+	}
+	return (double)(nowNs() - start) / BOOTS;
+}
+
+/**
+ * @brief Config of the write
+ * @param i write number
+ * @return config
+ */
+static Config_t configOf(const uint32_t i)
+{
+	const Config_t conf = {.brightness = (uint8_t)(i % 8), .mode = (uint8_t)(i % 7), .tseq = (uint8_t)(i % 200), .t1 = 30,
+			.t2 = 15, .tlightMin = 10, .tlightMax = 30, .podnosModeTime = 10, .pitInviteColor = (uint8_t)(i % 3)};
+	return conf;
+}
+
+/**
+ * @brief Finds a journal page: an erased page with the journal header
+ * @param page page to skip or NULL
+ * @return the page, NULL if none
+ */
+static volatile uint16_t * otherPage(const volatile uint16_t * const page)
+{
+	volatile uint16_t * other = NULL;
+	for (uint8_t i = 0; Host_GetFlashPage(i) != NULL; i++)
+	{
+		if (Host_GetFlashPage(i)->page != page && Host_GetFlashPage(i)->page[0] == JOURNAL_MAGIC)
+		{
+			other = (volatile uint16_t *)Host_GetFlashPage(i)->page;
+		}
+	}
+	return other;
+}
+
+/**
+ * @brief Checks that the next write goes to the other page and is read back after a reboot
+ * @param page the page that was migrated
+ * @return the other page
+ */
+static volatile uint16_t * checkSwap(volatile uint16_t * const page)
+{
+	const uint16_t first = page[0];
+	const uint32_t erases = eeemuStats.configErases[0] + eeemuStats.configErases[1];
+	const Config_t next = configOf(7);
+	eeemu_write(&next);
+	Flash_Flush();
+	CHECK_EQ(eeemuStats.configErases[0] + eeemuStats.configErases[1], erases + 1);
+	CHECK_EQ(page[0], first); /* The migrated page is kept until the other one is full */
+	volatile uint16_t * const other = otherPage(page);
+	CHECK(other != NULL);
+	eeemu_Init();
+	CHECK(memcmp(eeemuGetConfig(), &next, sizeof(next)) == 0);
+	return other;
+}
+
+/**
+ * @brief Checks the migration of the configs written by older firmware
+ */
+static void testMigration(void)
+{
+	/* The pages are found by the writes: the first one goes to the second page as the first page is not erased, then
+	 * the second page is filled and the next write swaps to the first page, that is the page of the baseline firmware */
+	eeemu_Init();
+	const Config_t any = configOf(1);
+	eeemu_write(&any);
+	Flash_Flush();
+	volatile uint16_t * const second = otherPage(NULL);
+	CHECK(second != NULL);
+	for (uint8_t i = 0; i < JOURNAL_RECORDS && otherPage(second) == NULL; i++)
+	{
+		eeemu_write(&any);
+		Flash_Flush();
+	}
+	volatile uint16_t * const page = otherPage(second);
+	CHECK(page != NULL);
+	if (second == NULL || page == NULL)
+	{
+		return;
+	}
+
+	/* Baseline page: 10 byte elements with crc8 and no header. The last element is cut, so its crc8 is wrong */
+	Flash_Erase(second, NULL);
+	Flash_Erase(page, NULL);
+	for (uint8_t i = 0; i < BASELINE_CONFIGS; i++)
+	{
+		uint16_t raw[OLD_HALFWORDS];
+		uint8_t * const bytes = (uint8_t *)raw;
+		const Config_t conf = configOf(100 + i);
+		memcpy(bytes, &conf, sizeof(conf));
+		bytes[sizeof(conf)] = (uint8_t)(crc8(bytes, sizeof(conf)) ^ ((i == BASELINE_CONFIGS - 1) ? 0xFF : 0));
+		Flash_Program(page + i * OLD_HALFWORDS, raw, OLD_HALFWORDS, NULL);
+	}
+	Flash_Flush();
+	eeemu_Init();
+	const Config_t baseline = configOf(100 + BASELINE_CONFIGS - 2);
+	CHECK(memcmp(eeemuGetConfig(), &baseline, sizeof(baseline)) == 0);
+	volatile uint16_t * const other = checkSwap(page);
+	if (other == NULL)
+	{
+		return;
+	}
+
+	/* Journal page full of version 0 records, the other page is older */
+	const uint16_t seq = (uint16_t)(other[1] + 1);
+	const uint32_t pageErases = eeemuStats.configErases[0] + 1;
+	const uint16_t header[NEW_HALFWORDS] = {JOURNAL_MAGIC, seq, (uint16_t)(seq ^ 0xFFFF), 0xFFFF, 0xFFFF,
+			(uint16_t)pageErases, (uint16_t)(pageErases >> 16), 0xFFFF};
+	Flash_Erase(page, NULL);
+	for (uint8_t i = 1; i < JOURNAL_RECORDS; i++)
+	{
+		union
+		{
+			uint32_t words[NEW_HALFWORDS / 2];
+			uint16_t raw[NEW_HALFWORDS];
+			uint8_t bytes[NEW_HALFWORDS * 2];
+		} record;
+		const Config_t conf = configOf(200 + i);
+		memset(&record, 0xFF, sizeof(record));
+		record.bytes[0] = 0; /* Version */
+		memcpy(record.bytes + 1, &conf, sizeof(conf));
+		record.words[NEW_HALFWORDS / 2 - 1] = Crc32(record.words, NEW_HALFWORDS / 2 - 1);
+		Flash_Program(page + i * NEW_HALFWORDS, record.raw, NEW_HALFWORDS, NULL);
+	}
+	Flash_Program(page, header, NEW_HALFWORDS, NULL);
+	Flash_Flush();
+	eeemu_Init();
+	const Config_t version0 = configOf(200 + JOURNAL_RECORDS - 1);
+	CHECK(memcmp(eeemuGetConfig(), &version0, sizeof(version0)) == 0);
+	CHECK_EQ(eeemuStats.configErases[0], pageErases);
+	CHECK(checkSwap(page) == other);
+
+	/* Both pages are erased for the comparison, as they leave the factory */
+	Flash_Erase(page, NULL);
+	Flash_Erase(other, NULL);
+	Flash_Flush();
+}
+
+int main(void)
+{
+	uint32_t before[MAX_PAGES] = {0};
+	Flash_Init();
+	Crc_Init();
+	testMigration();
+	/* Flash leaves the factory erased, the first config is written at the factory too */
+	Flash_Erase(oldPage, NULL);
+	Flash_Erase(widePage, NULL);
+	Flash_Flush();
+	eeemu_Init();
+	singleInit(&oldStore);
+	singleInit(&wideStore);
+	const Config_t first = configOf(WRITES);
+	eeemu_write(&first);
+	singleWrite(&oldStore, &first);
+	singleWrite(&wideStore, &first);
+	Flash_Flush();
+	const uint32_t configErases = eeemuStats.configErases[0] + eeemuStats.configErases[1];
+	for (uint8_t i = 0; Host_GetFlashPage(i) != NULL; i++)
+	{
+		before[i] = Host_GetFlashPage(i)->erases;
+	}
+	for (uint32_t i = 0; i < WRITES; i++)
+	{
+		const Config_t conf = configOf(i);
+		eeemu_write(&conf);
+		singleWrite(&oldStore, &conf);
+		singleWrite(&wideStore, &conf);
+		Flash_Flush();
+		eeemu_Init();
+		singleInit(&oldStore);
+		singleInit(&wideStore);
+		CHECK(memcmp(eeemuGetConfig(), &conf, sizeof(conf)) == 0);
+	}
+	CHECK_EQ(eeemuStats.failedJobs, 0);
+	CHECK_EQ(Host_GetFlashErrors(), 0);
+
+	/* Every page erased by the loop but the single page ones is a journal page */
+	uint32_t journal[2] = {0};
+	uint8_t journalPages = 0;
+	uint32_t oldErases = 0;
+	uint32_t wideErases = 0;
+	for (uint8_t i = 0; Host_GetFlashPage(i) != NULL; i++)
+	{
+		const uint32_t erases = Host_GetFlashPage(i)->erases - before[i];
+		if (Host_GetFlashPage(i)->page == oldPage)
+		{
+			oldErases = erases;
+		}
+		else if (Host_GetFlashPage(i)->page == widePage)
+		{
+			wideErases = erases;
+		}
+		else if (erases != 0 && journalPages < 2)
+		{
+			journal[journalPages++] = erases;
+		}
+	}
+	CHECK_EQ(journalPages, 2);
+	CHECK_EQ(journal[0] + journal[1], eeemuStats.configErases[0] + eeemuStats.configErases[1] - configErases);
+	/* A swap is one erase, the pages take turns */
+	CHECK_EQ(journal[0] + journal[1], WRITES / (JOURNAL_RECORDS - 1));
+	CHECK(journal[0] + 1 >= journal[1] && journal[1] + 1 >= journal[0]);
+	CHECK_EQ(wideErases, WRITES / elements(&wideStore));
+	CHECK(journal[0] < oldErases && journal[1] < oldErases);
+	printf("{\"store\":\"single_page\",\"element_bytes\":%u,\"writes\":%u,\"page_erases\":[%u]}\n",
+			OLD_HALFWORDS * 2u, WRITES, (unsigned)oldErases);
+	printf("{\"store\":\"single_page\",\"element_bytes\":%u,\"writes\":%u,\"page_erases\":[%u]}\n",
+			NEW_HALFWORDS * 2u, WRITES, (unsigned)wideErases);
+	printf("{\"store\":\"journal\",\"element_bytes\":%u,\"writes\":%u,\"page_erases\":[%u,%u]}\n",
+			NEW_HALFWORDS * 2u, WRITES, (unsigned)journal[0], (unsigned)journal[1]);
+
+	/* Boot with the single page full: it checks every element, the journal checks one record */
+	while (oldStore.next < elements(&oldStore))
+	{
+		const Config_t conf = configOf(oldStore.next);
+		singleWrite(&oldStore, &conf);
+		Flash_Flush();
+	}
+	const double oldNs = timeBoot(oldInit);
+	const double journalNs = timeBoot(eeemu_Init);
+	CHECK(journalNs < oldNs);
+	printf("{\"store\":\"single_page\",\"element_bytes\":%u,\"boot_ns\":%.0f}\n", OLD_HALFWORDS * 2u, oldNs);
+	printf("{\"store\":\"journal\",\"element_bytes\":%u,\"boot_ns\":%.0f}\n", NEW_HALFWORDS * 2u, journalNs);
+	return TEST_RESULT;
+}
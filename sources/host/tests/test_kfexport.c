@@ -0,0 +1,96 @@
+/**
+ * @file test_kfexport.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the keyframe exporter by a round trip: frames of a mode are exported to a stream, the stream is played
+ * by the keyframe player and its frames must be the same with the same times. Every mode runs in its own process
+ */
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_test.h"
+#include "keyframe_export.h"
+#include "keyframe.h"
+#include "sim.h"
+#include "clock.h"
+#include "host.h"
+
+enum
+{
+	RUN_MS = 120000,           /**< Exported time */
+	PLAY_START = 1000000,      /**< Tick when the stream playback starts */
+	STREAM_SIZE = 64 * 1024    /**< Stream buffer size */
+};
+
+static Kfx_Capture_t exported;
+static Kfx_Capture_t played;
+static uint8_t stream[STREAM_SIZE];
+
+/**
+ * @brief Exports the mode and plays it back
+ * @param mode mode
+ * @return test result
+ */
+static int roundTrip(const Working_Mode_t mode)
+{
+	const Config_t conf = Sim_DefaultConfig(mode);
+	Host_SetTicks(0);
+	Kfx_Start(&exported, conf.brightness);
+	Sim_Boot(&conf, 0x1234, 0);
+	while (GetTicksCounter() < RUN_MS)
+	{
+		Sim_Iteration();
+	}
+	Kfx_Stop();
+	printf("%s: ", Sim_ModeName(mode));
+	CHECK_STR(exported.error, "");
+	CHECK(exported.n > 1);
+	const uint32_t size = Kfx_Encode(&exported, stream, sizeof(stream));
+	CHECK(size != 0);
+	CHECK_EQ(stream[size - 1], KF_END);
+
+	Host_SetTicks(PLAY_START);
+	Kfx_Start(&played, conf.brightness);
+	Keyframe_Player_t player;
+	Keyframe_Start(&player, stream, BLACK, NULL, PLAY_START);
+	for (uint32_t i = 0; i < exported.n; i++)
+	{
+		Host_SetTicks(PLAY_START + exported.frames[i].time);
+		CHECK(Keyframe_Run(&player, GetTicksCounter()) != 0);
+		sendDataToStrip();
+	}
+	Kfx_Stop();
+	CHECK_EQ(played.n, exported.n);
+	for (uint32_t i = 0; i < played.n && i < exported.n; i++)
+	{
+		CHECK_EQ(played.frames[i].time - PLAY_START, exported.frames[i].time);
+		CHECK(memcmp(played.frames[i].colors, exported.frames[i].colors, KFX_ROW) == 0);
+	}
+	CHECK_EQ(Keyframe_TimeToNext(&player, GetTicksCounter()), UINT32_MAX);
+	printf("%u frames, %u bytes\n", exported.n, size);
+	return TEST_RESULT;
+}
+
+int main(void)
+{
+	static const Working_Mode_t modes[] = {MODE_PIT, MODE_SC, MODE_KART2H, MODE_PITINVITE, MODE_PIT2};
+	for (uint8_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+	{
+		int status = -1;
+		fflush(stdout);
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			const int result = roundTrip(modes[i]);
+			fflush(stdout);
+			_exit(result);
+		}
+		if (pid > 0)
+		{
+			waitpid(pid, &status, 0);
+		}
+		CHECK_EQ(status, 0);
+	}
+	return TEST_RESULT;
+}
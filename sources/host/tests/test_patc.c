@@ -0,0 +1,214 @@
+/**
+ * @file test_patc.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the pattern compiler: texts of led_control.c patterns give the same bytes as the programs built into
+ * led_control.c, every program of led_control.c passes the bytecode checks, the compiled program runs in the
+ * interpreter and wrong programs are rejected with the line of the error. The interpreter stops a wrong program
+ */
+#include <stdint.h>
+#include "host_test.h"
+#include "pattern_compiler.h"
+#include "pattern.h"
+#include "led_control.h"
+#include "project_conf.h"
+
+static Patc_Result_t res;
+
+/**
+ * @brief Compiles the text and compares it with the expected bytecode
+ * @param text program text
+ * @param expected bytecode
+ * @param size bytecode size
+ * @return nonzero if equal
+ */
+static uint8_t same(const char * const text, const uint8_t * const expected, const uint16_t size)
+{
+	const uint8_t ok = Patc_Compile(text, &res);
+	if (ok == 0)
+	{
+		printf("line %u: %s\n", res.line, res.error);
+	}
+	return ok != 0 && res.size == size && memcmp(res.code, expected, size) == 0;
+}
+
+/**
+ * @brief Finds the program of led_control.c
+ * @param name phase name
+ * @return the program, NULL if there is no such phase
+ */
+static const Pattern_Desc_t * builtIn(const char * const name)
+{
+	uint8_t n;
+	const Pattern_Desc_t * const patterns = led_control_GetPatterns(&n);
+	const Pattern_Desc_t * found = NULL;
+	for (uint8_t i = 0; i < n; i++)
+	{
+		if (strcmp(patterns[i].name, name) == 0)
+		{
+			found = patterns + i;
+		}
+	}
+	return found;
+}
+
+/**
+ * @brief Compiles the text and compares it with the program of led_control.c
+ * @param text program text
+ * @param name phase name
+ * @return nonzero if equal
+ */
+static uint8_t sameAsBuiltIn(const char * const text, const char * const name)
+{
+	const Pattern_Desc_t * const desc = builtIn(name);
+	return desc != NULL && same(text, desc->prog, desc->size);
+}
+
+/**
+ * @brief Compiles a wrong program
+ * @param text program text
+ * @param line expected line of the error
+ * @param error expected error start
+ * @return nonzero if rejected as expected
+ */
+static uint8_t rejected(const char * const text, const uint16_t line, const char * const error)
+{
+	const uint8_t ok = Patc_Compile(text, &res);
+	if (ok == 0 && (res.line != line || strncmp(res.error, error, strlen(error)) != 0))
+	{
+		printf("line %u: %s\n", res.line, res.error);
+	}
+	return ok == 0 && res.line == line && strncmp(res.error, error, strlen(error)) == 0;
+}
+
+int main(void)
+{
+	CHECK(sameAsBuiltIn(
+			"# 5-4-3-2-1 red strips\n"
+			"set 5\n"
+			"loop 0\n"
+			"    strips RED\n"
+			"    wait 1000\n"
+			"    dec 0\n"
+			"next\n", "tlight"));
+	CHECK(sameAsBuiltIn(
+			"const S = 1000\r\n"
+			"loop 0\r\n"
+			"\tfill BLACK\r\n"
+			"\tdots ROW0|MIRROR, RED, 29, 29 + 6, 2\r\n"
+			"\twait S/2\r\n"
+			"\tfill BLACK\r\n"
+			"\tdots ROW1 | MIRROR, RED, 29, 29 + 6, 2\r\n"
+			"\twait S / 2 # half a second\r\n"
+			"next", "ironB30"));
+	CHECK(builtIn("noSuchPhase") == NULL);
+
+	/* Every program of led_control.c is right for the interpreter */
+	uint8_t npatterns;
+	const Pattern_Desc_t * const patterns = led_control_GetPatterns(&npatterns);
+	CHECK(npatterns != 0);
+	for (uint8_t i = 0; i < npatterns; i++)
+	{
+		if (Patc_Check(patterns[i].prog, patterns[i].size, &res) == 0)
+		{
+			printf("%s op %u: %s\n", patterns[i].name, res.line, res.error);
+			CHECK(0);
+		}
+		CHECK_EQ(res.size, patterns[i].size);
+	}
+
+	/* Expressions, NLEDS and a finite loop */
+	static const uint8_t head[] =
+	{
+		PAT_SET(1),
+		PAT_LOOP(3),
+			PAT_FILL(BLACK),
+			PAT_DOTS(PAT_DOTS_ROWS | PAT_DOTS_FROM_N | PAT_DOTS_TO_N | PAT_DOTS_NEG_N, GREEN, NLEDS / 2 - 1, NLEDS / 2, 1),
+			PAT_POWER, PAT_WAIT(350 + 50),
+			PAT_INC(58),
+		PAT_NEXT,
+		PAT_STRIP(BLUE10, 4),
+		PAT_END
+	};
+	CHECK(same(
+			"const on = 350\n"
+			"const off = (on + 50) * 2 - on - 50\n"
+			"set 1\n"
+			"loop 3\n"
+			"  fill BLACK\n"
+			"  dots ROWS|FROM_N|TO_N|NEG_N, GREEN, NLEDS/2 - 1, NLEDS/2, 1\n"
+			"  power\n"
+			"  wait off\n"
+			"  inc 58\n"
+			"next\n"
+			"strip BLUE10, 4\n"
+			"end\n", head, sizeof(head)));
+
+	/* The compiled program runs */
+	Pattern_t p;
+	CHECK(Patc_Compile("set 5\nloop 0\n strips RED\n wait 1000\n dec 0\nnext\n", &res) != 0);
+	Pattern_Start(&p, res.code, NULL, 0);
+	CHECK(Pattern_Run(&p, 0) != 0);
+	CHECK_EQ(p.n, 5);
+	CHECK_EQ(Pattern_TimeToWake(&p, 0), 1000);
+	CHECK(Pattern_Run(&p, 1000) != 0);
+	CHECK_EQ(p.n, 4);
+
+	/* A loop nested too deep is rejected by the bytecode check and stops the interpreter before its body */
+	static const uint8_t deep[] =
+	{
+		PAT_LOOP(2),
+			PAT_LOOP(2),
+				PAT_LOOP(2),
+					PAT_FILL(RED), PAT_WAIT(10),
+				PAT_NEXT,
+			PAT_NEXT,
+		PAT_NEXT,
+		PAT_END
+	};
+	CHECK(Patc_Check(deep, sizeof(deep), &res) == 0);
+	CHECK_EQ(res.line, 3);
+	CHECK(strncmp(res.error, "loops are nested deeper", strlen("loops are nested deeper")) == 0);
+	Pattern_Start(&p, deep, NULL, 0);
+	CHECK(Pattern_Run(&p, 0) == 0);
+	CHECK(p.fault != 0);
+	CHECK_EQ(p.pc, 4);
+	CHECK_EQ(Pattern_TimeToWake(&p, 0), UINT32_MAX);
+	CHECK(Pattern_Run(&p, 1000) == 0);
+
+	static const uint8_t orphanNext[] = {PAT_FILL(RED), PAT_NEXT, PAT_END};
+	CHECK(Patc_Check(orphanNext, sizeof(orphanNext), &res) == 0);
+	CHECK_EQ(res.line, 2);
+	Pattern_Start(&p, orphanNext, NULL, 0);
+	CHECK(Pattern_Run(&p, 0) != 0);
+	CHECK(p.fault != 0);
+
+	static const uint8_t unknownOp[] = {0xEE, PAT_END};
+	CHECK(Patc_Check(unknownOp, sizeof(unknownOp), &res) == 0);
+	Pattern_Start(&p, unknownOp, NULL, 0);
+	Pattern_Run(&p, 0);
+	CHECK(p.fault != 0);
+
+	/* The end is not a fault */
+	static const uint8_t ends[] = {PAT_FILL(RED), PAT_END};
+	Pattern_Start(&p, ends, NULL, 0);
+	Pattern_Run(&p, 0);
+	CHECK(p.fault == 0);
+
+	CHECK(rejected("fill PINK\nend\n", 1, "unknown name 'PINK'"));
+	CHECK(rejected("fill RED\nblink RED\n", 2, "unknown op 'blink'"));
+	CHECK(rejected("strip RED\nend\n", 1, "strip takes 2 arguments"));
+	CHECK(rejected("strip RED, 5\nend\n", 1, "strip 5 is out of range"));
+	CHECK(rejected("wait 70000\nend\n", 1, "time 70000 is out of range"));
+	CHECK(rejected("dots 0x40, RED, 0, 1, 1\nend\n", 1, "flags 64 is out of range"));
+	CHECK(rejected("loop 2\nloop 2\nloop 2\n", 3, "loops are nested deeper"));
+	CHECK(rejected("loop 0\n fill RED\nnext\n", 3, "endless loop without wait"));
+	CHECK(rejected("next\n", 1, "next without loop"));
+	CHECK(rejected("loop 2\n wait 10\n", 2, "loop is not closed"));
+	CHECK(rejected("fill RED\nwait 10\n", 2, "program runs past its end"));
+	CHECK(rejected("const a = 1\nconst a = 2\n", 2, "'a' is already defined"));
+	CHECK(rejected("wait 10 / (1 - 1)\nend\n", 1, "division by zero"));
+	return TEST_RESULT;
+}
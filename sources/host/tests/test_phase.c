@@ -0,0 +1,132 @@
+/**
+ * @file test_phase.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks that moving the led control run to the next phase (@ref LED_PHASE_EXACT) never makes it late, and
+ * prints for every mode the worst offset between the intended and the actual light change. The intended change is the
+ * phase deadline led control gives after a run (@ref led_control_TimeToPhase), the actual one is the first run at or
+ * after it, if the frame log has a new frame at that tick. Deadlines that do not change the light are not counted.
+ * Is built with @ref LED_PHASE_EXACT as test_phase and without it as test_phase_step, that one shows the 100ms grid.
+ * Every mode runs in its own process
+ */
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_test.h"
+#include "host.h"
+#include "sim.h"
+#include "bll.h"
+#include "clock.h"
+#include "led_control.h"
+
+enum
+{
+	TASK_LED_CONTROL = 1, /**< Led control task number */
+	STEP_MS = 100,        /**< Led control period */
+	RUN_MS = 300000,      /**< Simulated time of one mode */
+	MAX_CHANGES = RUN_MS / STEP_MS + 1 /**< Led control runs at least every step, every run is at most one change */
+};
+
+/**
+ * @brief Run that is the first one at or after a phase deadline
+ */
+typedef struct
+{
+	uint32_t tick;   /**< Tick of the run */
+	uint32_t offset; /**< Ticks from the deadline to the run */
+} Change_t;
+
+static Change_t Changes[MAX_CHANGES];
+
+/**
+ * @brief Runs one mode
+ * @param mode mode
+ * @return test result
+ */
+static int runMode(const Working_Mode_t mode)
+{
+	const Config_t conf = Sim_DefaultConfig(mode);
+	const Task_Stats_t * const lc = GetTaskStats(TASK_LED_CONTROL);
+	FILE * const log = tmpfile();
+	CHECK(log != NULL);
+	if (log == NULL)
+	{
+		return TEST_RESULT;
+	}
+	uint32_t n = 0;
+	uint32_t deadline = UINT32_MAX; /* Intended change given by the last run */
+	Sim_Boot(&conf, 0x1234, 0);
+	Sim_LogFrames(log);
+	while (GetTicksCounter() < RUN_MS)
+	{
+		const uint32_t now = GetTicksCounter();
+		const uint32_t taskDeadline = lc->Deadline;
+		Sim_Iteration();
+		if (lc->Deadline != taskDeadline) /* Led control has run, the deadline is moved before the call */
+		{
+			if (now >= deadline && n < MAX_CHANGES)
+			{
+				Changes[n].tick = now;
+				Changes[n].offset = now - deadline;
+				n++;
+			}
+			const uint32_t toPhase = led_control_TimeToPhase();
+			deadline = (toPhase != 0 && toPhase != UINT32_MAX) ? now + toPhase : UINT32_MAX;
+		}
+	}
+	Sim_LogFrames(NULL);
+
+	/* Only the runs that sent a new frame changed the light */
+	uint32_t maxOffset = 0;
+	uint32_t changes = 0;
+	unsigned tick;
+	unsigned hash;
+	uint32_t i = 0;
+	rewind(log);
+	while (fscanf(log, "%u %x", &tick, &hash) == 2)
+	{
+		while (i < n && Changes[i].tick < tick)
+		{
+			i++;
+		}
+		if (i < n && Changes[i].tick == tick)
+		{
+			maxOffset = (Changes[i].offset > maxOffset) ? Changes[i].offset : maxOffset;
+			changes++;
+		}
+	}
+	fclose(log);
+	printf("{\"mode\":\"%s\",\"exact\":%u,\"phase_changes\":%u,\"max_offset_ms\":%u}\n", Sim_ModeName(mode),
+			(unsigned)LED_PHASE_EXACT, (unsigned)changes, (unsigned)maxOffset);
+	CHECK_EQ(lc->LateRuns, 0);
+	CHECK_EQ(lc->SkippedRuns, 0);
+#if LED_PHASE_EXACT
+	CHECK_EQ(maxOffset, 0);
+#else
+	CHECK(maxOffset < STEP_MS);
+#endif
+	return TEST_RESULT;
+}
+
+int main(void)
+{
+	for (uint8_t mode = 0; mode < MODE_TOTAL; mode++)
+	{
+		int status = -1;
+		fflush(stdout);
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			const int result = runMode((Working_Mode_t)mode);
+			fflush(stdout);
+			_exit(result);
+		}
+		if (pid > 0)
+		{
+			waitpid(pid, &status, 0);
+		}
+		CHECK_EQ(status, 0);
+	}
+	return TEST_RESULT;
+}
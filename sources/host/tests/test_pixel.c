@@ -0,0 +1,105 @@
+/**
+ * @file test_pixel.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Is built for every @ref PIXEL_FORMAT. Sends a known frame and decodes the CCR stream of the timer fake
+ * to bytes: every led must take the number of bytes of the format and send its colors in the order of the format.
+ * Without the white channel the white is mixed into the colors
+ */
+#include "host_test.h"
+#include "host.h"
+#include "rgbw.h"
+#include "timer_dma.h"
+
+enum
+{
+	STREAM_MAX = (CHANNEL_LEDS + 16) * 32, /**< CCR values kept per channel: the frame and its tail */
+	FRAME_LEDS = 3                         /**< Leds sent by every channel */
+};
+
+#if PIXEL_FORMAT == PIXEL_FORMAT_GRBW
+#define FORMAT_NAME "GRBW"
+#define WIRE(r, g, b, w) g, r, b, w
+#elif PIXEL_FORMAT == PIXEL_FORMAT_RGBW
+#define FORMAT_NAME "RGBW"
+#define WIRE(r, g, b, w) r, g, b, w
+#elif PIXEL_FORMAT == PIXEL_FORMAT_GRB
+#define FORMAT_NAME "GRB"
+#define WIRE(r, g, b, w) g + w, r + w, b + w
+#else
+#define FORMAT_NAME "RGB"
+#define WIRE(r, g, b, w) r + w, g + w, b + w
+#endif
+
+static uint8_t Stream[STRIP_CHANNELS][STREAM_MAX]; /**< CCR values of the frame */
+static uint32_t StreamLen[STRIP_CHANNELS];
+
+static void keepWave(const uint8_t ch, const uint8_t * const ccr, const uint16_t n)
+{
+	for (uint16_t i = 0; i < n && StreamLen[ch] < STREAM_MAX; i++)
+	{
+		Stream[ch][StreamLen[ch]++] = ccr[i];
+	}
+}
+
+int main(void)
+{
+	/* Every color of every led differs, white is small enough not to saturate the rgb formats */
+	static const Led_t Sent[FRAME_LEDS] =
+	{
+			LED_INIT(0x11, 0x22, 0x33, 0x04),
+			LED_INIT(0x81, 0x42, 0x24, 0x08),
+			LED_INIT(0xA0, 0x50, 0x28, 0x0C)
+	};
+	static const uint8_t Expected[] =
+	{
+			WIRE(0x11, 0x22, 0x33, 0x04),
+			WIRE(0x81, 0x42, 0x24, 0x08),
+			WIRE(0xA0, 0x50, 0x28, 0x0C)
+	};
+	static Led_t Frame[NLEDS];
+	uint16_t nleds[STRIP_CHANNELS];
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		for (uint8_t i = 0; i < FRAME_LEDS; i++)
+		{
+			Frame[ch * CHANNEL_LEDS + i] = Sent[i];
+		}
+		nleds[ch] = FRAME_LEDS;
+	}
+	CHECK_EQ(sizeof(Led_t), PIXEL_HAS_W ? 4 : 3);
+	CHECK_EQ(sizeof(Expected), FRAME_LEDS * (PIXEL_HAS_W ? 4 : 3));
+
+	tim2_Init();
+	Host_SetWaveHook(keepWave);
+	displayStrip(Frame, nleds);
+	Host_SetWaveHook(NULL);
+
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		/* Bits are pulses up to the reset, a long pulse is one */
+		uint32_t bits = 0;
+		uint8_t bytes[sizeof(Expected) + 1] = {0};
+		while (bits < StreamLen[ch] && Stream[ch][bits] != 0)
+		{
+			if (bits / 8 < sizeof(bytes))
+			{
+				bytes[bits / 8] = (uint8_t)((bytes[bits / 8] << 1) | ((Stream[ch][bits] > STRIP_BIT_TICKS / 2u) ? 1u : 0u));
+			}
+			bits++;
+		}
+		CHECK_EQ(bits, 8 * sizeof(Expected));
+		CHECK(memcmp(bytes, Expected, sizeof(Expected)) == 0);
+		printf("%s ch%u:", FORMAT_NAME, (unsigned)ch);
+		for (uint32_t i = 0; i < bits / 8; i++)
+		{
+			printf(" %02X", (unsigned)bytes[i]);
+		}
+		printf("\n");
+	}
+	/* The decoder of the fake reads the same leds */
+	CHECK(memcmp(Host_GetStrip(), Frame, sizeof(Frame)) == 0);
+	return TEST_RESULT;
+}
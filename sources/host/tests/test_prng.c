@@ -0,0 +1,207 @@
+/**
+ * @file test_prng.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the seed reservation of prng.c. The draws of a boot must be the sequence from the stored seed, the seed
+ * must be written once per @ref RESERVE draws, and the boot after must go on past the reserved value, so no value of
+ * the first boot is drawn again. The reboot keeps the flash and clears the RAM: the first boot runs in a child process
+ * and sends the seed page back, the parent puts it to its flash and boots with @ref eeemu_Init.
+ * Then a session of the ironman and pit2 modes is run and the draws and the seed writes are printed as JSON lines.
+ * The firmware before the reservation wrote the seed at every draw, so the draws are its seed writes.
+ * genRandom is wrapped at link time to count the draws
+ */
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_test.h"
+#include "host.h"
+#include "sim.h"
+#include "prng.h"
+#include "flash.h"
+
+enum
+{
+	SEED = 0x1234,          /**< Seed stored before the first boot */
+	RESERVE = 16,           /**< Draws per seed write */
+	FIRST_DRAWS = 40,       /**< Draws of the first boot */
+	SECOND_DRAWS = 40,      /**< Draws of the boot after */
+	RANGE = 0x2000,         /**< Range of the draws: a power of two up to 0x2000 gives the low bits of the value */
+	SEED_MAGIC = 0xA55E,    /**< The first halfword of the seed page */
+	PAGE_HALFWORDS = FLASH_PAGE_SIZE / sizeof(uint16_t), /**< Seed page size */
+	SESSION_MS = 60u * 60u * 1000u /**< Session time */
+};
+
+uint16_t __real_genRandom(const uint16_t min, const uint16_t max);
+uint16_t __wrap_genRandom(const uint16_t min, const uint16_t max);
+
+static uint32_t draws = 0; /**< Calls of genRandom */
+
+uint16_t __wrap_genRandom(const uint16_t min, const uint16_t max)
+{
+	draws++;
+	return __real_genRandom(min, max);
+}
+
+/**
+ * @brief The next value of the sequence of prng.c
+ * @param x value
+ * @return next value
+ */
+static uint16_t nextValue(const uint16_t x)
+{
+	return (uint16_t)((5u * x + 17u) & 0x7FFFu);
+}
+
+/**
+ * @brief Finds the seed page
+ * @return the page, NULL if it was never erased
+ */
+static volatile uint16_t * seedPage(void)
+{
+	volatile uint16_t * page = NULL;
+	for (uint8_t i = 0; Host_GetFlashPage(i) != NULL; i++)
+	{
+		page = (Host_GetFlashPage(i)->page[0] == SEED_MAGIC) ? (volatile uint16_t *)Host_GetFlashPage(i)->page : page;
+	}
+	return page;
+}
+
+/**
+ * @brief Draws the values and checks them against the sequence
+ * @param x the value before the first draw, set to the last one
+ * @param n number of draws
+ */
+static void drawSequence(uint16_t * const x, const uint8_t n)
+{
+	const uint32_t writes = eeemuStats.seedWrites;
+	for (uint8_t i = 0; i < n; i++)
+	{
+		*x = nextValue(*x);
+		CHECK_EQ(genRandom(0, RANGE - 1), *x % RANGE);
+	}
+	CHECK_EQ(eeemuStats.seedWrites - writes, (n + RESERVE - 1) / RESERVE);
+}
+
+/**
+ * @brief The first boot and the boot after
+ * @return test result
+ */
+static int testReboot(void)
+{
+	int fd[2];
+	const Config_t conf = Sim_DefaultConfig(MODE_TLIGHT);
+	Sim_Boot(&conf, SEED, 0);
+	volatile uint16_t * const page = seedPage();
+	CHECK(page != NULL);
+	CHECK(pipe(fd) == 0);
+	if (page == NULL)
+	{
+		return TEST_RESULT;
+	}
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		uint16_t raw[PAGE_HALFWORDS];
+		uint16_t x = SEED;
+		drawSequence(&x, FIRST_DRAWS);
+		Flash_Flush();
+		for (uint16_t i = 0; i < PAGE_HALFWORDS; i++)
+		{
+			raw[i] = page[i];
+		}
+		CHECK(write(fd[1], raw, sizeof(raw)) == (ssize_t)sizeof(raw));
+		fflush(stdout);
+		_exit(TEST_RESULT);
+	}
+	int status = -1;
+	uint16_t raw[PAGE_HALFWORDS];
+	CHECK(read(fd[0], raw, sizeof(raw)) == (ssize_t)sizeof(raw));
+	waitpid(pid, &status, 0);
+	CHECK_EQ(status, 0);
+	close(fd[0]);
+	close(fd[1]);
+
+	/* Reboot: the flash as the first boot left it, the RAM as at power on */
+	for (uint16_t i = 0; i < PAGE_HALFWORDS; i++)
+	{
+		page[i] = raw[i];
+	}
+	eeemu_Init();
+	/* The first boot has reserved the values up to the end of its last reservation */
+	uint16_t reserved = SEED;
+	for (uint8_t i = 0; i < (FIRST_DRAWS + RESERVE - 1) / RESERVE * RESERVE; i++)
+	{
+		reserved = nextValue(reserved);
+	}
+	CHECK_EQ(eeemuSeedGet(), reserved);
+	uint16_t x = reserved;
+	drawSequence(&x, SECOND_DRAWS);
+	/* The values of both boots are on one period of the sequence and their positions do not overlap */
+	CHECK((FIRST_DRAWS + RESERVE - 1) / RESERVE * RESERVE + SECOND_DRAWS < RANGE);
+	return TEST_RESULT;
+}
+
+/**
+ * @brief Runs a session of the mode
+ * @param mode mode
+ * @return test result
+ */
+static int testSession(const Working_Mode_t mode)
+{
+	const Config_t conf = Sim_DefaultConfig(mode);
+	Sim_Boot(&conf, SEED, 0);
+	const uint32_t writes = eeemuStats.seedWrites;
+	draws = 0;
+	Sim_Run(SESSION_MS, NULL, 0, NULL);
+	const uint32_t seedWrites = eeemuStats.seedWrites - writes;
+	printf("{\"mode\":\"%s\",\"minutes\":%u,\"draws\":%u,\"seed_writes_before\":%u,\"seed_writes\":%u}\n",
+			Sim_ModeName(mode), SESSION_MS / 60000u, (unsigned)draws, (unsigned)draws, (unsigned)seedWrites);
+	CHECK(draws != 0);
+	CHECK_EQ(seedWrites, (draws + RESERVE - 1) / RESERVE);
+	return TEST_RESULT;
+}
+
+/**
+ * @brief Runs the check in a child process so it starts with the initial static state
+ * @param check check
+ * @param mode mode of the session
+ * @return zero if the child succeeded
+ */
+static int inChild(int (*check)(const Working_Mode_t), const Working_Mode_t mode)
+{
+	int status = -1;
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		const int result = check(mode);
+		fflush(stdout);
+		_exit(result);
+	}
+	if (pid > 0)
+	{
+		waitpid(pid, &status, 0);
+	}
+	return status;
+}
+
+/**
+ * @brief @ref testReboot with the signature of @ref inChild
+ * @param mode not used
+ * @return test result
+ */
+static int reboot(const Working_Mode_t mode)
+{
+	(void)mode;
+	return testReboot();
+}
+
+int main(void)
+{
+	CHECK_EQ(inChild(reboot, MODE_TLIGHT), 0);
+	CHECK_EQ(inChild(testSession, MODE_IRONMAN), 0);
+	CHECK_EQ(inChild(testSession, MODE_PIT2), 0);
+	return TEST_RESULT;
+}
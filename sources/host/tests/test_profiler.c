@@ -0,0 +1,64 @@
+/**
+ * @file test_profiler.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Is built with -DPROFILING. Runs the config walk and checks the sections measured on the host: the tasks
+ * of bll.c, the systick interrupt of clock.c and the button interrupt of buttons.c. The interrupts of the hal files
+ * that are replaced by fakes are not measured. Prints the statistics as JSON lines, the cycles are host time
+ * in cpu cycles
+ */
+#include "host_test.h"
+#include "sim.h"
+#include "profiler.h"
+
+#ifndef PROFILING
+#error test_profiler must be built with -DPROFILING
+#endif
+
+enum
+{
+	SEED = 0x1234,  /**< Prng seed */
+	RUN_MS = 30000  /**< Run time, covers the edges of the config walk */
+};
+
+int main(void)
+{
+	static const char * const names[PROF_TOTAL] =
+	{
+			[PROF_TASK_HEARTBEAT] = "heartbeat",
+			[PROF_TASK_LED_CONTROL] = "led_control",
+			[PROF_ISR_SYSTICK] = "isr_systick",
+			[PROF_ISR_BUTTON] = "isr_button",
+			[PROF_ISR_ADC_DMA] = "isr_adc_dma",
+			[PROF_ISR_STRIP_DMA] = "isr_strip_dma",
+			[PROF_ISR_FLASH] = "isr_flash"
+	};
+	static const Prof_Id_t measured[] = {PROF_TASK_HEARTBEAT, PROF_TASK_LED_CONTROL, PROF_ISR_SYSTICK, PROF_ISR_BUTTON};
+
+	const Config_t conf = Sim_DefaultConfig(MODE_PIT);
+	Sim_Boot(&conf, SEED, 0);
+	Sim_Run(RUN_MS, Sim_ConfigWalk, SIM_CONFIG_WALK_EDGES, NULL);
+
+	for (uint8_t i = 0; i < sizeof(measured) / sizeof(measured[0]); i++)
+	{
+		const volatile Prof_Entry_t * const e = Profiler.entries + measured[i];
+		CHECK(e->calls != 0);
+		CHECK(e->min <= e->avg);
+		CHECK(e->avg <= e->max);
+		CHECK(e->total >= (uint64_t)e->max);
+	}
+	/* The led control renders frames, it can't take no time */
+	CHECK(Profiler.entries[PROF_TASK_LED_CONTROL].total != 0);
+	/* Most of the time is sleep */
+	CHECK(Profiler.cpuLoad < 50);
+	for (uint8_t id = 0; id < PROF_TOTAL; id++)
+	{
+		const volatile Prof_Entry_t * const e = Profiler.entries + id;
+		printf("{\"section\":\"%s\",\"calls\":%u,\"min\":%u,\"avg\":%u,\"max\":%u,\"total\":%llu}\n", names[id],
+				(unsigned)e->calls, (unsigned)e->min, (unsigned)e->avg, (unsigned)e->max, (unsigned long long)e->total);
+	}
+	printf("{\"cpu_load\":%u}\n", (unsigned)Profiler.cpuLoad);
+	return TEST_RESULT;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file test_strip.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the dirty prefix of led_strip.c: only the changed prefix of every chain is sent and the strip keeps
+ * the rest. Random pixel writes are sent as a few frames in a row, the strip decoded from the truncated streams by
+ * the timer fake must then be the same as after a full resend. Prints the bits sent against the full frames as a
+ * JSON line. Is built for both @ref STRIP_LAYOUT
+ */
+#include "host_test.h"
+#include "host.h"
+#include "led_strip.h"
+#include "timer_dma.h"
+#include "project_conf.h"
+
+enum
+{
+	BATCHES = 2000,   /**< Full resends checked */
+	BATCH_FRAMES = 5, /**< Frames sent before the full resend */
+	MAX_OPS = 6,      /**< Maximal pixel writes per frame */
+	FULL_BITS = CHANNEL_LEDS * sizeof(Led_t) * 8 /**< Bits of a full frame of a channel */
+};
+
+static uint32_t sentBits[STRIP_CHANNELS]; /**< Data bits sent since the last frame */
+static uint32_t rnd = 12345;              /**< State of the random writes */
+
+/**
+ * @brief Wave hook of the strip fake, counts the data bits. A zero CCR is the reset
+ * @param ch channel
+ * @param ccr CCR values
+ * @param n number of values
+ */
+static void countBits(const uint8_t ch, const uint8_t * const ccr, const uint16_t n)
+{
+	for (uint16_t i = 0; i < n; i++)
+	{
+		sentBits[ch] += (ccr[i] != 0);
+	}
+}
+
+/**
+ * @brief Random number
+ * @param n range
+ * @return number in [0..n)
+ */
+static uint32_t random(const uint32_t n)
+{
+	rnd = rnd * 1103515245u + 12345u;
+	return (rnd >> 16) % n;
+}
+
+/**
+ * @brief Random pixel write. Single pixels near the chain start or its end are the most of them
+ */
+static void randomWrite(void)
+{
+	const Colors_t color = (Colors_t)random(BLUE10 + 1);
+	const uint32_t op = random(20);
+	if (op < 16)
+	{
+		putPixel((uint8_t)random(2), (uint8_t)random(NLEDS / 2), color);
+	}
+	else if (op < 18)
+	{
+		put2pixels(color, (uint8_t)random(NLEDS / 2));
+	}
+	else if (op < 19)
+	{
+		dispStrips(color, (uint8_t)random(6));
+	}
+	else
+	{
+		showFull(color);
+	}
+}
+
+int main(void)
+{
+	static Led_t Shown[NLEDS];
+	uint32_t frames = 0;
+	uint32_t truncated = 0;
+	uint64_t bits = 0;
+	tim2_Init();
+	setBrightness(MAX_BRIGHNESS_LEVELS - 1);
+	Host_SetWaveHook(countBits);
+	sendDataToStrip(); /* The first frame is sent full */
+	for (uint32_t batch = 0; batch < BATCHES; batch++)
+	{
+		for (uint8_t f = 0; f < BATCH_FRAMES; f++)
+		{
+			const uint32_t ops = 1 + random(MAX_OPS);
+			for (uint32_t i = 0; i < ops; i++)
+			{
+				randomWrite();
+			}
+			memset(sentBits, 0, sizeof(sentBits));
+			sendDataToStrip();
+			uint32_t most = 0;
+			for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+			{
+				CHECK_EQ(sentBits[ch] % (8 * sizeof(Led_t)), 0);
+				most = (sentBits[ch] > most) ? sentBits[ch] : most;
+				bits += sentBits[ch];
+			}
+			frames += (most != 0);
+			truncated += (most != 0 && most < FULL_BITS);
+		}
+		memcpy(Shown, Host_GetStrip(), sizeof(Shown));
+		/* The full resend is forced by the refresh timer */
+		Host_Advance(STRIP_REFRESH_MS);
+		memset(sentBits, 0, sizeof(sentBits));
+		refreshStrip();
+		for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+		{
+			CHECK_EQ(sentBits[ch], FULL_BITS);
+		}
+		CHECK(memcmp(Shown, Host_GetStrip(), sizeof(Shown)) == 0);
+	}
+	Host_SetWaveHook(NULL);
+	CHECK(truncated != 0);
+	printf("{\"layout\":\"%s\",\"frames\":%u,\"truncated_frames\":%u,\"bits_per_frame\":%u,\"full_frame_bits\":%u}\n",
+			(STRIP_LAYOUT == STRIP_LAYOUT_PARALLEL) ? "parallel" : "serial", (unsigned)frames, (unsigned)truncated,
+			(unsigned)((frames != 0) ? bits / frames : 0), (unsigned)(FULL_BITS * STRIP_CHANNELS));
+	return TEST_RESULT;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file test_timewarp.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Checks the virtual clock runner. The frames of every mode must be the same with the same ticks as when the
+ * main loop is woken every ms like by SysTick, and the whole MODE_KART2H race must take seconds.
+ * Every run is done in its own process
+ */
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_test.h"
+#include "sim.h"
+#include "clock.h"
+#include "host.h"
+
+enum
+{
+	COMPARE_MS = 300000,                 /**< Time compared with the ms stepping */
+	K2H_END_MS = 6245000,                /**< End of the MODE_KART2H timeline: 84 min start + 10 min + 605 s */
+	K2H_RUN_MS = 105u * 60u * 1000u,     /**< Whole race run */
+	K2H_WALL_MS = 5000,                  /**< Host time limit of the race run */
+	LOG_SIZE = 256 * 1024                /**< Log buffer size */
+};
+
+static char jumpLog[LOG_SIZE];
+static char stepLog[LOG_SIZE];
+
+/**
+ * @brief Runs the mode in a child process and logs its frames
+ * @param mode mode
+ * @param step nonzero to wake the main loop every ms, zero to jump to the next task
+ * @param buf log buffer
+ * @return nonzero if the log was read
+ */
+static uint8_t runLogged(const Working_Mode_t mode, const uint8_t step, char * const buf)
+{
+	FILE * const log = tmpfile();
+	if (log == NULL)
+	{
+		return 0;
+	}
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		const Config_t conf = Sim_DefaultConfig(mode);
+		Sim_Boot(&conf, 0x1234, 0);
+		Sim_LogFrames(log);
+		if (step != 0)
+		{
+			while (GetTicksCounter() < COMPARE_MS)
+			{
+				Sim_LoopBody();
+				Host_Advance(1);
+			}
+		}
+		else
+		{
+			Sim_Run(COMPARE_MS, NULL, 0, NULL);
+		}
+		fflush(log);
+		_exit(0);
+	}
+	int status = 1;
+	waitpid(pid, &status, 0);
+	rewind(log);
+	const size_t n = fread(buf, 1, LOG_SIZE - 1, log);
+	buf[n] = 0;
+	fclose(log);
+	return (status == 0 && n > 0 && n < LOG_SIZE - 1) ? !0 : 0;
+}
+
+/**
+ * @brief Runs the whole race
+ * @return test result
+ */
+static int k2hRace(void)
+{
+	const Config_t conf = Sim_DefaultConfig(MODE_KART2H);
+	Sim_Stats_t stats = {0};
+	Sim_Boot(&conf, 0x1234, 0);
+	Sim_Run(K2H_END_MS, NULL, 0, &stats);
+	const uint32_t raceFrames = stats.frames;
+	Sim_Run(K2H_RUN_MS, NULL, 0, &stats);
+	printf("MODE_KART2H: %u ms in %u host ms, %u frames, %u iterations\n", (unsigned)GetTicksCounter(),
+			(unsigned)(stats.wallNs / 1000000u), (unsigned)stats.frames, (unsigned)stats.iterations);
+	CHECK_EQ(GetTicksCounter(), K2H_RUN_MS);
+	CHECK(stats.wallNs < K2H_WALL_MS * 1000000ull);
+	CHECK(raceFrames > K2H_END_MS / 1000u);
+	CHECK(stats.frames > raceFrames);
+	CHECK(stats.iterations < K2H_RUN_MS / 10u);
+	fflush(stdout);
+	return TEST_RESULT;
+}
+
+int main(void)
+{
+	for (uint8_t m = MODE_PIT; m <= MODE_PIT2; m++)
+	{
+		const Working_Mode_t mode = (Working_Mode_t)m;
+		const uint8_t jumped = runLogged(mode, 0, jumpLog);
+		const uint8_t stepped = runLogged(mode, !0, stepLog);
+		printf("%s: ", Sim_ModeName(mode));
+		CHECK(jumped != 0);
+		CHECK(stepped != 0);
+		CHECK(strcmp(jumpLog, stepLog) == 0);
+		printf("done\n");
+	}
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		_exit(k2hRace());
+	}
+	int status = 1;
+	waitpid(pid, &status, 0);
+	CHECK_EQ(status, 0);
+	return TEST_RESULT;
+}
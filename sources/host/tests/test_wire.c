@@ -0,0 +1,212 @@
+/**
+ * @file test_wire.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Measures the strip waveform made by rgbw.c from the CCR stream of the timer fake: the high and low times
+ * of every bit and the reset pulse after the frame are checked against the datasheet window of the strip of
+ * @ref PIXEL_FORMAT. The deviations of the timing the strips are run with are listed in @ref Windows, a measured width
+ * must be in the window or be the listed one. Prints the widths, the wire rate and the encoder rate on the host
+ * as a JSON line
+ */
+#include <time.h>
+#include "host_test.h"
+#include "host.h"
+#include "rgbw.h"
+#include "timer_dma.h"
+
+enum
+{
+	STREAM_MAX = (CHANNEL_LEDS + 16) * 8 * sizeof(Led_t), /**< CCR values kept per channel: the frame and its tail */
+	ENCODE_FRAMES = 2000 /**< Frames of the encoder rate run */
+};
+
+/**
+ * @brief Measured widths
+ */
+typedef enum
+{
+	W_T0H = 0,
+	W_T1H,
+	W_T0L,
+	W_T1L,
+	W_TOTAL
+} Width_t;
+
+/**
+ * @brief Datasheet window of a width
+ */
+typedef struct
+{
+	const char * name; /**< JSON name */
+	uint32_t ns;       /**< Datasheet value */
+	uint32_t knownNs;  /**< The width the strips are run with if it's out of the window, 0 otherwise */
+} Window_t;
+
+#define TOL_NS 150u /**< Datasheet tolerance of every width */
+
+#if PIXEL_HAS_W
+/* SK6812 */
+static const Window_t Windows[W_TOTAL] =
+{
+		[W_T0H] = {"t0h", 300, 0},
+		[W_T1H] = {"t1h", 600, 1000},
+		[W_T0L] = {"t0l", 900, 0},
+		[W_T1L] = {"t1l", 600, 312}
+};
+#define RESET_NS 80000u
+#else
+/* WS2812B */
+static const Window_t Windows[W_TOTAL] =
+{
+		[W_T0H] = {"t0h", 400, 0},
+		[W_T1H] = {"t1h", 800, 1000},
+		[W_T0L] = {"t0l", 850, 0},
+		[W_T1L] = {"t1l", 450, 0}
+};
+#define RESET_NS 50000u
+#endif
+
+static uint8_t Stream[STRIP_CHANNELS][STREAM_MAX]; /**< CCR values of the last frame */
+static uint32_t StreamLen[STRIP_CHANNELS];
+
+static void keepWave(const uint8_t ch, const uint8_t * const ccr, const uint16_t n)
+{
+	for (uint16_t i = 0; i < n && StreamLen[ch] < STREAM_MAX; i++)
+	{
+		Stream[ch][StreamLen[ch]++] = ccr[i];
+	}
+}
+
+/**
+ * @brief Converts timer ticks to ns
+ * @param ticks ticks
+ * @return ns
+ */
+static uint32_t ticksNs(const uint32_t ticks)
+{
+	return (uint32_t)(((uint64_t)ticks * 1000000000u) / STRIP_TIMER_CLOCK_HZ);
+}
+
+/**
+ * @brief Host monotonic time
+ * @return ns
+ */
+static uint64_t wallNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int main(void)
+{
+	static Led_t Frame[NLEDS];
+	const uint8_t * const bytes = (const uint8_t *)Frame;
+	/* Every byte value, so every pair of neighbour bits is sent */
+	for (uint32_t i = 0; i < sizeof(Frame); i++)
+	{
+		((uint8_t *)Frame)[i] = (uint8_t)(i * 37u + 1u);
+	}
+	uint16_t nleds[STRIP_CHANNELS];
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		nleds[ch] = CHANNEL_LEDS;
+	}
+	tim2_Init();
+	Host_SetWaveHook(keepWave);
+	displayStrip(Frame, nleds);
+	Host_SetWaveHook(NULL);
+
+	uint32_t minNs[W_TOTAL];
+	uint32_t maxNs[W_TOTAL] = {0};
+	for (uint8_t w = 0; w < W_TOTAL; w++)
+	{
+		minNs[w] = UINT32_MAX;
+	}
+	uint32_t resetNs = 0;
+	uint32_t frameTicks = 0;
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		const uint8_t * const ccr = Stream[ch];
+		const uint8_t * const sent = bytes + ch * CHANNEL_LEDS * sizeof(Led_t);
+		const uint32_t bits = CHANNEL_LEDS * 8u * sizeof(Led_t);
+		/* The frame starts at once and every bit is one pulse */
+		for (uint32_t i = 0; i < bits; i++)
+		{
+			CHECK(ccr[i] != 0);
+		}
+		CHECK(StreamLen[ch] > bits);
+		for (uint32_t i = 0; i < bits; i++)
+		{
+			const uint8_t one = (sent[i / 8] >> (7 - i % 8)) & 1u;
+			uint32_t low = STRIP_BIT_TICKS - ccr[i];
+			uint32_t zeros = 0;
+			while (i + 1 + zeros < StreamLen[ch] && ccr[i + 1 + zeros] == 0)
+			{
+				zeros++;
+			}
+			const Width_t high = (one != 0) ? W_T1H : W_T0H;
+			const uint32_t highNs = ticksNs(ccr[i]);
+			minNs[high] = (highNs < minNs[high]) ? highNs : minNs[high];
+			maxNs[high] = (highNs > maxNs[high]) ? highNs : maxNs[high];
+			if (i + 1 < bits)
+			{
+				/* No gaps inside the frame */
+				CHECK_EQ(zeros, 0);
+				const Width_t w = (one != 0) ? W_T1L : W_T0L;
+				const uint32_t lowNs = ticksNs(low);
+				minNs[w] = (lowNs < minNs[w]) ? lowNs : minNs[w];
+				maxNs[w] = (lowNs > maxNs[w]) ? lowNs : maxNs[w];
+			}
+			else
+			{
+				/* The low time after the last bit is the reset pulse. The stream ends after it */
+				low += zeros * STRIP_BIT_TICKS;
+				CHECK_EQ(i + 1 + zeros, StreamLen[ch]);
+				resetNs = ticksNs(low);
+				CHECK(resetNs >= RESET_NS);
+				frameTicks = (i + 1) * STRIP_BIT_TICKS + low - STRIP_BIT_TICKS + ccr[i];
+			}
+		}
+	}
+	for (uint8_t w = 0; w < W_TOTAL; w++)
+	{
+		const Window_t * const win = Windows + w;
+		if (win->knownNs != 0)
+		{
+			CHECK_EQ(minNs[w], win->knownNs);
+			CHECK_EQ(maxNs[w], win->knownNs);
+		}
+		else
+		{
+			CHECK(minNs[w] + TOL_NS >= win->ns);
+			CHECK(maxNs[w] <= win->ns + TOL_NS);
+		}
+	}
+	/* The decoder of the fake reads the same frame */
+	CHECK(memcmp(Host_GetStrip(), Frame, sizeof(Frame)) == 0);
+
+	/* Encoder rate: the frames are refilled half by half as the dma interrupt does it */
+	Host_StripCapture(0);
+	const uint64_t start = wallNs();
+	for (uint32_t i = 0; i < ENCODE_FRAMES; i++)
+	{
+		displayStrip(Frame, nleds);
+	}
+	const uint64_t encodeNs = wallNs() - start;
+	Host_StripCapture(!0);
+
+	printf("{\"pixel_format\":%u,\"bit_ns\":%u", (unsigned)PIXEL_FORMAT, (unsigned)ticksNs(STRIP_BIT_TICKS));
+	for (uint8_t w = 0; w < W_TOTAL; w++)
+	{
+		printf(",\"%s_ns\":[%u,%u],\"%s_window\":[%u,%u]", Windows[w].name, (unsigned)minNs[w], (unsigned)maxNs[w],
+				Windows[w].name, (unsigned)(Windows[w].ns - TOL_NS), (unsigned)(Windows[w].ns + TOL_NS));
+	}
+	printf(",\"reset_ns\":%u,\"frame_us\":%u,\"wire_leds_per_s\":%.0f,\"encode_leds_per_s\":%.0f}\n",
+			(unsigned)resetNs, (unsigned)(ticksNs(frameTicks) / 1000u),
+			(double)CHANNEL_LEDS * STRIP_TIMER_CLOCK_HZ / frameTicks * STRIP_CHANNELS,
+			(encodeNs != 0) ? (double)NLEDS * ENCODE_FRAMES * 1e9 / (double)encodeNs : 0.0);
+	return TEST_RESULT;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file frame_diff.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the comparison of two frame logs
+ */
+#include "frame_diff.h"
+
+enum
+{
+	LINE_LEN = 128 /**< Maximal log line length */
+};
+
+/**
+ * @brief Log frame
+ */
+typedef struct
+{
+	uint32_t time; /**< Tick */
+	uint32_t hash; /**< Strip hash */
+} Frame_t;
+
+/**
+ * @brief Reads the next frame, comments and empty lines are skipped
+ * @param log log
+ * @param frame the frame
+ * @return zero at the end of the log or on a line that isn't a frame
+ */
+static uint8_t nextFrame(FILE * const log, Frame_t * const frame)
+{
+	char line[LINE_LEN];
+	uint8_t read = 0;
+	while (read == 0 && fgets(line, sizeof(line), log) != NULL)
+	{
+		if (line[0] != '#' && line[0] != '\n')
+		{
+			unsigned time;
+			unsigned hash;
+			if (sscanf(line, "%u %x", &time, &hash) != 2)
+			{
+				break;
+			}
+			frame->time = time;
+			frame->hash = hash;
+			read = !0;
+		}
+	}
+	return read;
+}
+
+uint8_t Fdiff_First(FILE * const expected, FILE * const actual, char * const report)
+{
+	Frame_t last = {0};
+	uint32_t n = 0;
+	uint8_t differ = 0;
+	report[0] = 0;
+	while (differ == 0)
+	{
+		Frame_t e;
+		Frame_t a;
+		const uint8_t hasE = nextFrame(expected, &e);
+		const uint8_t hasA = nextFrame(actual, &a);
+		int len = 0;
+		if (hasE == 0 && hasA == 0)
+		{
+			break;
+		}
+		differ = !0;
+		if (hasE == 0)
+		{
+			len = snprintf(report, FDIFF_REPORT_LEN, "frame %u: unexpected %u ms %08x after the end of the expected log",
+					(unsigned)n, (unsigned)a.time, (unsigned)a.hash);
+		}
+		else if (hasA == 0)
+		{
+			len = snprintf(report, FDIFF_REPORT_LEN, "frame %u: expected %u ms %08x, the actual log ended",
+					(unsigned)n, (unsigned)e.time, (unsigned)e.hash);
+		}
+		else if (e.time != a.time || e.hash != a.hash)
+		{
+			len = snprintf(report, FDIFF_REPORT_LEN, "frame %u: expected %u ms %08x, got %u ms %08x",
+					(unsigned)n, (unsigned)e.time, (unsigned)e.hash, (unsigned)a.time, (unsigned)a.hash);
+		}
+		else
+		{
+			last = e;
+			n++;
+			differ = 0;
+		}
+		if (differ != 0 && n != 0 && len > 0 && len < FDIFF_REPORT_LEN)
+		{
+			snprintf(report + len, (size_t)(FDIFF_REPORT_LEN - len), " (last common frame %u ms %08x)",
+					(unsigned)last.time, (unsigned)last.hash);
+		}
+	}
+	return differ;
+}
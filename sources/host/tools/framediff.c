@@ -0,0 +1,42 @@
+/**
+ * @file framediff.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Frame log diff. Prints the first divergent frame of two logs written by timewarp -f or golden.
+ * Usage: framediff expected actual
+ * The exit code is 0 if the logs are the same, 1 if they differ
+ */
+#include "frame_diff.h"
+
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s expected actual\n", argv[0]);
+		return 2;
+	}
+	FILE * const expected = fopen(argv[1], "r");
+	if (expected == NULL)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+	FILE * const actual = fopen(argv[2], "r");
+	if (actual == NULL)
+	{
+		perror(argv[2]);
+		fclose(expected);
+		return 2;
+	}
+	char report[FDIFF_REPORT_LEN];
+	const uint8_t differ = Fdiff_First(expected, actual, report);
+	fclose(expected);
+	fclose(actual);
+	if (differ != 0)
+	{
+		printf("%s\n", report);
+	}
+	return (differ != 0) ? 1 : 0;
+}
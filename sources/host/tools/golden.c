@@ -0,0 +1,207 @@
+/**
+ * @file golden.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Golden frame runner. Every scenario boots the firmware with a fixed seed, plays its button script and logs
+ * the frames with their ticks (see @ref Sim_LogFrames). The logs are compared with the corpus, the first divergent
+ * frame of every scenario that differs is printed.
+ * Usage: golden [-u] corpus_dir [scenario...]
+ * -u writes the corpus instead of checking it. Without scenario names all the scenarios are run.
+ * The corpus is of the rgbw pixel formats: without the white channel the colors are mixed into rgb, so the frames
+ * can't be compared and golden exits with @ref SKIPPED
+ */
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "frame_diff.h"
+#include "sim.h"
+#include "project_conf.h"
+
+enum
+{
+	SEED = 0x1234,                  /**< Prng seed of all the scenarios */
+	MODE_RUN_MS = 600000,           /**< Run time of a mode */
+	K2H_RUN_MS = 105u * 60u * 1000u,/**< Run time of MODE_KART2H, the whole race */
+	CONFIG_RUN_MS = 240000,         /**< Run time of a config walk */
+	PATH_LEN = 512,                 /**< Maximal corpus file path length */
+	SKIPPED = 77                    /**< Exit code of a build that can't be checked, the skip code of ctest */
+};
+
+/**
+ * @brief Scenario
+ */
+typedef struct
+{
+	const char * name;            /**< Name and corpus file name */
+	Working_Mode_t mode;          /**< Mode of the stored config */
+	uint8_t pressed;              /**< Nonzero if the button is pressed at power on */
+	const Sim_Edge_t * script;    /**< Button script */
+	uint16_t n;                   /**< Number of edges */
+	uint32_t runMs;               /**< Run time */
+} Scenario_t;
+
+/**
+ * @brief Presses during a mode: a tap at 30s and a 3s long press at 60s
+ */
+static const Sim_Edge_t modeScript[] =
+{
+		{30000, !0}, {30200, 0},
+		{60000, !0}, {63000, 0}
+};
+
+/**
+ * @brief Config walk without changes: the button held at power on is released and every value times out
+ */
+static const Sim_Edge_t configIdleScript[] =
+{
+		{500, 0}
+};
+
+#define MODE_SCENARIO(mode, ms) {#mode, mode, 0, modeScript, sizeof(modeScript) / sizeof(modeScript[0]), ms}
+
+static const Scenario_t scenarios[] =
+{
+		MODE_SCENARIO(MODE_PIT, MODE_RUN_MS),
+		MODE_SCENARIO(MODE_TLIGHT, MODE_RUN_MS),
+		MODE_SCENARIO(MODE_PODNOS, MODE_RUN_MS),
+		MODE_SCENARIO(MODE_SC, MODE_RUN_MS),
+		MODE_SCENARIO(MODE_KART2H, K2H_RUN_MS),
+		MODE_SCENARIO(MODE_PITINVITE, MODE_RUN_MS),
+		MODE_SCENARIO(MODE_IRONMAN, MODE_RUN_MS),
+		MODE_SCENARIO(MODE_PIT2, MODE_RUN_MS),
+		{"CONFIG_WALK", MODE_PIT, !0, Sim_ConfigWalk, SIM_CONFIG_WALK_EDGES, CONFIG_RUN_MS},
+		{"CONFIG_IDLE", MODE_SC, !0, configIdleScript, sizeof(configIdleScript) / sizeof(configIdleScript[0]), CONFIG_RUN_MS}
+};
+
+/**
+ * @brief Runs the scenario in a child process, so it starts with the initial static state
+ * @param s scenario
+ * @param log log file
+ * @return zero if the child succeeded
+ */
+static int runScenario(const Scenario_t * const s, FILE * const log)
+{
+	fprintf(log, "# %s, seed 0x%04X, %u ms\n", s->name, SEED, (unsigned)s->runMs);
+	fflush(log);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		const Config_t conf = Sim_DefaultConfig(s->mode);
+		Sim_Boot(&conf, SEED, s->pressed);
+		Sim_LogFrames(log);
+		Sim_Run(s->runMs, s->script, s->n, NULL);
+		Sim_LogFrames(NULL);
+		fflush(log);
+		_exit(0);
+	}
+	int status = -1;
+	waitpid(pid, &status, 0);
+	return status;
+}
+
+/**
+ * @brief Runs the scenario and writes or checks its corpus file
+ * @param s scenario
+ * @param dir corpus directory
+ * @param update nonzero to write the corpus
+ * @return zero if the scenario matches the corpus or was written
+ */
+static int golden(const Scenario_t * const s, const char * const dir, const uint8_t update)
+{
+	char path[PATH_LEN];
+	snprintf(path, sizeof(path), "%s/%s.frames", dir, s->name);
+	int result = 1;
+	if (update != 0)
+	{
+		FILE * const log = fopen(path, "w");
+		if (log == NULL)
+		{
+			perror(path);
+		}
+		else
+		{
+			result = runScenario(s, log);
+			fclose(log);
+			printf("%s: %s\n", s->name, (result == 0) ? "written" : "failed");
+		}
+	}
+	else
+	{
+		FILE * const expected = fopen(path, "r");
+		FILE * const actual = tmpfile();
+		if (expected == NULL)
+		{
+			perror(path);
+		}
+		else if (actual != NULL && runScenario(s, actual) == 0)
+		{
+			char report[FDIFF_REPORT_LEN];
+			rewind(actual);
+			result = (Fdiff_First(expected, actual, report) != 0) ? 1 : 0;
+			printf("%s: %s\n", s->name, (result == 0) ? "ok" : report);
+		}
+		else
+		{
+			printf("%s: the run failed\n", s->name);
+		}
+		if (expected != NULL)
+		{
+			fclose(expected);
+		}
+		if (actual != NULL)
+		{
+			fclose(actual);
+		}
+	}
+	fflush(stdout);
+	return result;
+}
+
+int main(int argc, char **argv)
+{
+	uint8_t update = 0;
+	int arg = 1;
+	if (arg < argc && strcmp(argv[arg], "-u") == 0)
+	{
+		update = !0;
+		arg++;
+	}
+	if (arg >= argc)
+	{
+		fprintf(stderr, "usage: %s [-u] corpus_dir [scenario...]\n", argv[0]);
+		return 2;
+	}
+	const char * const dir = argv[arg++];
+#if !PIXEL_HAS_W
+	printf("PIXEL_FORMAT %u has no white channel, the corpus is of the rgbw formats: skipped\n", (unsigned)PIXEL_FORMAT);
+	(void)dir;
+	(void)update;
+	return SKIPPED;
+#endif
+	int result = 0;
+	uint16_t run = 0;
+	for (uint16_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		uint8_t selected = (arg == argc) ? !0 : 0;
+		for (int j = arg; j < argc; j++)
+		{
+			if (strcmp(argv[j], scenarios[i].name) == 0)
+			{
+				selected = !0;
+			}
+		}
+		if (selected != 0)
+		{
+			result |= golden(scenarios + i, dir, update);
+			run++;
+		}
+	}
+	if (run == 0)
+	{
+		fprintf(stderr, "no such scenario\n");
+		result = 2;
+	}
+	return result;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file keyframe_export.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the keyframe exporter
+ */
+#include <stddef.h>
+#include <string.h>
+#include "keyframe_export.h"
+#include "keyframe.h"
+#include "host.h"
+#include "clock.h"
+
+enum
+{
+	NCOLORS = BLUE10 + 1, /**< Number of colors */
+	MAX_FRAME_MS = 0xFFFF /**< The longest time of one frame */
+};
+
+static const char * const ColorNames[NCOLORS] =
+{
+		[BLACK] = "BLACK", [RED] = "RED", [GREEN] = "GREEN", [BLUE] = "BLUE", [WHITE] = "WHITE",
+		[YELLOW] = "YELLOW", [MAGENTA] = "MAGENTA", [CYAN] = "CYAN", [DARK_RED] = "DARK_RED",
+		[ORANGE] = "ORANGE", [REDDER] = "REDDER", [GREEN10] = "GREEN10", [BLUE10] = "BLUE10"
+};
+
+static Kfx_Capture_t * active = NULL;
+static Led_t palette[NCOLORS];
+
+/**
+ * @brief Led index of the row pixel in @ref Host_GetStrip, the same as ledIndex of led_strip.c
+ * @param row row
+ * @param pos position
+ * @return index
+ */
+static uint16_t ledIndex(const uint8_t row, const uint8_t pos)
+{
+#if STRIP_LAYOUT == STRIP_LAYOUT_PARALLEL
+	return (row == 0) ? pos : NLEDS / 2 + pos;
+#else
+	return (row == 0) ? pos : NLEDS - pos - 1;
+#endif
+}
+
+/**
+ * @brief Finds the color of the led
+ * @param led led
+ * @return color, @ref NCOLORS if it's not in the palette
+ */
+static uint8_t findColor(const Led_t * const led)
+{
+	uint8_t c = 0;
+	while (c < NCOLORS && memcmp(palette + c, led, sizeof(Led_t)) != 0)
+	{
+		c++;
+	}
+	return c;
+}
+
+/**
+ * @brief Frame callback of the strip fake
+ * @param ch channel
+ */
+static void onFrame(const uint8_t ch)
+{
+	Kfx_Capture_t * const capture = active;
+	if (capture == NULL || capture->error[0] != 0 || ch != STRIP_CHANNELS - 1)
+	{
+		return;
+	}
+	const Led_t * const strip = Host_GetStrip();
+	Kfx_Frame_t frame = {.time = GetTicksCounter()};
+	for (uint8_t pos = 0; pos < KFX_ROW; pos++)
+	{
+		const uint8_t c0 = findColor(strip + ledIndex(0, pos));
+		const uint8_t c1 = findColor(strip + ledIndex(1, pos));
+		if (c0 == NCOLORS || c1 == NCOLORS)
+		{
+			snprintf(capture->error, sizeof(capture->error), "frame at %u ms: pixel %u is not a palette color", frame.time, pos);
+			return;
+		}
+		if (c0 != c1)
+		{
+			snprintf(capture->error, sizeof(capture->error), "frame at %u ms: rows differ at pixel %u", frame.time, pos);
+			return;
+		}
+		frame.colors[pos] = c0;
+	}
+	if (capture->n != 0 && memcmp(capture->frames[capture->n - 1].colors, frame.colors, KFX_ROW) == 0)
+	{
+		return; /* Refresh of the same picture */
+	}
+	if (capture->n == KFX_MAX_FRAMES)
+	{
+		snprintf(capture->error, sizeof(capture->error), "more than %u frames", (unsigned)KFX_MAX_FRAMES);
+		return;
+	}
+	capture->frames[capture->n++] = frame;
+}
+
+void Kfx_Start(Kfx_Capture_t * const capture, const uint8_t brightness)
+{
+	capture->n = 0;
+	capture->error[0] = 0;
+	active = NULL;
+	setBrightness(brightness);
+	for (uint8_t c = NCOLORS; c-- != 0;)
+	{
+		showFull((Colors_t)c);
+		sendDataToStrip();
+		palette[c] = Host_GetStrip()[0];
+	}
+	/* BLACK goes last so the strip is as at power on */
+	active = capture;
+	Host_SetFrameHook(onFrame);
+}
+
+void Kfx_Stop(void)
+{
+	Host_SetFrameHook(NULL);
+	active = NULL;
+}
+
+/**
+ * @brief Puts bytes to the stream
+ * @param out stream
+ * @param pos stream size, is moved
+ * @param size stream buffer size
+ * @param bytes bytes
+ * @param n number of bytes
+ * @return nonzero if they fit
+ */
+static uint8_t put(uint8_t * const out, uint32_t * const pos, const uint32_t size, const uint8_t * const bytes, const uint8_t n)
+{
+	if (*pos + n > size)
+	{
+		return 0;
+	}
+	memcpy(out + *pos, bytes, n);
+	*pos += n;
+	return !0;
+}
+
+/**
+ * @brief Puts frames of nothing that wait for the time
+ * @return nonzero if they fit
+ */
+static uint8_t putWait(uint8_t * const out, uint32_t * const pos, const uint32_t size, uint32_t ms)
+{
+	uint8_t ok = !0;
+	while (ok != 0 && ms != 0)
+	{
+		const uint32_t step = (ms > MAX_FRAME_MS) ? MAX_FRAME_MS : ms;
+		const uint8_t frame[] = {KF_FRAME(step, 0)};
+		ok = put(out, pos, size, frame, sizeof(frame));
+		ms -= step;
+	}
+	return ok;
+}
+
+uint32_t Kfx_Encode(const Kfx_Capture_t * const capture, uint8_t * const out, const uint32_t size)
+{
+	uint8_t prev[KFX_ROW] = {BLACK};
+	uint32_t pos = 0;
+	uint8_t ok = (capture->n == 0 || putWait(out, &pos, size, capture->frames[0].time));
+	for (uint32_t i = 0; ok != 0 && i < capture->n; i++)
+	{
+		const Kfx_Frame_t * const frame = capture->frames + i;
+		const uint32_t ms = (i + 1 < capture->n) ? capture->frames[i + 1].time - frame->time : 0;
+		const uint32_t header = pos;
+		const uint32_t shown = (ms > MAX_FRAME_MS) ? MAX_FRAME_MS : ms; /* The rest is waited by empty frames */
+		uint8_t nspans = 0;
+		const uint8_t head[] = {KF_FRAME(shown, 0)};
+		ok = put(out, &pos, size, head, sizeof(head));
+		for (uint8_t p = 0; ok != 0 && p < KFX_ROW;)
+		{
+			if (frame->colors[p] == prev[p])
+			{
+				p++;
+				continue;
+			}
+			uint8_t len = 1;
+			while (p + len < KFX_ROW && frame->colors[p + len] == frame->colors[p] && frame->colors[p + len] != prev[p + len])
+			{
+				len++;
+			}
+			const uint8_t span[] = {KF_SPAN(p, len, frame->colors[p])};
+			ok = put(out, &pos, size, span, sizeof(span));
+			nspans++;
+			p += len;
+		}
+		if (ok != 0)
+		{
+			out[header] = nspans;
+			memcpy(prev, frame->colors, KFX_ROW);
+			ok = putWait(out, &pos, size, ms - shown);
+		}
+	}
+	const uint8_t end = KF_END;
+	ok = ok != 0 && put(out, &pos, size, &end, 1);
+	return (ok != 0) ? pos : 0;
+}
+
+/**
+ * @brief Prints a span color
+ * @param out output file
+ * @param color color
+ */
+static void printColor(FILE * const out, const uint8_t color)
+{
+	if (color < NCOLORS)
+	{
+		fprintf(out, "%s", ColorNames[color]);
+	}
+	else
+	{
+		fprintf(out, (color == KF_COLOR_INK) ? "KF_COLOR_INK" : (color == KF_COLOR_POWER) ? "KF_COLOR_POWER" : "0x%02X", color);
+	}
+}
+
+void Kfx_PrintC(FILE * const out, const char * const name, const uint8_t * const stream, const uint32_t size)
+{
+	fprintf(out, "static const uint8_t %s[] =\n{\n", name);
+	for (uint32_t pos = 0; pos < size;)
+	{
+		const uint8_t nspans = stream[pos];
+		if (nspans == KF_SPANS_END || nspans == KF_SPANS_LOOP)
+		{
+			fprintf(out, "\t%s\n", (nspans == KF_SPANS_END) ? "KF_END" : "KF_LOOP");
+			pos++;
+			continue;
+		}
+		fprintf(out, "\tKF_FRAME(%u, %u)", (unsigned)(stream[pos + 1] | (stream[pos + 2] << 8)), nspans);
+		pos += 3;
+		for (uint8_t i = 0; i < nspans; i++, pos += 3)
+		{
+			fprintf(out, ", KF_SPAN(%u, %u, ", stream[pos], stream[pos + 1]);
+			printColor(out, stream[pos + 2]);
+			fprintf(out, ")");
+		}
+		fprintf(out, ",\n");
+	}
+	fprintf(out, "};\n");
+}
@@ -0,0 +1,83 @@
+/**
+ * @file kfexport.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Keyframe exporter. Runs a mode on the host and prints the frames it sends as a keyframe stream
+ * (a C array with KF_xxx macros). The footprint is printed to stderr as a JSON line:
+ * stream bytes and the bytes of the same frames stored as one color index per pixel.
+ * Usage: kfexport [-s seed] [-t ms] [-n name] mode
+ * mode is a @ref Working_Mode_t name (MODE_SC) or number
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "keyframe_export.h"
+#include "keyframe.h"
+#include "sim.h"
+#include "clock.h"
+#include "host.h"
+
+enum
+{
+	STREAM_SIZE = 256 * 1024 /**< Stream buffer size */
+};
+
+int main(int argc, char **argv)
+{
+	uint16_t seed = 0x1234;
+	uint32_t runMs = 120000;
+	const char * name = "stream";
+	Working_Mode_t mode = MODE_TOTAL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			seed = (uint16_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			runMs = (uint32_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			name = argv[++i];
+		}
+		else
+		{
+			mode = Sim_ParseMode(argv[i]);
+		}
+	}
+	if (mode == MODE_TOTAL)
+	{
+		fprintf(stderr, "usage: %s [-s seed] [-t ms] [-n name] mode\n", argv[0]);
+		return 2;
+	}
+	static Kfx_Capture_t capture;
+	static uint8_t stream[STREAM_SIZE];
+	const Config_t conf = Sim_DefaultConfig(mode);
+	Host_SetTicks(0);
+	Kfx_Start(&capture, conf.brightness);
+	Sim_Boot(&conf, seed, 0);
+	while (GetTicksCounter() < runMs && capture.error[0] == 0)
+	{
+		Sim_Iteration();
+	}
+	Kfx_Stop();
+	if (capture.error[0] != 0)
+	{
+		fprintf(stderr, "%s: %s\n", Sim_ModeName(mode), capture.error);
+		return 1;
+	}
+	const uint32_t size = Kfx_Encode(&capture, stream, sizeof(stream));
+	if (size == 0)
+	{
+		fprintf(stderr, "%s: the stream is longer than %u bytes\n", Sim_ModeName(mode), (unsigned)sizeof(stream));
+		return 1;
+	}
+	printf("/* %s, seed 0x%04X, %u ms, %u frames */\n", Sim_ModeName(mode), seed, runMs, capture.n);
+	Kfx_PrintC(stdout, name, stream, size);
+	fprintf(stderr, "{\"mode\":\"%s\",\"ms\":%u,\"frames\":%u,\"stream_bytes\":%u,\"frame_bytes\":%u}\n",
+			Sim_ModeName(mode), runMs, capture.n, size, capture.n * (unsigned)KFX_ROW);
+	return 0;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file lifetime.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Flash lifetime projection. The wear is measured on the NOR flash fake, not taken from the page sizes:
+ * configs and seeds are written until the pages were erased many times, the writes per erase of the most worn page
+ * give the writes to @ref FLASH_ENDURANCE. The usage is measured by the simulator: a session of the mode gives
+ * the seeds written by the prng, a config walk (@ref Sim_ConfigWalk) gives the config saves. Prints a JSON line.
+ * Usage: lifetime [-m mode] [-t minutes] [-d sessions_per_day] [-c config_walks_per_session]
+ * Every measurement runs in its own process, so it starts with the initial static state
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim.h"
+#include "flash.h"
+#include "crc.h"
+#include "host.h"
+
+enum
+{
+	CONFIG_WRITES = 2520, /**< Config saves of the wear run, 20 erases of every config page */
+	SEED_WRITES = 5090,   /**< Seed writes of the wear run, 10 erases of the seed page */
+	SEED = 0x1234,        /**< Prng seed of the sessions */
+	WALK_MS = 240000,     /**< Run time of a config walk */
+	MAX_PAGES = 8         /**< Maximal number of erased pages */
+};
+
+static Working_Mode_t mode = MODE_TLIGHT; /**< Mode of the session */
+static uint32_t sessionMs = 60u * 60u * 1000u; /**< Session length */
+
+/**
+ * @brief Returns the erases of the most worn page since the snapshot
+ * @param before erases of every page at the snapshot
+ * @return erases
+ */
+static uint32_t maxErases(const uint32_t * const before)
+{
+	uint32_t erases = 0;
+	for (uint8_t i = 0; i < MAX_PAGES && Host_GetFlashPage(i) != NULL; i++)
+	{
+		const uint32_t n = Host_GetFlashPage(i)->erases - before[i];
+		erases = (n > erases) ? n : erases;
+	}
+	return erases;
+}
+
+/**
+ * @brief Writes configs or seeds and counts the erases of the most worn page
+ * @param seeds nonzero to write seeds, configs otherwise
+ * @return writes per erase, 0 if nothing was erased
+ */
+static uint32_t writesPerErase(const uint8_t seeds)
+{
+	uint32_t before[MAX_PAGES] = {0};
+	Flash_Init();
+	Crc_Init();
+	eeemu_Init();
+	/* The first write is done by the factory, it erases the pages that were never used */
+	const Config_t first = Sim_DefaultConfig(mode);
+	eeemu_write(&first);
+	eeemuSeedSet(SEED);
+	Flash_Flush();
+	for (uint8_t i = 0; i < MAX_PAGES && Host_GetFlashPage(i) != NULL; i++)
+	{
+		before[i] = Host_GetFlashPage(i)->erases;
+	}
+	const uint32_t writes = (seeds != 0) ? SEED_WRITES : CONFIG_WRITES;
+	for (uint32_t i = 0; i < writes; i++)
+	{
+		if (seeds != 0)
+		{
+			eeemuSeedSet((uint16_t)(i & 0x7FFF));
+		}
+		else
+		{
+			Config_t conf = first;
+			conf.brightness = (uint8_t)(i % 8);
+			eeemu_write(&conf);
+		}
+		Flash_Flush();
+	}
+	const uint32_t erases = maxErases(before);
+	return (erases == 0 || eeemuStats.failedJobs != 0 || Host_GetFlashErrors() != 0) ? 0 : writes / erases;
+}
+
+/**
+ * @brief Config records per erase of the most worn config page
+ * @return records
+ */
+static uint32_t configsPerErase(void)
+{
+	return writesPerErase(0);
+}
+
+/**
+ * @brief Seeds per erase of the seed page
+ * @return seeds
+ */
+static uint32_t seedsPerErase(void)
+{
+	return writesPerErase(!0);
+}
+
+/**
+ * @brief Runs a session of the mode
+ * @return seeds written by the prng
+ */
+static uint32_t sessionSeeds(void)
+{
+	const Config_t conf = Sim_DefaultConfig(mode);
+	Sim_Boot(&conf, SEED, 0);
+	const uint32_t seeds = eeemuStats.seedWrites;
+	Sim_Run(sessionMs, NULL, 0, NULL);
+	return eeemuStats.seedWrites - seeds;
+}
+
+/**
+ * @brief Runs the config walk
+ * @return configs saved
+ */
+static uint32_t walkConfigs(void)
+{
+	const Config_t conf = Sim_DefaultConfig(MODE_PIT);
+	Sim_Boot(&conf, SEED, !0);
+	const uint32_t configs = eeemuStats.configWrites;
+	Sim_Run(WALK_MS, Sim_ConfigWalk, SIM_CONFIG_WALK_EDGES, NULL);
+	return eeemuStats.configWrites - configs;
+}
+
+/**
+ * @brief Runs the measurement in a child process
+ * @param measure measurement
+ * @param result out parameter
+ * @return nonzero if the child succeeded
+ */
+static uint8_t inChild(uint32_t (*measure)(void), uint32_t * const result)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		perror("pipe");
+		return 0;
+	}
+	fflush(stdout);
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		close(fds[0]);
+		const uint32_t value = measure();
+		_exit((write(fds[1], &value, sizeof(value)) == (ssize_t)sizeof(value)) ? 0 : 1);
+	}
+	close(fds[1]);
+	const uint8_t ok = pid > 0 && read(fds[0], result, sizeof(*result)) == (ssize_t)sizeof(*result);
+	close(fds[0]);
+	int status = -1;
+	if (pid > 0)
+	{
+		waitpid(pid, &status, 0);
+	}
+	return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Prints the years to the endurance or null if the pages are not written
+ * @param name JSON name
+ * @param writes writes to the endurance
+ * @param perDay writes per day
+ */
+static void printYears(const char * const name, const double writes, const double perDay)
+{
+	if (perDay > 0.0)
+	{
+		printf(",\"%s\":%.1f", name, writes / perDay / 365.0);
+	}
+	else
+	{
+		printf(",\"%s\":null", name);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	double perDay = 4.0;
+	double walks = 0.1;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+		{
+			mode = Sim_ParseMode(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			sessionMs = (uint32_t)strtoul(argv[++i], NULL, 0) * 60000u;
+		}
+		else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+		{
+			perDay = strtod(argv[++i], NULL);
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			walks = strtod(argv[++i], NULL);
+		}
+		else
+		{
+			mode = MODE_TOTAL;
+		}
+	}
+	if (mode == MODE_TOTAL)
+	{
+		fprintf(stderr, "usage: %s [-m mode] [-t minutes] [-d sessions_per_day] [-c config_walks_per_session]\n", argv[0]);
+		return 2;
+	}
+	uint32_t configs = 0;
+	uint32_t seeds = 0;
+	uint32_t session = 0;
+	uint32_t walk = 0;
+	if (!inChild(configsPerErase, &configs) || !inChild(seedsPerErase, &seeds) || !inChild(sessionSeeds, &session) ||
+			!inChild(walkConfigs, &walk) || configs == 0 || seeds == 0)
+	{
+		fprintf(stderr, "a measurement failed\n");
+		return 1;
+	}
+	const double configsToEndurance = (double)configs * FLASH_ENDURANCE;
+	const double seedsToEndurance = (double)seeds * FLASH_ENDURANCE;
+	printf("{\"mode\":\"%s\",\"session_min\":%u,\"sessions_per_day\":%.2f,\"config_walks_per_session\":%.2f,"
+			"\"configs_per_erase\":%u,\"seeds_per_erase\":%u,\"configs_to_endurance\":%.0f,\"seeds_to_endurance\":%.0f,"
+			"\"configs_per_walk\":%u,\"seeds_per_session\":%u",
+			Sim_ModeName(mode), (unsigned)(sessionMs / 60000u), perDay, walks, (unsigned)configs, (unsigned)seeds,
+			configsToEndurance, seedsToEndurance, (unsigned)walk, (unsigned)session);
+	printYears("config_years", configsToEndurance, walk * walks * perDay);
+	printYears("seed_years", seedsToEndurance, session * perDay);
+	printf("}\n");
+	return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file patc.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Pattern compiler. Compiles a text pattern (see pattern_compiler.h) and prints it as a C array
+ * for a phase function of led_control.c, or as raw bytes with -b.
+ * Usage: patc [-b] [-n name] file.pat
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "pattern_compiler.h"
+
+int main(int argc, char **argv)
+{
+	const char * name = "prog";
+	const char * path = NULL;
+	int binary = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-b") == 0)
+		{
+			binary = 1;
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			name = argv[++i];
+		}
+		else
+		{
+			path = argv[i];
+		}
+	}
+	if (path == NULL)
+	{
+		fprintf(stderr, "usage: %s [-b] [-n name] file.pat\n", argv[0]);
+		return 2;
+	}
+	FILE * const in = fopen(path, "rb");
+	if (in == NULL)
+	{
+		perror(path);
+		return 2;
+	}
+	static char text[64 * 1024];
+	const size_t len = fread(text, 1, sizeof(text) - 1, in);
+	fclose(in);
+	text[len] = 0;
+	static Patc_Result_t res;
+	if (Patc_Compile(text, &res) == 0)
+	{
+		fprintf(stderr, "%s:%u: error: %s\n", path, res.line, res.error);
+		return 1;
+	}
+	if (binary != 0)
+	{
+		fwrite(res.code, 1, res.size, stdout);
+	}
+	else
+	{
+		Patc_PrintC(stdout, name, res.code, res.size);
+	}
+	return 0;
+}
@@ -0,0 +1,639 @@
+/**
+ * @file pattern_compiler.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Contains the compiler of the text pattern language to the pattern bytecode and the bytecode printer
+ */
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pattern_compiler.h"
+#include "pattern.h"
+#include "project_conf.h"
+
+enum
+{
+	LINE_LEN = 256,   /**< Maximal line length */
+	NAME_LEN = 32,    /**< Maximal name length */
+	MAX_CONSTS = 64,  /**< Maximal number of constants */
+	MAX_ARGS = 5,     /**< Maximal number of op arguments */
+	NCOLORS = BLUE10 + 1 /**< Number of colors */
+};
+
+/**
+ * @brief Argument kinds. They set the range of the value
+ */
+typedef enum
+{
+	ARG_BYTE = 0, /**< 0..255 */
+	ARG_COLOR,    /**< @ref Colors_t */
+	ARG_STRIP,    /**< 0..4 */
+	ARG_FLAGS,    /**< PAT_DOTS_xxx flags */
+	ARG_MS        /**< 0..65535, two bytes little endian */
+} Arg_Kind_t;
+
+/**
+ * @brief Op description
+ */
+typedef struct
+{
+	const char * name;  /**< Op name in the text */
+	const char * macro; /**< PAT_xxx macro */
+	Pattern_Op_t op;    /**< Op code */
+	uint8_t nargs;      /**< Number of arguments */
+	Arg_Kind_t args[MAX_ARGS]; /**< Argument kinds */
+} Op_Desc_t;
+
+static const Op_Desc_t Ops[] =
+{
+		{"end",        "PAT_END",        PAT_OP_END,        0, {ARG_BYTE}},
+		{"fill",       "PAT_FILL",       PAT_OP_FILL,       1, {ARG_COLOR}},
+		{"strip",      "PAT_STRIP",      PAT_OP_STRIP,      2, {ARG_COLOR, ARG_STRIP}},
+		{"strips",     "PAT_STRIPS",     PAT_OP_STRIPS,     1, {ARG_COLOR}},
+		{"strips_rev", "PAT_STRIPS_REV", PAT_OP_STRIPS_REV, 1, {ARG_COLOR}},
+		{"dots",       "PAT_DOTS",       PAT_OP_DOTS,       5, {ARG_FLAGS, ARG_COLOR, ARG_BYTE, ARG_BYTE, ARG_BYTE}},
+		{"power",      "PAT_POWER",      PAT_OP_POWER,      0, {ARG_BYTE}},
+		{"set",        "PAT_SET",        PAT_OP_SET,        1, {ARG_BYTE}},
+		{"inc",        "PAT_INC",        PAT_OP_INC,        1, {ARG_BYTE}},
+		{"dec",        "PAT_DEC",        PAT_OP_DEC,        1, {ARG_BYTE}},
+		{"wait",       "PAT_WAIT",       PAT_OP_WAIT,       1, {ARG_MS}},
+		{"loop",       "PAT_LOOP",       PAT_OP_LOOP,       1, {ARG_BYTE}},
+		{"next",       "PAT_NEXT",       PAT_OP_NEXT,       0, {ARG_BYTE}},
+};
+
+static const char * const ColorNames[NCOLORS] =
+{
+		[BLACK] = "BLACK", [RED] = "RED", [GREEN] = "GREEN", [BLUE] = "BLUE", [WHITE] = "WHITE",
+		[YELLOW] = "YELLOW", [MAGENTA] = "MAGENTA", [CYAN] = "CYAN", [DARK_RED] = "DARK_RED",
+		[ORANGE] = "ORANGE", [REDDER] = "REDDER", [GREEN10] = "GREEN10", [BLUE10] = "BLUE10"
+};
+
+/**
+ * @brief Dots flags. Combined ones go first so the printer uses them
+ */
+static const struct
+{
+	const char * name;
+	uint8_t value;
+} Flags[] =
+{
+		{"ROWS", PAT_DOTS_ROWS}, {"ROW0", PAT_DOTS_ROW0}, {"ROW1", PAT_DOTS_ROW1}, {"MIRROR", PAT_DOTS_MIRROR},
+		{"FROM_N", PAT_DOTS_FROM_N}, {"TO_N", PAT_DOTS_TO_N}, {"NEG_N", PAT_DOTS_NEG_N}
+};
+
+/**
+ * @brief Named constant
+ */
+typedef struct
+{
+	char name[NAME_LEN];
+	long value;
+} Const_t;
+
+/**
+ * @brief Open loop
+ */
+typedef struct
+{
+	uint8_t forever; /**< Nonzero if the count is 0 */
+	uint8_t waits;   /**< Nonzero if the body has a wait */
+} Loop_t;
+
+/**
+ * @brief Compiler state
+ */
+typedef struct
+{
+	Patc_Result_t * res;
+	Const_t consts[MAX_CONSTS];
+	uint8_t nconsts;
+	Loop_t loops[PATTERN_LOOP_DEPTH];
+	uint8_t depth;
+	uint8_t terminal; /**< Nonzero if the last op never falls through */
+	const char * pos; /**< Expression parser position */
+} Compiler_t;
+
+static uint8_t fail(Compiler_t * const c, const char * const fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	vsnprintf(c->res->error, sizeof(c->res->error), fmt, ap);
+	va_end(ap);
+	return 0;
+}
+
+static void skipSpaces(Compiler_t * const c)
+{
+	while (*c->pos == ' ' || *c->pos == '\t')
+	{
+		c->pos++;
+	}
+}
+
+/**
+ * @brief Reads a name
+ * @param c compiler
+ * @param name output
+ * @return nonzero if there was a name
+ */
+static uint8_t readName(Compiler_t * const c, char * const name)
+{
+	uint8_t len = 0;
+	skipSpaces(c);
+	while ((isalnum((unsigned char)*c->pos) || *c->pos == '_') && len < NAME_LEN - 1)
+	{
+		name[len++] = *c->pos++;
+	}
+	name[len] = 0;
+	return len != 0 && !isdigit((unsigned char)name[0]);
+}
+
+/**
+ * @brief Finds the value of a name
+ * @param c compiler
+ * @param name name
+ * @param value output
+ * @return nonzero if found
+ */
+static uint8_t lookup(const Compiler_t * const c, const char * const name, long * const value)
+{
+	for (uint8_t i = 0; i < c->nconsts; i++)
+	{
+		if (strcmp(c->consts[i].name, name) == 0)
+		{
+			*value = c->consts[i].value;
+			return !0;
+		}
+	}
+	for (uint8_t i = 0; i < NCOLORS; i++)
+	{
+		if (strcmp(ColorNames[i], name) == 0)
+		{
+			*value = i;
+			return !0;
+		}
+	}
+	for (uint8_t i = 0; i < sizeof(Flags) / sizeof(Flags[0]); i++)
+	{
+		if (strcmp(Flags[i].name, name) == 0)
+		{
+			*value = Flags[i].value;
+			return !0;
+		}
+	}
+	if (strcmp(name, "NLEDS") == 0)
+	{
+		*value = NLEDS;
+		return !0;
+	}
+	return 0;
+}
+
+static uint8_t parseOr(Compiler_t * const c, long * const value);
+
+static uint8_t parsePrimary(Compiler_t * const c, long * const value)
+{
+	uint8_t ok = !0;
+	skipSpaces(c);
+	if (*c->pos == '(')
+	{
+		c->pos++;
+		ok = parseOr(c, value);
+		skipSpaces(c);
+		if (ok != 0 && *c->pos++ != ')')
+		{
+			ok = fail(c, "')' expected");
+		}
+	}
+	else if (*c->pos == '-')
+	{
+		c->pos++;
+		ok = parsePrimary(c, value);
+		*value = -*value;
+	}
+	else if (isdigit((unsigned char)*c->pos))
+	{
+		char * end;
+		*value = strtol(c->pos, &end, 0);
+		c->pos = end;
+	}
+	else
+	{
+		char name[NAME_LEN];
+		if (readName(c, name) == 0)
+		{
+			ok = fail(c, "value expected");
+		}
+		else if (lookup(c, name, value) == 0)
+		{
+			ok = fail(c, "unknown name '%s'", name);
+		}
+	}
+	return ok;
+}
+
+static uint8_t parseMul(Compiler_t * const c, long * const value)
+{
+	uint8_t ok = parsePrimary(c, value);
+	skipSpaces(c);
+	while (ok != 0 && (*c->pos == '*' || *c->pos == '/'))
+	{
+		const char op = *c->pos++;
+		long right;
+		ok = parsePrimary(c, &right);
+		if (ok != 0 && op == '/' && right == 0)
+		{
+			ok = fail(c, "division by zero");
+		}
+		else if (ok != 0)
+		{
+			*value = (op == '*') ? *value * right : *value / right;
+		}
+		skipSpaces(c);
+	}
+	return ok;
+}
+
+static uint8_t parseAdd(Compiler_t * const c, long * const value)
+{
+	uint8_t ok = parseMul(c, value);
+	skipSpaces(c);
+	while (ok != 0 && (*c->pos == '+' || *c->pos == '-'))
+	{
+		const char op = *c->pos++;
+		long right;
+		ok = parseMul(c, &right);
+		*value = (op == '+') ? *value + right : *value - right;
+		skipSpaces(c);
+	}
+	return ok;
+}
+
+static uint8_t parseOr(Compiler_t * const c, long * const value)
+{
+	uint8_t ok = parseAdd(c, value);
+	skipSpaces(c);
+	while (ok != 0 && *c->pos == '|')
+	{
+		c->pos++;
+		long right;
+		ok = parseAdd(c, &right);
+		*value |= right;
+		skipSpaces(c);
+	}
+	return ok;
+}
+
+/**
+ * @brief Checks the argument value and puts it to the code
+ * @param c compiler
+ * @param kind argument kind
+ * @param value value
+ * @return nonzero if ok
+ */
+static uint8_t emitArg(Compiler_t * const c, const Arg_Kind_t kind, const long value)
+{
+	static const long maxValue[] = {[ARG_BYTE] = 255, [ARG_COLOR] = NCOLORS - 1, [ARG_STRIP] = 4,
+			[ARG_FLAGS] = PAT_DOTS_ROWS | PAT_DOTS_MIRROR | PAT_DOTS_FROM_N | PAT_DOTS_TO_N | PAT_DOTS_NEG_N, [ARG_MS] = 65535};
+	static const char * const kindNames[] = {[ARG_BYTE] = "value", [ARG_COLOR] = "color", [ARG_STRIP] = "strip",
+			[ARG_FLAGS] = "flags", [ARG_MS] = "time"};
+	Patc_Result_t * const res = c->res;
+	const uint8_t bytes = (kind == ARG_MS) ? 2 : 1;
+	if (value < 0 || value > maxValue[kind] || (kind == ARG_FLAGS && (value & ~maxValue[kind]) != 0))
+	{
+		return fail(c, "%s %ld is out of range 0..%ld", kindNames[kind], value, maxValue[kind]);
+	}
+	if (res->size + bytes > PATC_MAX_CODE)
+	{
+		return fail(c, "program is longer than %d bytes", PATC_MAX_CODE);
+	}
+	res->code[res->size++] = (uint8_t)value;
+	if (bytes == 2)
+	{
+		res->code[res->size++] = (uint8_t)(value >> 8);
+	}
+	return !0;
+}
+
+/**
+ * @brief Updates the loop checks by the op
+ * @param c compiler
+ * @param op op
+ * @param arg the first argument
+ * @return nonzero if ok
+ */
+static uint8_t checkFlow(Compiler_t * const c, const Pattern_Op_t op, const long arg)
+{
+	uint8_t ok = !0;
+	c->terminal = (op == PAT_OP_END);
+	if (op == PAT_OP_WAIT)
+	{
+		for (uint8_t i = 0; i < c->depth; i++)
+		{
+			c->loops[i].waits = !0;
+		}
+	}
+	else if (op == PAT_OP_LOOP)
+	{
+		if (c->depth == PATTERN_LOOP_DEPTH)
+		{
+			ok = fail(c, "loops are nested deeper than %d", PATTERN_LOOP_DEPTH);
+		}
+		else
+		{
+			c->loops[c->depth].forever = (arg == 0);
+			c->loops[c->depth].waits = 0;
+			c->depth++;
+		}
+	}
+	else if (op == PAT_OP_NEXT)
+	{
+		if (c->depth == 0)
+		{
+			ok = fail(c, "next without loop");
+		}
+		else
+		{
+			const Loop_t * const loop = c->loops + --c->depth;
+			if (loop->forever != 0 && loop->waits == 0)
+			{
+				ok = fail(c, "endless loop without wait");
+			}
+			c->terminal = (loop->forever != 0);
+		}
+	}
+	return ok;
+}
+
+/**
+ * @brief Compiles one line
+ * @param c compiler
+ * @param line line without the comment
+ * @return nonzero if ok
+ */
+static uint8_t compileLine(Compiler_t * const c, const char * const line)
+{
+	char name[NAME_LEN];
+	c->pos = line;
+	skipSpaces(c);
+	if (*c->pos == 0)
+	{
+		return !0;
+	}
+	if (readName(c, name) == 0)
+	{
+		return fail(c, "op expected");
+	}
+	if (strcmp(name, "const") == 0)
+	{
+		Const_t k;
+		long dummy;
+		if (readName(c, k.name) == 0)
+		{
+			return fail(c, "constant name expected");
+		}
+		if (lookup(c, k.name, &dummy) != 0)
+		{
+			return fail(c, "'%s' is already defined", k.name);
+		}
+		skipSpaces(c);
+		if (*c->pos++ != '=')
+		{
+			return fail(c, "'=' expected");
+		}
+		if (c->nconsts == MAX_CONSTS)
+		{
+			return fail(c, "more than %d constants", MAX_CONSTS);
+		}
+		if (parseOr(c, &k.value) == 0)
+		{
+			return 0;
+		}
+		skipSpaces(c);
+		if (*c->pos != 0)
+		{
+			return fail(c, "unexpected '%s'", c->pos);
+		}
+		c->consts[c->nconsts++] = k;
+		return !0;
+	}
+	const Op_Desc_t * desc = NULL;
+	for (uint8_t i = 0; i < sizeof(Ops) / sizeof(Ops[0]); i++)
+	{
+		if (strcmp(Ops[i].name, name) == 0)
+		{
+			desc = Ops + i;
+		}
+	}
+	if (desc == NULL)
+	{
+		return fail(c, "unknown op '%s'", name);
+	}
+	long args[MAX_ARGS] = {0};
+	for (uint8_t i = 0; i < desc->nargs; i++)
+	{
+		if (i != 0)
+		{
+			skipSpaces(c);
+			if (*c->pos++ != ',')
+			{
+				return fail(c, "%s takes %u arguments", desc->name, desc->nargs);
+			}
+		}
+		if (parseOr(c, args + i) == 0)
+		{
+			return 0;
+		}
+	}
+	skipSpaces(c);
+	if (*c->pos == ',')
+	{
+		return fail(c, "%s takes %u arguments", desc->name, desc->nargs);
+	}
+	if (*c->pos != 0)
+	{
+		return fail(c, "unexpected '%s'", c->pos);
+	}
+	if (emitArg(c, ARG_BYTE, desc->op) == 0)
+	{
+		return 0;
+	}
+	for (uint8_t i = 0; i < desc->nargs; i++)
+	{
+		if (emitArg(c, desc->args[i], args[i]) == 0)
+		{
+			return 0;
+		}
+	}
+	return checkFlow(c, desc->op, args[0]);
+}
+
+uint8_t Patc_Compile(const char * const text, Patc_Result_t * const res)
+{
+	static Compiler_t c;
+	memset(&c, 0, sizeof(c));
+	memset(res, 0, sizeof(*res));
+	c.res = res;
+	const char * p = text;
+	uint8_t ok = !0;
+	while (ok != 0 && *p != 0)
+	{
+		char line[LINE_LEN];
+		const size_t len = strcspn(p, "\n");
+		res->line++;
+		if (len >= LINE_LEN)
+		{
+			ok = fail(&c, "line is longer than %d", LINE_LEN - 1);
+			break;
+		}
+		memcpy(line, p, len);
+		line[len] = 0;
+		line[strcspn(line, "#\r")] = 0;
+		ok = compileLine(&c, line);
+		p += len + ((p[len] != 0) ? 1 : 0);
+	}
+	if (ok != 0 && c.depth != 0)
+	{
+		ok = fail(&c, "loop is not closed");
+	}
+	else if (ok != 0 && c.terminal == 0)
+	{
+		ok = fail(&c, "program runs past its end, it must finish with end or an endless loop");
+	}
+	return ok;
+}
+
+uint8_t Patc_Check(const uint8_t * const code, const uint16_t size, Patc_Result_t * const res)
+{
+	static Compiler_t c;
+	memset(&c, 0, sizeof(c));
+	memset(res, 0, sizeof(*res));
+	c.res = res;
+	uint8_t ok = !0;
+	for (uint16_t pc = 0; ok != 0 && pc < size;)
+	{
+		const Op_Desc_t * desc = NULL;
+		for (uint8_t i = 0; i < sizeof(Ops) / sizeof(Ops[0]); i++)
+		{
+			if (Ops[i].op == code[pc])
+			{
+				desc = Ops + i;
+			}
+		}
+		res->line++;
+		if (desc == NULL)
+		{
+			ok = fail(&c, "unknown op %u", code[pc]);
+			break;
+		}
+		ok = emitArg(&c, ARG_BYTE, code[pc++]);
+		long args[MAX_ARGS] = {0};
+		for (uint8_t i = 0; ok != 0 && i < desc->nargs; i++)
+		{
+			const uint8_t bytes = (desc->args[i] == ARG_MS) ? 2 : 1;
+			if (pc + bytes > size)
+			{
+				ok = fail(&c, "%s is cut", desc->name);
+			}
+			else
+			{
+				args[i] = (bytes == 2) ? (long)(code[pc] | (code[pc + 1] << 8)) : (long)code[pc];
+				pc += bytes;
+				ok = emitArg(&c, desc->args[i], args[i]);
+			}
+		}
+		if (ok != 0)
+		{
+			ok = checkFlow(&c, desc->op, args[0]);
+		}
+	}
+	if (ok != 0 && c.depth != 0)
+	{
+		ok = fail(&c, "loop is not closed");
+	}
+	else if (ok != 0 && c.terminal == 0)
+	{
+		ok = fail(&c, "program runs past its end, it must finish with end or an endless loop");
+	}
+	return ok;
+}
+
+/**
+ * @brief Prints dots flags
+ * @param out output file
+ * @param flags flags
+ */
+static void printFlags(FILE * const out, uint8_t flags)
+{
+	const char * sep = "";
+	for (uint8_t i = 0; i < sizeof(Flags) / sizeof(Flags[0]); i++)
+	{
+		if ((flags & Flags[i].value) == Flags[i].value)
+		{
+			fprintf(out, "%sPAT_DOTS_%s", sep, Flags[i].name);
+			flags &= (uint8_t)~Flags[i].value;
+			sep = " | ";
+		}
+	}
+	if (*sep == 0)
+	{
+		fprintf(out, "0");
+	}
+}
+
+void Patc_PrintC(FILE * const out, const char * const name, const uint8_t * const code, const uint16_t size)
+{
+	uint8_t depth = 0;
+	fprintf(out, "static const uint8_t %s[] =\n{\n", name);
+	for (uint16_t pc = 0; pc < size;)
+	{
+		const Op_Desc_t * desc = NULL;
+		for (uint8_t i = 0; i < sizeof(Ops) / sizeof(Ops[0]); i++)
+		{
+			if (Ops[i].op == code[pc])
+			{
+				desc = Ops + i;
+			}
+		}
+		if (desc == NULL)
+		{
+			fprintf(out, "\t0x%02X, /* unknown op */\n", code[pc++]);
+			continue;
+		}
+		depth -= (desc->op == PAT_OP_NEXT && depth != 0) ? 1 : 0;
+		fputc('\t', out);
+		for (uint8_t i = 0; i < depth; i++)
+		{
+			fputc('\t', out);
+		}
+		fprintf(out, "%s", desc->macro);
+		pc++;
+		for (uint8_t i = 0; i < desc->nargs; i++)
+		{
+			fprintf(out, (i == 0) ? "(" : ", ");
+			switch (desc->args[i])
+			{
+			case ARG_COLOR:
+				fprintf(out, "%s", (code[pc] < NCOLORS) ? ColorNames[code[pc]] : "?");
+				break;
+			case ARG_FLAGS:
+				printFlags(out, code[pc]);
+				break;
+			case ARG_MS:
+				fprintf(out, "%u", (unsigned)(code[pc] | (code[pc + 1] << 8)));
+				pc++;
+				break;
+			default:
+				fprintf(out, "%u", code[pc]);
+				break;
+			}
+			pc++;
+		}
+		fprintf(out, "%s%s\n", (desc->nargs != 0) ? ")" : "", (pc < size) ? "," : "");
+		depth += (desc->op == PAT_OP_LOOP) ? 1 : 0;
+	}
+	fprintf(out, "};\n");
+}
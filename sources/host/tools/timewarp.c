@@ -0,0 +1,79 @@
+/**
+ * @file timewarp.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 17-10-2026
+ * @version 1.00
+ * @brief Virtual clock runner. Runs a mode on the host, every sleep jumps to the next task expiry, so hours
+ * of the mode take seconds. Prints a JSON line: simulated ms, host ms, frames and main loop iterations.
+ * With -f the frames are logged with their ticks (see @ref Sim_LogFrames).
+ * Usage: timewarp [-s seed] [-t ms] [-f log] mode
+ * mode is a @ref Working_Mode_t name (MODE_SC) or number. The default time covers the whole MODE_KART2H race
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "clock.h"
+
+enum
+{
+	DEFAULT_RUN_MS = 105u * 60u * 1000u /**< Longer than the longest mode timeline (MODE_KART2H) */
+};
+
+int main(int argc, char **argv)
+{
+	uint16_t seed = 0x1234;
+	uint32_t runMs = DEFAULT_RUN_MS;
+	const char * logName = NULL;
+	Working_Mode_t mode = MODE_TOTAL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			seed = (uint16_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			runMs = (uint32_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			logName = argv[++i];
+		}
+		else
+		{
+			mode = Sim_ParseMode(argv[i]);
+		}
+	}
+	if (mode == MODE_TOTAL)
+	{
+		fprintf(stderr, "usage: %s [-s seed] [-t ms] [-f log] mode\n", argv[0]);
+		return 2;
+	}
+	FILE * log = NULL;
+	if (logName != NULL)
+	{
+		log = (strcmp(logName, "-") == 0) ? stdout : fopen(logName, "w");
+		if (log == NULL)
+		{
+			perror(logName);
+			return 1;
+		}
+	}
+	const Config_t conf = Sim_DefaultConfig(mode);
+	Sim_Stats_t stats = {0};
+	Sim_Boot(&conf, seed, 0);
+	Sim_LogFrames(log);
+	Sim_Run(runMs, NULL, 0, &stats);
+	Sim_LogFrames(NULL);
+	if (log != NULL && log != stdout)
+	{
+		fclose(log);
+	}
+	const double wallMs = (double)stats.wallNs / 1e6;
+	fprintf((log == stdout) ? stderr : stdout,
+			"{\"mode\":\"%s\",\"sim_ms\":%u,\"wall_ms\":%.1f,\"speedup\":%.0f,\"frames\":%u,\"iterations\":%u}\n",
+			Sim_ModeName(mode), (unsigned)GetTicksCounter(), wallMs, (wallMs > 0.0) ? GetTicksCounter() / wallMs : 0.0,
+			(unsigned)stats.frames, (unsigned)stats.iterations);
+	return 0;
+}
@@ -8,10 +8,33 @@
 #define SOURCES_PROJECT_BL_INCLUDE_BLL_H_
 
 #include <stdint.h>
+
+/**
+ * @brief Task run statistics
+ */
+typedef struct
+{
+	uint32_t Deadline; /**< The tick of the next run */
+	uint32_t LateRuns; /**< Number of runs done after the deadline */
+	uint32_t SkippedRuns; /**< Number of runs dropped because the task was late for more than a period */
+	uint32_t WorstLateness; /**< Maximal lateness in ticks */
+} Task_Stats_t;
+
 /**
  * @brief contains one iteration of the main loop
  * @return 0 tick was not expired or 1 if tick expired.
  */
 uint8_t MainLoop_Iteration(void);
+/**
+ * @brief Returns time to the nearest task deadline. The cpu may sleep for this time
+ * @return ms, 0 if some task is late already
+ */
+uint32_t MainLoop_TimeToNextTask(void);
+/**
+ * @brief Returns task run statistics
+ * @param n task number in the task table
+ * @return pointer to the statistics or NULL if there is no such task
+ */
+const Task_Stats_t * GetTaskStats(const uint8_t n);
 
 #endif /* SOURCES_PROJECT_BL_INCLUDE_BLL_H_ */
@@ -0,0 +1,77 @@
+#ifndef SOURCES_PROJECT_BL_INCLUDE_KEYFRAME_H_
+#define SOURCES_PROJECT_BL_INCLUDE_KEYFRAME_H_
+/**
+ * @file keyframe.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains keyframe stream format and player prototypes. A stream is a const byte array in flash of frames.
+ * Every frame is a list of changed spans (from, length, color) that are put on both rows, and the time the frame is shown:
+ * @code
+ * static const uint8_t stream[] =
+ * {
+ *     KF_FRAME(500, 2), KF_SPAN(0, NLEDS / 2, BLACK), KF_SPAN(1, 10, KF_COLOR_INK),
+ *     KF_FRAME(500, 1), KF_SPAN(1, 10, BLACK),
+ *     KF_LOOP
+ * };
+ * @endcode
+ * The player has no per-tick logic: spans are copied to the frame buffer when the frame time comes.
+ */
+#include <stdint.h>
+#include "led_strip.h"
+
+enum
+{
+	KF_SPANS_LOOP = 0xFF,  /**< Frame header span number that restarts the stream */
+	KF_SPANS_END = 0xFE,   /**< Frame header span number that stops the stream. The last frame stays */
+	KF_COLOR_INK = 0xFF,   /**< Span color is the player ink color, see @ref Keyframe_Start */
+	KF_COLOR_POWER = 0xFE, /**< Span color is the battery level color */
+	KEYFRAME_MAX_FRAMES = 16 /**< Maximal number of frames applied by one @ref Keyframe_Run call */
+};
+
+#define KF_FRAME(ms,nspans)         (nspans), (uint8_t)(ms), (uint8_t)((ms) >> 8)
+#define KF_SPAN(from,len,color)     (from), (len), (color)
+#define KF_LOOP                     KF_SPANS_LOOP
+#define KF_END                      KF_SPANS_END
+
+/**
+ * @brief Keyframe player state
+ */
+typedef struct
+{
+	const uint8_t * stream; /**< Keyframe stream */
+	pPowerColorFunc_t getPowerColor; /**< Battery level color for @ref KF_COLOR_POWER */
+	uint32_t wake;  /**< Tick when the next frame is shown */
+	uint16_t pos;   /**< Next frame header */
+	Colors_t ink;   /**< Color for @ref KF_COLOR_INK */
+}Keyframe_Player_t;
+
+/**
+ * @brief Starts playing a stream from its first frame
+ * @param p player
+ * @param stream keyframe stream
+ * @param ink color that replaces @ref KF_COLOR_INK
+ * @param getPowerColor battery level color function
+ * @param start tick when the first frame is shown. Random offsets of the mode can be added here
+ */
+void Keyframe_Start(Keyframe_Player_t * const p, const uint8_t * const stream, const Colors_t ink,
+		const pPowerColorFunc_t getPowerColor, const uint32_t start);
+
+/**
+ * @brief Applies all frames which time has come
+ * @param p player
+ * @param now current tick
+ * @return nonzero means the led strip must be updated
+ */
+uint8_t Keyframe_Run(Keyframe_Player_t * const p, const uint32_t now);
+
+/**
+ * @brief Time to the next frame
+ * @param p player
+ * @param now current tick
+ * @return ms, UINT32_MAX if the stream has ended
+ */
+uint32_t Keyframe_TimeToNext(const Keyframe_Player_t * const p, const uint32_t now);
+
+#endif /* SOURCES_PROJECT_BL_INCLUDE_KEYFRAME_H_ */
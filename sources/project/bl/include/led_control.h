@@ -6,12 +6,50 @@
 #ifndef SOURCES_PROJECT_BL_INCLUDE_LED_CONTROL_H_
 #define SOURCES_PROJECT_BL_INCLUDE_LED_CONTROL_H_
 #include <stdint.h>
+#include "pattern.h"
+
+/**
+ * @brief Working modes. Pitstop or slalom tlight
+ */
+typedef enum
+{
+	MODE_PIT = 0,/**< Pitstop mode */
+	MODE_TLIGHT, /**< Slalom traffic light mode */
+	MODE_PODNOS, /**< Mode for rally stop-and-go */
+	MODE_SC,     /**< Safety car mode */
+	MODE_KART2H, /**< Karting 2h mode */
+	MODE_PITINVITE, /**< Pitlane invitation mode */
+	MODE_IRONMAN, /**< Iron man mode. Tlight + pit */
+	MODE_PIT2, /**< Pitstop V2, DD08012025 */
+	MODE_TOTAL   /**< Total number of modes */
+} Working_Mode_t;
 
 /**
  * @brief function that prepares led strip out data at every step (100ms)
  * @param ms - number of milliseconds that had passed after pitstick is on
  */
 void led_control(uint32_t const ms);
+/**
+ * @brief Returns time from the last @ref led_control call to the next event of the current mode: the start of the next phase,
+ * the next pattern or keyframe step or the expiry of a software timer checked by the mode
+ * @return ms, UINT32_MAX if the mode has no timed events
+ */
+uint32_t led_control_TimeToPhase(void);
+/**
+ * @brief Returns the pattern programs of the phases for the host checks of the bytecode. The firmware doesn't use it,
+ * the table is dropped by the linker
+ * @param n set to the number of programs
+ * @return programs
+ */
+const Pattern_Desc_t * led_control_GetPatterns(uint8_t * const n);
+/**
+ * @brief Processes a timeline of the pit stop shape whose phases do nothing, for the host bench of the timeline
+ * processing. The firmware doesn't use it, it's dropped by the linker
+ * @param ms milliseconds from the timeline start, zero starts it again
+ * @param ended set to nonzero after the last phase
+ * @return nonzero if the strip must be updated
+ */
+uint8_t led_control_TimelineStep(const uint32_t ms, uint8_t * const ended);
 
 
 #endif /* SOURCES_PROJECT_BL_INCLUDE_LED_CONTROL_H_ */
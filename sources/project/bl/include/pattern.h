@@ -0,0 +1,136 @@
+#ifndef SOURCES_PROJECT_BL_INCLUDE_PATTERN_H_
+#define SOURCES_PROJECT_BL_INCLUDE_PATTERN_H_
+/**
+ * @file pattern.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains led pattern bytecode and interpreter prototypes. A pattern is a const byte array in flash
+ * that is written with the PAT_xxx macros below, for example a green blink is
+ * @code
+ * static const uint8_t prog[] =
+ * {
+ *     PAT_LOOP(0),
+ *         PAT_FILL(GREEN), PAT_WAIT(200),
+ *         PAT_FILL(BLACK), PAT_WAIT(800),
+ *     PAT_NEXT,
+ * };
+ * @endcode
+ * The interpreter has one counter register @ref Pattern_t::n that is used by the ops marked "uses n".
+ * A program that is wrong for the interpreter (an unknown op, loops nested deeper than @ref PATTERN_LOOP_DEPTH,
+ * a next without loop) is stopped at that op and @ref Pattern_t::fault is set. The host pattern compiler rejects
+ * such programs and test_patc checks the programs of led_control.c with it
+ */
+#include <stdint.h>
+#include "led_strip.h"
+
+/**
+ * @brief Pattern op codes. Arguments follow the op code, one byte each unless stated otherwise
+ */
+typedef enum
+{
+	PAT_OP_END = 0,  /**< Stop. The last frame stays on the strip */
+	PAT_OP_FILL,     /**< color: fill all the strip */
+	PAT_OP_STRIP,    /**< color, strip: show strip (0 - 4) */
+	PAT_OP_STRIPS,   /**< color: show n strips from the handle on black, uses n */
+	PAT_OP_STRIPS_REV, /**< color: show n strips from the top on black, uses n */
+	PAT_OP_DOTS,     /**< flags, color, from, to, step: put pixels from..to with step. See PAT_DOTS_xxx flags */
+	PAT_OP_POWER,    /**< Put the battery level pixels to the handle */
+	PAT_OP_SET,      /**< value: n = value */
+	PAT_OP_INC,      /**< max: n = n + 1 but not more than max */
+	PAT_OP_DEC,      /**< min: n = n - 1 but not less than min */
+	PAT_OP_WAIT,     /**< ms (16 bits, little endian): show the frame and wait */
+	PAT_OP_LOOP,     /**< count: repeat ops up to @ref PAT_OP_NEXT count times, 0 means forever */
+	PAT_OP_NEXT      /**< End of the loop body */
+}Pattern_Op_t;
+
+/**
+ * @brief @ref PAT_OP_DOTS flags
+ */
+enum
+{
+	PAT_DOTS_ROW0 = 0x01,   /**< Draw on row 0 */
+	PAT_DOTS_ROW1 = 0x02,   /**< Draw on row 1 */
+	PAT_DOTS_ROWS = PAT_DOTS_ROW0 | PAT_DOTS_ROW1, /**< Draw on both rows */
+	PAT_DOTS_MIRROR = 0x04, /**< Also draw the pixel mirrored around the row middle */
+	PAT_DOTS_FROM_N = 0x08, /**< from is shifted by n */
+	PAT_DOTS_TO_N = 0x10,   /**< to is shifted by n */
+	PAT_DOTS_NEG_N = 0x20,  /**< Shift is -n instead of +n */
+};
+
+enum
+{
+	PATTERN_LOOP_DEPTH = 2, /**< Maximal nesting of @ref PAT_OP_LOOP */
+	PATTERN_MAX_STEPS = 255 /**< Maximal number of ops executed by one @ref Pattern_Run call */
+};
+
+#define PAT_END                     PAT_OP_END
+#define PAT_FILL(color)             PAT_OP_FILL, (color)
+#define PAT_STRIP(color,strip)      PAT_OP_STRIP, (color), (strip)
+#define PAT_STRIPS(color)           PAT_OP_STRIPS, (color)
+#define PAT_STRIPS_REV(color)       PAT_OP_STRIPS_REV, (color)
+#define PAT_DOTS(flags,color,from,to,step) PAT_OP_DOTS, (flags), (color), (from), (to), (step)
+#define PAT_POWER                   PAT_OP_POWER
+#define PAT_SET(value)              PAT_OP_SET, (value)
+#define PAT_INC(max)                PAT_OP_INC, (max)
+#define PAT_DEC(min)                PAT_OP_DEC, (min)
+#define PAT_WAIT(ms)                PAT_OP_WAIT, (uint8_t)(ms), (uint8_t)((ms) >> 8)
+#define PAT_LOOP(count)             PAT_OP_LOOP, (count)
+#define PAT_NEXT                    PAT_OP_NEXT
+
+/**
+ * @brief Pattern interpreter state
+ */
+typedef struct
+{
+	const uint8_t * prog; /**< Pattern program */
+	pPowerColorFunc_t getPowerColor; /**< Battery level color for @ref PAT_OP_POWER */
+	uint32_t wake;   /**< Tick when the current wait ends. Waits are counted from the previous wake so they do not drift */
+	uint16_t pc;     /**< Next op */
+	uint8_t n;       /**< Counter register */
+	uint8_t depth;   /**< Number of open loops */
+	uint8_t fault;   /**< Nonzero if the program was stopped at a wrong op */
+	struct
+	{
+		uint16_t start; /**< The first op of the loop body */
+		uint8_t left;   /**< Repeats left, 0 - forever */
+	}loops[PATTERN_LOOP_DEPTH];
+}Pattern_t;
+
+/**
+ * @brief Named pattern program
+ */
+typedef struct
+{
+	const char * name;    /**< Phase name */
+	const uint8_t * prog; /**< Program */
+	uint16_t size;        /**< Program size in bytes */
+}Pattern_Desc_t;
+
+/**
+ * @brief Starts a pattern from its first op
+ * @param p interpreter state
+ * @param prog pattern program
+ * @param getPowerColor battery level color function
+ * @param now current tick
+ */
+void Pattern_Start(Pattern_t * const p, const uint8_t * const prog, const pPowerColorFunc_t getPowerColor, const uint32_t now);
+
+/**
+ * @brief Runs pattern ops until the next wait that is not over or the end
+ * @param p interpreter state
+ * @param now current tick
+ * @return nonzero means the led strip must be updated
+ */
+uint8_t Pattern_Run(Pattern_t * const p, const uint32_t now);
+
+/**
+ * @brief Time to the end of the current wait
+ * @param p interpreter state
+ * @param now current tick
+ * @return ms, UINT32_MAX if the pattern has ended
+ */
+uint32_t Pattern_TimeToWake(const Pattern_t * const p, const uint32_t now);
+
+#endif /* SOURCES_PROJECT_BL_INCLUDE_PATTERN_H_ */
@@ -12,19 +12,62 @@
 #include "watchdog.h"
 #include "buttons.h"
 #include "led_control.h"
+#include "project_conf.h"
+#include "profiler.h"
+
+/**
+ * @brief What to do with the periods that were missed because the loop was busy
+ */
+typedef enum
+{
+	TASK_CATCH_UP = 0, /**< Every missed run is done late, one per tick, until the task catches up */
+	TASK_SKIP          /**< The task runs once late and missed runs are dropped */
+} Task_Policy_t;
 
 /**
  * @brief Task table element
  */
 typedef struct
 {
-	uint32_t Period; /**< Period of task in tics (10ms per tick) */
+	uint32_t Period; /**< Period of task in tics (1ms per tick) */
 	uint32_t Phase;  //!< Task phase (remain of division)
 	void (*Task)(void); //!< Task function
+	Task_Policy_t Policy; //!< Missed runs policy
 } Task_table_t;
 
+static void ledControl_wrapper(void);
+
+/**
+ * @brief Task numbers in @ref TaskTable
+ */
+enum
+{
+	TASK_HEARTBEAT = 0,
+	TASK_LED_CONTROL,
+	NTASKS /**< Number of tasks */
+};
+
+_Static_assert(PROF_TASK_LED_CONTROL - PROF_TASK_HEARTBEAT == TASK_LED_CONTROL, "Profiler sections must follow the task order");
+
 /**
- * @brief calls @ref led_control function with ms as a parameter. ms is time from stick on to the current time
+ * @brief Task table. First parameter is period and the second is "phase" which is a remaining after dividing the time of the run by the first param.
+ * It's done to make switcher to use different timeslots
+ */
+static const Task_table_t TaskTable[NTASKS]=
+{
+		[TASK_HEARTBEAT]   = {500,3,Toggle_Heartbeat,TASK_CATCH_UP}, /* Every toggle is done, so the blink keeps its phase with the clock */
+		[TASK_LED_CONTROL] = {100,1,ledControl_wrapper,TASK_SKIP} /* Uses ms from start */
+};
+
+/**
+ * @brief Task statistics
+ */
+static Task_Stats_t TaskStats[NTASKS];
+
+/**
+ * @brief calls @ref led_control function with ms as a parameter. ms is time from stick on to the current time.
+ * With @ref LED_PHASE_EXACT the next call is moved to the start of the next phase if it comes earlier than the next step,
+ * so the following steps are aligned to it too
  */
 static void ledControl_wrapper(void)
 {
@@ -35,47 +78,114 @@ static void ledControl_wrapper(void)
 		ResetTimer(&mainTimer);
 		firstTime = 0;
 	}
+#if LED_PHASE_EXACT
+	const uint32_t now = GetTicksCounter();
+#endif
+	Button_Process(B_CONFIG); /* Button edges are caught by interrupt so it's enough to process them before use */
 	led_control(ReadTimer(&mainTimer));
+#if LED_PHASE_EXACT
+	const uint32_t toPhase = led_control_TimeToPhase();
+	Task_Stats_t * const stats = TaskStats + TASK_LED_CONTROL;
+	if (toPhase > 0 && toPhase < stats->Deadline - now) /* The current tick has been served, zero would make the next run late */
+	{
+		stats->Deadline = now + toPhase;
+	}
+#endif
 }
 /**
- * @brief Polls the buttom
+ * @brief Calculates the first tick not earlier than now where the task should run
+ * @param task task
+ * @param now current tick
+ * @return the deadline
  */
-static void processButtons(void)
+static uint32_t firstDeadline(const Task_table_t * const task, const uint32_t now)
 {
-	Button_Process(B_CONFIG);
+	const uint32_t rem = now % task->Period;
+	return now - rem + task->Phase + ((rem > task->Phase) ? task->Period : 0);
 }
 
 /**
- * @brief Contains main while(1) loop.  Tasks are selected from the task table. Last task should be {0,0,NULL}.
- * First parameter is period and the second is "phase" which is a remaining after dividing current time by the first param
- * It's done to make switcher to use different timeslots
+ * @brief Runs the task if its deadline has come and moves the deadline according to the task policy
+ * @param n task number
+ * @param now current tick
+ */
+static void runTask(const uint8_t n, const uint32_t now)
+{
+	const Task_table_t * const task = TaskTable + n;
+	Task_Stats_t * const stats = TaskStats + n;
+	const int32_t lateness = (int32_t)(now - stats->Deadline);
+	if (lateness >= 0)
+	{
+		if (lateness > 0)
+		{
+			stats->LateRuns++;
+			if ((uint32_t)lateness > stats->WorstLateness)
+			{
+				stats->WorstLateness = lateness;
+			}
+		}
+		if (task->Policy == TASK_SKIP)
+		{
+			const uint32_t missed = (uint32_t)lateness / task->Period;
+			stats->SkippedRuns += missed;
+			stats->Deadline += (missed + 1) * task->Period;
+		}
+		else
+		{
+			stats->Deadline += task->Period;
+		}
+		PROFILE_START();
+		(*task->Task)(); /* The task may move its next deadline closer */
+		PROFILE_END((Prof_Id_t)(PROF_TASK_HEARTBEAT + n));
+	}
+}
+
+/**
+ * @brief Contains main while(1) loop. Every task of @ref TaskTable is run when its deadline has come.
+ * If the loop was busy for longer than a tick the task runs late and missed periods are handled by @ref Task_Policy_t
  * @return 0 if no tick occured
  */
 uint8_t MainLoop_Iteration(void)
 {
-	static const Task_table_t TaskTable[]={
-			{10,2,processButtons},
-			{500,3,Toggle_Heartbeat},
-			{100,1,ledControl_wrapper},
-			{0,0,NULL}
-	};
+	static uint8_t started = 0;
 	static uint32_t OldTicksCounter = 0;
 	uint32_t TicsCounter = GetTicksCounter();
 	uint8_t RetVal = 0;
 	Reset_Watchdog();
+	if (started == 0)
+	{
+		for (uint8_t n = 0; n < NTASKS; n++)
+		{
+			TaskStats[n].Deadline = firstDeadline(TaskTable + n, TicsCounter);
+		}
+		started = !0;
+	}
 	if (TicsCounter != OldTicksCounter)
 	{
-		uint8_t Counter = 0;
-		do
+		for (uint8_t n = 0; n < NTASKS; n++)
 		{
-			if (((TicsCounter % TaskTable[Counter].Period) == TaskTable[Counter].Phase) &&
-					TaskTable[Counter].Task != NULL)
-			{
-				(*TaskTable[Counter].Task)();
-			}
-		} while (TaskTable[++Counter].Task != NULL);
+			runTask(n, TicsCounter);
+		}
 		OldTicksCounter = TicsCounter;
 		RetVal = 1;
 	}
 	return RetVal;
 }
+
+uint32_t MainLoop_TimeToNextTask(void)
+{
+	const uint32_t now = GetTicksCounter();
+	uint32_t minTime = UINT32_MAX;
+	for (uint8_t n = 0; n < NTASKS; n++)
+	{
+		const int32_t left = (int32_t)(TaskStats[n].Deadline - now);
+		const uint32_t time = (left > 0) ? (uint32_t)left : 0;
+		minTime = (time < minTime) ? time : minTime;
+	}
+	return minTime;
+}
+
+const Task_Stats_t * GetTaskStats(const uint8_t n)
+{
+	return (n < NTASKS) ? TaskStats + n : NULL;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file keyframe.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains keyframe stream player. Frame times are counted from the previous frame time so they do not drift.
+ */
+#include <stddef.h>
+#include "keyframe.h"
+
+/**
+ * @brief Resolves span color
+ * @param p player
+ * @param color span color byte
+ * @return color to display
+ */
+static Colors_t spanColor(const Keyframe_Player_t * const p, const uint8_t color)
+{
+	Colors_t retval = (Colors_t)color;
+	if (color == KF_COLOR_INK)
+	{
+		retval = p->ink;
+	}
+	else if (color == KF_COLOR_POWER)
+	{
+		retval = (p->getPowerColor != NULL) ? p->getPowerColor() : BLACK;
+	}
+	return retval;
+}
+
+void Keyframe_Start(Keyframe_Player_t * const p, const uint8_t * const stream, const Colors_t ink,
+		const pPowerColorFunc_t getPowerColor, const uint32_t start)
+{
+	p->stream = stream;
+	p->getPowerColor = getPowerColor;
+	p->wake = start;
+	p->pos = 0;
+	p->ink = ink;
+}
+
+uint8_t Keyframe_Run(Keyframe_Player_t * const p, const uint32_t now)
+{
+	uint8_t changed = 0;
+	for (uint8_t frames = 0; frames < KEYFRAME_MAX_FRAMES && (int32_t)(now - p->wake) >= 0; frames++)
+	{
+		const uint8_t * const frame = p->stream + p->pos;
+		if (frame[0] == KF_SPANS_END)
+		{
+			break;
+		}
+		else if (frame[0] == KF_SPANS_LOOP)
+		{
+			p->pos = 0;
+		}
+		else
+		{
+			const uint8_t * span = frame + 3;
+			for (uint8_t i = 0; i < frame[0]; i++, span += 3)
+			{
+				if (span[1] != 0)
+				{
+					fill2Pixels(spanColor(p, span[2]), span[0], span[0] + span[1] - 1);
+				}
+			}
+			p->wake += (uint32_t)frame[1] | ((uint32_t)frame[2] << 8);
+			p->pos += 3 + 3 * frame[0];
+			changed = !0;
+		}
+	}
+	return changed;
+}
+
+uint32_t Keyframe_TimeToNext(const Keyframe_Player_t * const p, const uint32_t now)
+{
+	uint32_t left = 0;
+	if (p->stream == NULL || p->stream[p->pos] == KF_SPANS_END)
+	{
+		left = UINT32_MAX;
+	}
+	else if ((int32_t)(now - p->wake) < 0)
+	{
+		left = p->wake - now;
+	}
+	return left;
+}
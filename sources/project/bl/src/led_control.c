@@ -37,6 +37,8 @@
 #include "project_conf.h"
 #include "prng.h"
 #include "led_strip.h"
+#include "pattern.h"
+#include "keyframe.h"
 
 static const uint16_t S = 1000u; /**< millisecons per second */
 static const uint32_t MIN = S * 60u; /**< milliseconds per minute */
@@ -65,6 +67,7 @@ typedef enum
 	STATE_CONFIG_PARAM_NOT_SAVING,  /**< Current parameter was not changed and will not be saved. Short turn the stick off confirms that */
 	STATE_CONFIG_PARAM_WAITING,     /**< Waiting after last button press */
 	STATE_CONFIG_BEGIN,             /**< Beginning of the configuration process */
+	STATE_CONFIG_DIAG,              /**< Showing flash storage health before the config parameters */
 	STATE_CONFIG_BRIGHTNESS,        /**< Configuring brightness */
 	STATE_CONFIG_MODE,              /**< Configuring mode (tlight for slalom or pitstick mode) */
 	STATE_CONFIG_TSEQ,              /**< Configuring total pitstop duration */
@@ -90,38 +93,6 @@ typedef enum
 	STATE_SC_MAIN                  /**< Main phase of safety car mode */
 }States_t;
 
-/**
- * @brief Working modes. Pitstop or slalom tlight
- */
-typedef enum
-{
-	MODE_PIT = 0,/**< Pitstop mode */
-	MODE_TLIGHT, /**< Slalom traffic light mode */
-	MODE_PODNOS, /**< Mode for rally stop-and-go */
-	MODE_SC,     /**< Safety car mode */
-	MODE_KART2H, /**< Karting 2h mode */
-	MODE_PITINVITE, /**< Pitlane invitation mode */
-	MODE_IRONMAN, /**< Iron man mode. Tlight + pit */
-	MODE_PIT2, /**< Pitstop V2, DD08012025 */
-	MODE_TOTAL   /**< Total number of modes */
-} Working_Mode_t;
-
-/**
- * @brief Flash storage config parameters
- */
-typedef enum /* Attention! Adding new channels here do not forget to extend MAX_STORAGE in eeemu.h */
-{
-	CH_BRIGHTNESS = 0,	/**< Brightness */
-	CH_MODE,          	/**< Selected work mode */
-	CH_TSEQ,          	/**< Total pitstop time */
-	CH_T1,            	/**< T1 Time in seconds */
-	CH_T2,            	/**< T2 Time in seconds */
-	CH_TLIGHT_MIN,    	/**< Tlight random part minimal value in 1/10s */
-	CH_TLIGHT_MAX,     	/**< Tlight random part maximal value in 1/10s */
-	CH_PODNOS_MODE_TIME, /**< Stop-and-go mode time */
-	CH_PITINVITE_COLOR   /**< The color of pitlane invitation mode */
-}Config_idx_t;
-
 /**
  * @brief End of config param mode
  */
@@ -284,6 +255,34 @@ static void displayPitInviteColor(const uint8_t value)
 	dispStrip(color,1);
 }
 
+enum
+{
+	DIAG_PAGES = 3,      /**< Number of values on the flash storage health screen */
+	DIAG_PAGE_MS = 1500  /**< Time every value is shown */
+};
+
+/**
+ * @brief Shows a value of the flash storage health screen: config pages wear (cyan), seed page wear (magenta)
+ * and failed flash jobs since reset (magenta and cyan). Wear is in percents of the flash endurance
+ * @param page value number
+ */
+static void displayDiag(const uint8_t page)
+{
+	const uint16_t failed = eeemuStats.failedJobs;
+	switch (page)
+	{
+	case 0:
+		displayNumber(CYAN,CYAN,eeemuGetWear(0));
+		break;
+	case 1:
+		displayNumber(MAGENTA,MAGENTA,eeemuGetWear(!0));
+		break;
+	default:
+		displayNumber(MAGENTA,CYAN,(failed > 99) ? 99 : (uint8_t)failed);
+		break;
+	}
+}
+
 /**
  * @brief Incremens the value using min and max limits.
  * @param dV
@@ -307,8 +306,6 @@ static uint8_t changeParam(DispValue_t * const dV,const uint8_t init)
 {
   static States_t state = STATE_CONFIG_PARAM_IDLE;
   static uint8_t saved = !0;
-  const uint8_t isPressed = IsPressed(B_CONFIG);
-  const uint8_t isLongPressed = IsLongPressed(B_CONFIG);
   static uint32_t timer;
   static uint32_t fastIncTimer;
   uint8_t changed = 0;
@@ -327,12 +324,13 @@ static uint8_t changeParam(DispValue_t * const dV,const uint8_t init)
       saved = 0;
     }
     dV->endMode = EM_CONTINUE;
+    Button_FlushEvents(B_CONFIG); /* The current level is used to start */
   }
 
   switch(state)
   {
     case STATE_CONFIG_PARAM_IDLE:
-      if (isPressed)
+      if (IsPressed(B_CONFIG))
       {
         state = STATE_CONFIG_PARAM_PRESSED;
       }
@@ -345,19 +343,38 @@ static uint8_t changeParam(DispValue_t * const dV,const uint8_t init)
       changed = !0;
       break;
     case STATE_CONFIG_PARAM_PRESSED:
-      if (isPressed == 0)
-      {
-        state = STATE_CONFIG_PARAM_RELEASED;
-        ResetTimer(&timer);
-      }
-      if (isLongPressed != 0)
+    case STATE_CONFIG_PARAM_RELEASED:
+    case STATE_CONFIG_PARAM_LONG_PRESSED:
+      /* All the events since the last call are processed so short presses are not lost */
+      for (ButtonEvent_t event = Button_GetEvent(B_CONFIG); event != BUTTON_EVENT_NONE; event = Button_GetEvent(B_CONFIG))
       {
-    	  ResetTimer(&fastIncTimer);
-    	  state = STATE_CONFIG_PARAM_LONG_PRESSED;
+        switch (event)
+        {
+          case BUTTON_EVENT_PRESS:
+            if (state == STATE_CONFIG_PARAM_RELEASED)
+            {
+              incValue(dV);
+              saved = 0;
+              state = STATE_CONFIG_PARAM_PRESSED;
+              changed = !0;
+            }
+            break;
+          case BUTTON_EVENT_LONG:
+            if (state == STATE_CONFIG_PARAM_PRESSED)
+            {
+              ResetTimer(&fastIncTimer);
+              state = STATE_CONFIG_PARAM_LONG_PRESSED;
+            }
+            break;
+          case BUTTON_EVENT_RELEASE:
+            state = STATE_CONFIG_PARAM_RELEASED;
+            ResetTimer(&timer);
+            break;
+          default:
+            break;
+        }
       }
-      break;
-    case STATE_CONFIG_PARAM_RELEASED:
-      if (IsExpiredTimer(&timer,10000) != 0)
+      if (state == STATE_CONFIG_PARAM_RELEASED && IsExpiredTimer(&timer,10000) != 0)
       {
         if (saved != 0)
         {
@@ -367,30 +384,19 @@ static uint8_t changeParam(DispValue_t * const dV,const uint8_t init)
         {
           state = STATE_CONFIG_PARAM_SAVING;
         }
-      } else if (isPressed != 0)
+      }
+      else if (state == STATE_CONFIG_PARAM_LONG_PRESSED && IsExpiredTimer(&fastIncTimer,200) != 0)
       {
-    	incValue(dV);
-    	saved = 0;
-        state = STATE_CONFIG_PARAM_PRESSED;
-        dV->dispFunc(dV->value);
+        ResetTimer(&fastIncTimer);
+        incValue(dV);
+        saved = 0;
         changed = !0;
       }
+      if (changed != 0)
+      {
+        dV->dispFunc(dV->value);
+      }
       break;
-    case STATE_CONFIG_PARAM_LONG_PRESSED:
-    	if (isPressed == 0)
-    	{
-    		state = STATE_CONFIG_PARAM_RELEASED;
-    		ResetTimer(&timer);
-    	}
-    	else if (IsExpiredTimer(&fastIncTimer,200) != 0)
-    	{
-    		ResetTimer(&fastIncTimer);
-    		incValue(dV);
-    		saved = 0;
-    		changed = !0;
-    		dV->dispFunc(dV->value);
-    	}
-    	break;
     case STATE_CONFIG_PARAM_SAVING:
       showFull(BLACK);
       for (uint8_t i = 0; i < 20; i++)
@@ -433,14 +439,14 @@ static uint8_t changeParam(DispValue_t * const dV,const uint8_t init)
  */
 static uint8_t  config(uint8_t * const nextState)
 {
-  uint8_t * conf = eeemuGetValue();
   static uint8_t brightness;
   static States_t state = STATE_CONFIG_BEGIN;
   static uint8_t saved = !0;
   static uint32_t timer;
   uint8_t changed = 0;
-  static uint8_t savedParams[MAX_STORED];
+  static Config_t savedParams;
   static DispValue_t dV;
+  static uint8_t diagPage;
   if (nextState != NULL)
   {
     *nextState = 0;
@@ -449,33 +455,54 @@ static uint8_t  config(uint8_t * const nextState)
   switch(state)
   {
     case STATE_CONFIG_BEGIN:
-      memcpy(savedParams,conf,MAX_STORED);
-      brightness = savedParams[CH_BRIGHTNESS];
-      dV.dispFunc = displayBrightness;
-      dV.min = 0;
-      dV.max = MAX_BRIGHNESS_LEVELS - 1;
-      dV.value = brightness;
-      dV.endMode = EM_CONTINUE;
-      changed = changeParam(&dV,!0);
-      brightness = dV.value;
-      state = STATE_CONFIG_BRIGHTNESS;
+      diagPage = 0;
+      displayDiag(diagPage);
+      Button_FlushEvents(B_CONFIG);
+      ResetTimer(&timer);
+      changed = !0;
+      state = STATE_CONFIG_DIAG;
+      break;
+    case STATE_CONFIG_DIAG:
+      /* A button press shows the next value at once */
+      if (Button_GetEvent(B_CONFIG) == BUTTON_EVENT_PRESS || IsExpiredTimer(&timer,DIAG_PAGE_MS) != 0)
+      {
+        if (++diagPage < DIAG_PAGES)
+        {
+          displayDiag(diagPage);
+          ResetTimer(&timer);
+          changed = !0;
+        }
+        else
+        {
+          savedParams = *eeemuGetConfig();
+          brightness = savedParams.brightness;
+          dV.dispFunc = displayBrightness;
+          dV.min = 0;
+          dV.max = MAX_BRIGHNESS_LEVELS - 1;
+          dV.value = brightness;
+          dV.endMode = EM_CONTINUE;
+          changed = changeParam(&dV,!0);
+          brightness = dV.value;
+          state = STATE_CONFIG_BRIGHTNESS;
+        }
+      }
       break;
     case STATE_CONFIG_BRIGHTNESS:
       changed = changeParam(&dV,0);
       brightness = dV.value;
       setBrightness(brightness);
-      savedParams[CH_BRIGHTNESS] = brightness;
+      savedParams.brightness = brightness;
       if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
       {
         if (dV.endMode == EM_END_SAVING)
         {
           saved = 0;
         }
-        savedParams[CH_BRIGHTNESS] = brightness;
+        savedParams.brightness = brightness;
         dV.dispFunc = dispModePattern;
         dV.min = 0;
         dV.max = MODE_TOTAL - 1;
-        dV.value = savedParams[CH_MODE];
+        dV.value = savedParams.mode;
         dV.endMode = EM_CONTINUE;
         uint8_t changed2 = changeParam(&dV,!0);
         changed = changed || changed2;
@@ -497,15 +524,15 @@ static uint8_t  config(uint8_t * const nextState)
     		{
     			saved = 0;
     		}
-    		savedParams[CH_MODE] = dV.value;
+    		savedParams.mode = dV.value;
     		uint8_t noParam = !0;
-    		switch (savedParams[CH_MODE])
+    		switch (savedParams.mode)
     		{
     			case MODE_PIT:
     				dV.dispFunc = displayTSEQ;
     			dV.min = TSEQ_MIN;
     			dV.max = TSEQ_MAX;
-    			dV.value = savedParams[CH_TSEQ];
+    			dV.value = savedParams.tseq;
     			dV.endMode = EM_CONTINUE;
     			noParam = 0;
     			state = STATE_CONFIG_TSEQ;
@@ -514,7 +541,7 @@ static uint8_t  config(uint8_t * const nextState)
     				dV.dispFunc = displayTlightMin;
     			dV.min = TLIGHT_MIN;
     			dV.max = TLIGHT_MAX - 2;
-    			dV.value = savedParams[CH_TLIGHT_MIN];
+    			dV.value = savedParams.tlightMin;
     			dV.endMode = EM_CONTINUE;
     			noParam = 0;
     			state = STATE_CONFIG_TLIGHT_MIN;
@@ -523,7 +550,7 @@ static uint8_t  config(uint8_t * const nextState)
     				dV.dispFunc = displayPodnosModeTime,
 					dV.min = PODNOS_MODE_MIN;
     			dV.max = PODNOS_MODE_MAX;
-    			dV.value = savedParams[CH_PODNOS_MODE_TIME];
+    			dV.value = savedParams.podnosModeTime;
     			dV.endMode = EM_CONTINUE;
     			noParam = 0;
     			state = STATE_CONFIG_PODNOS_MODE;
@@ -540,7 +567,7 @@ static uint8_t  config(uint8_t * const nextState)
     				dV.dispFunc = displayPitInviteColor,
 					dV.min = 0,
 					dV.max = sizeof(num2color) / sizeof(num2color[0]) - 1;
-    			dV.value = savedParams[CH_PITINVITE_COLOR];
+    			dV.value = savedParams.pitInviteColor;
     			dV.endMode = EM_CONTINUE;
     			noParam = 0;
     			state = STATE_CONFIG_PITINVITE_COLOR;
@@ -569,7 +596,7 @@ static uint8_t  config(uint8_t * const nextState)
 
     case STATE_CONFIG_TSEQ:
     	changed = changeParam(&dV,0);
-    	savedParams[CH_TSEQ] = dV.value;
+    	savedParams.tseq = dV.value;
     	if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
     	{
     		if (dV.endMode == EM_END_SAVING)
@@ -578,8 +605,8 @@ static uint8_t  config(uint8_t * const nextState)
     		}
     		dV.dispFunc = displayT1;
     		dV.min = T1MIN;
-    		dV.max = savedParams[CH_TSEQ] - T1MIN2;
-    		dV.value = savedParams[CH_T1];
+    		dV.max = savedParams.tseq - T1MIN2;
+    		dV.value = savedParams.t1;
     		dV.endMode = EM_CONTINUE;
     		uint8_t changed2 = changeParam(&dV,!0);
     		changed = changed || changed2;
@@ -588,7 +615,7 @@ static uint8_t  config(uint8_t * const nextState)
     	break;
     case STATE_CONFIG_T1:
       changed = changeParam(&dV,0);
-      savedParams[CH_T1] = dV.value;
+      savedParams.t1 = dV.value;
       if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
       {
         if (dV.endMode == EM_END_SAVING)
@@ -597,8 +624,8 @@ static uint8_t  config(uint8_t * const nextState)
         }
         dV.dispFunc = displayT2;
         dV.min = T2MIN;
-        dV.max = savedParams[CH_T1] - T2MIN2;
-        dV.value = savedParams[CH_T2];
+        dV.max = savedParams.t1 - T2MIN2;
+        dV.value = savedParams.t2;
         dV.endMode = EM_CONTINUE;
         uint8_t changed2 = changeParam(&dV,!0);
         changed = changed || changed2;
@@ -607,7 +634,7 @@ static uint8_t  config(uint8_t * const nextState)
       break;
     case STATE_CONFIG_T2:
       changed = changeParam(&dV,0);
-      savedParams[CH_T2] = dV.value;
+      savedParams.t2 = dV.value;
       if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
       {
         if (dV.endMode == EM_END_SAVING)
@@ -616,7 +643,7 @@ static uint8_t  config(uint8_t * const nextState)
         }
         if (saved == 0)
         {
-          eeemu_write(savedParams);
+          eeemu_write(&savedParams);
           for (uint8_t i = 0; i < 20; i++)
           {
            put2pixels(RED,i);
@@ -637,7 +664,7 @@ static uint8_t  config(uint8_t * const nextState)
       break;
     case STATE_CONFIG_TLIGHT_MIN:
     	changed = changeParam(&dV,0);
-    	savedParams[CH_TLIGHT_MIN] = dV.value;
+    	savedParams.tlightMin = dV.value;
     	if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
     	{
     		if (dV.endMode == EM_END_SAVING)
@@ -645,9 +672,9 @@ static uint8_t  config(uint8_t * const nextState)
     			saved = 0;
     		}
     		dV.dispFunc = displayTlightMax;
-    		dV.min = savedParams[CH_TLIGHT_MIN] + 1;
+    		dV.min = savedParams.tlightMin + 1;
     		dV.max = TLIGHT_MAX;
-    		dV.value = savedParams[CH_TLIGHT_MAX];
+    		dV.value = savedParams.tlightMax;
     		dV.endMode = EM_CONTINUE;
     		uint8_t changed2 = changeParam(&dV,!0);
     		changed = changed || changed2;
@@ -657,7 +684,7 @@ static uint8_t  config(uint8_t * const nextState)
 
     case STATE_CONFIG_TLIGHT_MAX:
         changed = changeParam(&dV,0);
-        savedParams[CH_TLIGHT_MAX] = dV.value;
+        savedParams.tlightMax = dV.value;
         if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
         {
           if (dV.endMode == EM_END_SAVING)
@@ -666,7 +693,7 @@ static uint8_t  config(uint8_t * const nextState)
           }
           if (saved == 0)
           {
-            eeemu_write(savedParams);
+            eeemu_write(&savedParams);
             showFull(BLACK);
             for (uint8_t i = 0; i < 20; i++)
             {
@@ -684,7 +711,7 @@ static uint8_t  config(uint8_t * const nextState)
         break;
     case STATE_CONFIG_PODNOS_MODE:
     	changed = changeParam(&dV,0);
-    	savedParams[CH_PODNOS_MODE_TIME] = dV.value;
+    	savedParams.podnosModeTime = dV.value;
     	if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
     	{
     		if (dV.endMode == EM_END_SAVING)
@@ -693,7 +720,7 @@ static uint8_t  config(uint8_t * const nextState)
     		}
     		if (saved == 0)
     		{
-    			eeemu_write(savedParams);
+    			eeemu_write(&savedParams);
     			showFull(BLACK);
     			for (uint8_t i = 0; i < 20; i++)
     			{
@@ -711,7 +738,7 @@ static uint8_t  config(uint8_t * const nextState)
     	break;
     case STATE_CONFIG_PITINVITE_COLOR:
     	changed = changeParam(&dV,0);
-    	savedParams[CH_PITINVITE_COLOR] = dV.value;
+    	savedParams.pitInviteColor = dV.value;
     	if (dV.endMode != EM_CONTINUE && dV.endMode != EM_CONTINUE_DO_NOT_UPDATE)
     	{
     		if (dV.endMode == EM_END_SAVING)
@@ -720,7 +747,7 @@ static uint8_t  config(uint8_t * const nextState)
     		}
     		if (saved == 0)
     		{
-    			eeemu_write(savedParams);
+    			eeemu_write(&savedParams);
     			showFull(BLACK);
     			for (uint8_t i = 0; i < 20; i++)
     			{
@@ -743,7 +770,7 @@ static uint8_t  config(uint8_t * const nextState)
   	case STATE_CONFIG_PIT2_END:
         if (saved == 0)
         {
-          eeemu_write(savedParams);
+          eeemu_write(&savedParams);
           showFull(BLACK);
           for (uint8_t i = 0; i < 20; i++)
           {
@@ -813,6 +840,35 @@ static Colors_t getPowerColor(void)
 	}
 	return retval;
 }
+
+/**
+ * @brief Time from the current call of @ref led_control to the start of the next phase
+ */
+static uint32_t timeToPhase = UINT32_MAX;
+
+/**
+ * @brief Interpreter of the pattern phase that is running now. Only one phase runs at a time
+ */
+static Pattern_t pattern;
+
+/**
+ * @brief Runs pattern phase. Is called by phase functions that are written as a pattern bytecode
+ * @param init is nonzero at the first run
+ * @param prog pattern program
+ * @return nonzero means the led strip must be updated
+ */
+static uint8_t runPattern(const uint8_t init, const uint8_t * const prog)
+{
+	const uint32_t now = GetTicksCounter();
+	if (init != 0)
+	{
+		Pattern_Start(&pattern, prog, getPowerColor, now);
+	}
+	const uint8_t changed = Pattern_Run(&pattern, now);
+	const uint32_t left = Pattern_TimeToWake(&pattern, now);
+	timeToPhase = (left < timeToPhase) ? left : timeToPhase;
+	return changed;
+}
 /**
  * Structure that describes strips to display
  */
@@ -977,10 +1033,15 @@ static void dispRedStrips(const uint8_t nstrips)
 	dispStrips(RED,nstrips);
 }
 
-static void dispRedStripsReverse(const uint8_t nstrips)
+
+static const uint8_t tlightProg[] =
 {
-	dispStripsRevese(RED,nstrips);
-}
+	PAT_SET(5),
+	PAT_LOOP(0),
+		PAT_STRIPS(RED), PAT_WAIT(1000),
+		PAT_DEC(0),
+	PAT_NEXT
+};
 
 /**
  * @brief The main phase 5-4-3-2-1-go traffic light before crossing start/finish line. Starts at -5s and ends at 0
@@ -990,26 +1051,18 @@ static void dispRedStripsReverse(const uint8_t nstrips)
 
 static uint8_t tlight(const uint8_t init)
 {
-	static uint8_t nstrips;
-	uint8_t changed = 0;
-	static uint32_t timer;
-	if (init != 0)
-	{
-		nstrips = 5;
-		ResetTimer(&timer);
-		dispRedStrips(nstrips);
-		changed = !0;
-	}
-	if (IsExpiredTimer(&timer,1000) != 0)
-	{
-		changed = !0;
-		nstrips = (nstrips == 0) ? 0 : nstrips - 1;
-		dispRedStrips(nstrips);
-		ResetTimer(&timer);
-	}
-	return changed;
+	return runPattern(init, tlightProg);
 }
 
+static const uint8_t tlightReverseProg[] =
+{
+	PAT_SET(1),
+	PAT_LOOP(0),
+		PAT_STRIPS(RED), PAT_WAIT(1000),
+		PAT_INC(5),
+	PAT_NEXT
+};
+
 /**
  * @brief The main phase 5-4-3-2-1-go traffic light before crossing start/finish line. Starts at -5s and ends at 0
  * @param init is nonzero at the first run
@@ -1018,46 +1071,21 @@ static uint8_t tlight(const uint8_t init)
 
 static uint8_t tlightReverse(const uint8_t init)
 {
-    static uint8_t nstrips;
-    uint8_t changed = 0;
-    static uint32_t timer;
-    if (init != 0)
-    {
-        nstrips = 1;
-        ResetTimer(&timer);
-        dispRedStrips(nstrips);
-        changed = !0;
-    }
-    if (IsExpiredTimer(&timer,1000) != 0)
-    {
-        changed = !0;
-        nstrips = (nstrips == 5) ? 5 : nstrips + 1;
-        dispRedStrips(nstrips);
-        ResetTimer(&timer);
-    }
-    return changed;
+	return runPattern(init, tlightReverseProg);
 }
 
+static const uint8_t tlightForwardProg[] =
+{
+	PAT_SET(1),
+	PAT_LOOP(0),
+		PAT_STRIPS_REV(RED), PAT_WAIT(1000),
+		PAT_INC(5),
+	PAT_NEXT
+};
+
 static uint8_t tlightForward(const uint8_t init)
 {
-	static uint8_t nstrips;
-	uint8_t changed = 0;
-	static uint32_t timer;
-	if (init != 0)
-	{
-		nstrips = 1;
-		ResetTimer(&timer);
-		dispRedStripsReverse(nstrips);
-		changed = !0;
-	}
-	if (IsExpiredTimer(&timer,1000) != 0)
-	{
-		changed = !0;
-		nstrips = (nstrips == 5) ? 5 : nstrips + 1;
-		dispRedStripsReverse(nstrips);
-		ResetTimer(&timer);
-	}
-	return changed;
+	return runPattern(init, tlightForwardProg);
 }
 
 
@@ -1078,45 +1106,70 @@ static uint8_t lastGreenPhase(const uint8_t init)
 typedef struct
 {
   uint32_t  start; /**< Phase start time. ms from turning the stick on */
-  pPhase_t pPhase; /**< Phase function. Phase function is called every 100ms from @ref start until next phase starts */
+  pPhase_t pPhase; /**< Phase function. Phase function is called every led control step from @ref start until next phase starts */
 }Phase_desc_t;
 
 /**
- * @brief phase function processor. Calls needed phase function every time this function is called starting with
- * @brief @ref Phase_desc_t::start field of it's descriptor.
- * @param desc Descriptor table
+ * @brief Phase timeline. Is built once at the mode start and is processed by @ref processTimeline
+ */
+typedef struct
+{
+  const Phase_desc_t * desc; /**< Phase table. Start times are absolute and grow, the last phase is NULL */
+  uint8_t cursor; /**< The current phase. Only goes forward */
+  uint8_t init; /**< Nonzero if the current phase was not called yet */
+}Timeline_t;
+
+/**
+ * @brief Sets the timeline to the beginning of the phase table
+ * @param tl timeline
+ * @param desc phase table
+ */
+static void timelineStart(Timeline_t * const tl, const Phase_desc_t * const desc)
+{
+  tl->desc = desc;
+  tl->cursor = 0;
+  tl->init = !0;
+}
+
+/**
+ * @brief phase function processor. Calls the phase function of the timeline phase that @ref ms belongs to.
+ * The cursor moves forward only so the cost does not depend on the table length. Skipped phases are not called
+ * @param tl timeline
  * @param nextState out parameter. Becomes nonzero when all table is processed
- * @param ms millisecons from the start
+ * @param ms millisecons from the start of the timeline. Must not decrease
  * @return  nonzero means the led strip must be updated
  */
-static uint8_t processPhaseTable(const Phase_desc_t * const desc,uint8_t * const nextState,const uint32_t ms)
+static uint8_t processTimeline(Timeline_t * const tl,uint8_t * const nextState,const uint32_t ms)
 {
+	const Phase_desc_t * const desc = tl->desc;
+	uint8_t changed = 0;
 	if (nextState != NULL)
 	{
 		*nextState = 0;
 	}
-	static uint8_t oldPos = 99;
-	uint8_t i = 0;
-	for (; desc[i].pPhase != NULL;i++)
+	while (desc[tl->cursor].pPhase != NULL && ms >= desc[tl->cursor + 1].start)
 	{
-		if (ms >= desc[i].start && ms < desc[i + 1].start)
-		{
-			break;
-		}
+		tl->cursor++;
+		tl->init = !0;
 	}
-	uint8_t changed = 0;
-	if (desc[i].pPhase == NULL)
+	if (desc[tl->cursor].pPhase == NULL)
 	{
 		if (nextState != NULL)
 		{
 			*nextState = !0;
-			oldPos = 99;
 		}
 	}
+	else if (ms >= desc[tl->cursor].start)
+	{
+		changed = desc[tl->cursor].pPhase(tl->init);
+		tl->init = 0;
+		const uint32_t left = desc[tl->cursor + 1].start - ms;
+		timeToPhase = (left < timeToPhase) ? left : timeToPhase;
+	}
 	else
 	{
-		changed = desc[i].pPhase(i != oldPos);
-		oldPos = i;
+		const uint32_t left = desc[tl->cursor].start - ms;
+		timeToPhase = (left < timeToPhase) ? left : timeToPhase;
 	}
 	return changed;
 }
@@ -1135,11 +1188,14 @@ enum
  */
 static uint8_t pitStopCalc(uint32_t const ms,uint8_t * const nextState)
 {
-
-  const uint8_t * const conf = eeemuGetValue();
-  const uint8_t tseq = conf[CH_TSEQ];
-  const uint8_t t1 = conf[CH_T1];
-  const uint8_t t2 = conf[CH_T2];
+  static Phase_desc_t timelineDesc[7];
+  static Timeline_t timeline;
+  if (timeline.desc == NULL)
+  {
+  const Config_t * const conf = eeemuGetConfig();
+  const uint8_t tseq = conf->tseq;
+  const uint8_t t1 = conf->t1;
+  const uint8_t t2 = conf->t2;
 
   const uint16_t yellowPhase_start = tseq - t1 - TLIGHT_WORK_TIME;
   const uint16_t gbPhase_start = tseq - t1;
@@ -1157,7 +1213,11 @@ static uint8_t pitStopCalc(uint32_t const ms,uint8_t * const nextState)
       {green2Phase_start * S, lastGreenPhase},
       {nullPhaseStart * S,NULL}
   };
-  return processPhaseTable(desc,nextState,ms);
+  _Static_assert(sizeof(desc) == sizeof(timelineDesc), "Timeline size mismatch");
+  memcpy(timelineDesc,desc,sizeof(timelineDesc));
+  timelineStart(&timeline,timelineDesc);
+  }
+  return processTimeline(&timeline,nextState,ms);
 }
 
 /**
@@ -1184,9 +1244,9 @@ static uint8_t tlightTMain(const uint8_t init)
 	static States_t state = STATE_TLIGHT_SLALOM;
 	if (init != 0)
 	{
-		const uint8_t * const conf = eeemuGetValue();
-		const uint8_t rMin = conf[CH_TLIGHT_MIN];
-		const uint8_t rMax = conf[CH_TLIGHT_MAX];
+		const Config_t * const conf = eeemuGetConfig();
+		const uint8_t rMin = conf->tlightMin;
+		const uint8_t rMax = conf->tlightMax;
 		lastStripTime = genRandom(rMin,rMax) * 100 - 100;
 		nstrips = 1;
 		ResetTimer(&timer);
@@ -1251,8 +1311,12 @@ static uint8_t showPower(const uint8_t init)
 
 static uint8_t tlightMode(uint32_t const ms,uint8_t * const nextState)
 {
-	const uint8_t * const conf = eeemuGetValue();
-	const uint8_t rMax = conf[CH_TLIGHT_MAX];
+	static Phase_desc_t timelineDesc[4];
+	static Timeline_t timeline;
+	if (timeline.desc == NULL)
+	{
+	const Config_t * const conf = eeemuGetConfig();
+	const uint8_t rMax = conf->tlightMax;
 	const uint16_t mainTlightModeStart = 2;
 	const uint16_t powerPhaseStart = ((rMax % 10 == 0) ? rMax / 10 : rMax / 10 + 1) + 5 + 2 + 5;
 	const Phase_desc_t desc[]=
@@ -1262,7 +1326,11 @@ static uint8_t tlightMode(uint32_t const ms,uint8_t * const nextState)
 			{powerPhaseStart * S,showPower},
 			{(powerPhaseStart + 5) * S,NULL}
 	};
-	return processPhaseTable(desc,nextState,ms);
+	_Static_assert(sizeof(desc) == sizeof(timelineDesc), "Timeline size mismatch");
+	memcpy(timelineDesc,desc,sizeof(timelineDesc));
+	timelineStart(&timeline,timelineDesc);
+	}
+	return processTimeline(&timeline,nextState,ms);
 }
 
 /**
@@ -1296,8 +1364,12 @@ static uint8_t podnosGreen(const uint8_t init)
 
 static uint8_t podnosMode(uint32_t const ms,uint8_t * const nextState)
 {
-  const uint8_t * const conf = eeemuGetValue();
-  const uint8_t duration = conf[CH_PODNOS_MODE_TIME];
+  static Phase_desc_t timelineDesc[4];
+  static Timeline_t timeline;
+  if (timeline.desc == NULL)
+  {
+  const Config_t * const conf = eeemuGetConfig();
+  const uint8_t duration = conf->podnosModeTime;
   const uint16_t powerPhaseStart = duration + 10;
   const Phase_desc_t desc[]=
   {
@@ -1306,9 +1378,22 @@ static uint8_t podnosMode(uint32_t const ms,uint8_t * const nextState)
       {powerPhaseStart * S,showPower},
       {(powerPhaseStart + 5) * S,NULL}
   };
-  return processPhaseTable(desc,nextState,ms);
+  _Static_assert(sizeof(desc) == sizeof(timelineDesc), "Timeline size mismatch");
+  memcpy(timelineDesc,desc,sizeof(timelineDesc));
+  timelineStart(&timeline,timelineDesc);
+  }
+  return processTimeline(&timeline,nextState,ms);
 }
 
+static const uint8_t show234Prog[] =
+{
+	PAT_FILL(BLACK),
+	PAT_STRIP(YELLOW, 2 - 1),
+	PAT_STRIP(YELLOW, 3 - 1),
+	PAT_STRIP(YELLOW, 4 - 1),
+	PAT_END
+};
+
 /**
  * @fn uint8_t show234(const uint8_t)
  * @brief This is one of safety car script stages. It shows 2,3,4 lights using @ref YELLOW color
@@ -1318,18 +1403,19 @@ static uint8_t podnosMode(uint32_t const ms,uint8_t * const nextState)
  */
 static uint8_t show234(const uint8_t init)
 {
-	uint8_t changed = 0;
-	if (init != 0)
-	{
-		showFull(BLACK);
-		dispStrip(YELLOW, 2 - 1);
-		dispStrip(YELLOW, 3 - 1);
-		dispStrip(YELLOW, 4 - 1);
-		changed = !0;
-	}
-	return changed;
+	return runPattern(init, show234Prog);
 }
 
+static const uint8_t show1245Prog[] =
+{
+	PAT_FILL(BLACK),
+	PAT_STRIP(YELLOW, 1 - 1),
+	PAT_STRIP(YELLOW, 2 - 1),
+	PAT_STRIP(YELLOW, 4 - 1),
+	PAT_STRIP(YELLOW, 5 - 1),
+	PAT_END
+};
+
 /**
  * @fn uint8_t show1245(const uint8_t)
  * @brief This is one of safety car script stages. It shows 1,2,4,5 lights using @ref YELLOW color
@@ -1339,19 +1425,17 @@ static uint8_t show234(const uint8_t init)
  */
 static uint8_t show1245(const uint8_t init)
 {
-	uint8_t changed = 0;
-	if (init != 0)
-	{
-		showFull(BLACK);
-		dispStrip(YELLOW, 1 - 1);
-		dispStrip(YELLOW, 2 - 1);
-		dispStrip(YELLOW, 4 - 1);
-		dispStrip(YELLOW, 5 - 1);
-		changed = !0;
-	}
-	return changed;
+	return runPattern(init, show1245Prog);
 }
 
+static const uint8_t show15Prog[] =
+{
+	PAT_FILL(BLACK),
+	PAT_STRIP(YELLOW, 1 - 1),
+	PAT_STRIP(YELLOW, 5 - 1),
+	PAT_END
+};
+
 /**
  * @fn uint8_t show15(const uint8_t)
  * @brief This is one of safety car script stages. It shows 1,5 lights using @ref YELLOW color
@@ -1361,15 +1445,7 @@ static uint8_t show1245(const uint8_t init)
  */
 static uint8_t show15(const uint8_t init)
 {
-	uint8_t changed = 0;
-	if (init != 0)
-	{
-		showFull(BLACK);
-		dispStrip(YELLOW, 1 - 1);
-		dispStrip(YELLOW, 5 - 1);
-		changed = !0;
-	}
-	return changed;
+	return runPattern(init, show15Prog);
 }
 
 /**
@@ -1394,7 +1470,7 @@ static uint8_t showOff(const uint8_t init)
 
 static uint8_t scMode(uint32_t const ms)
 {
-  const Phase_desc_t desc[]=
+  static const Phase_desc_t desc[]=
   {
       {0   * S / 10, showOff},
       {10  * S / 10, show234},
@@ -1420,6 +1496,7 @@ static uint8_t scMode(uint32_t const ms)
 
   static States_t state = STATE_IDLE;
   static uint32_t timer = 0;
+  static Timeline_t timeline;
   uint8_t tableEnded;
   static uint32_t currentMs = 0;
   uint8_t changed = 0;
@@ -1434,14 +1511,16 @@ static uint8_t scMode(uint32_t const ms)
 	  if (IsExpiredTimer(&timer,500) != 0)
 	  {
 		  currentMs = ms;
+		  timelineStart(&timeline,desc);
 		  state = STATE_SC_MAIN;
 	  }
 	  break;
   case STATE_SC_MAIN:
-	  changed = processPhaseTable(desc,&tableEnded,ms - currentMs);
+	  changed = processTimeline(&timeline,&tableEnded,ms - currentMs);
 	  if (tableEnded != 0)
 	  {
 		  currentMs = ms;
+		  timelineStart(&timeline,desc);
 	  }
 	  break;
   default:
@@ -1459,17 +1538,25 @@ static const uint32_t k2hOffRedMs = 300;
 static const uint32_t greenPixelMs = 8 * S;
 static const uint32_t bluePixelMs = 10 * S;
 
+/**
+ * @brief Draws the bright two pixels "head" at n pixels below the top and the dark "tail" up to the top on both rows
+ */
+#define PAT_HEAD_WITH_FADE(bright,dark) \
+	PAT_DOTS(PAT_DOTS_ROWS | PAT_DOTS_FROM_N | PAT_DOTS_NEG_N, (dark), NLEDS / 2 - 1, NLEDS / 2 - 1, 1), \
+	PAT_DOTS(PAT_DOTS_ROWS | PAT_DOTS_FROM_N | PAT_DOTS_TO_N | PAT_DOTS_NEG_N, (bright), NLEDS / 2 - 1, NLEDS / 2, 1)
+
+
+static const uint8_t darkPhaseProg[] =
+{
+	PAT_LOOP(0),
+		PAT_FILL(BLACK), PAT_POWER, PAT_WAIT(k2hOnDarkMs),
+		PAT_FILL(BLACK), PAT_WAIT(k2hOffDarkMs),
+	PAT_NEXT
+};
 
 static uint8_t darkPhase(const uint8_t _init)
 {
-    static const Blink_t blinkDesc =
-    {
-            .on = k2hOnDarkMs,
-            .off = k2hOffDarkMs,
-            .pOnPhase = showPower,
-            .pOffPhase = showOff
-    };
-	return blink(_init,&blinkDesc);
+	return runPattern(_init, darkPhaseProg);
 }
 
 static uint8_t allGreen(const uint8_t _init)
@@ -1477,16 +1564,17 @@ static uint8_t allGreen(const uint8_t _init)
     return showFullWithInit(GREEN,_init);
 }
 
+static const uint8_t allGreenBlinkProg[] =
+{
+	PAT_LOOP(0),
+		PAT_FILL(GREEN), PAT_WAIT(k2hOnMs),
+		PAT_FILL(BLACK), PAT_WAIT(k2hOffMs),
+	PAT_NEXT
+};
+
 static uint8_t allGreenBlink(const uint8_t _init)
 {
-    static const Blink_t blinkDesc =
-    {
-            .on = k2hOnMs,
-            .off = k2hOffMs,
-            .pOnPhase = allGreen,
-            .pOffPhase = showOff
-    };
-    return blink(_init, &blinkDesc);
+	return runPattern(_init, allGreenBlinkProg);
 }
 
 
@@ -1495,16 +1583,17 @@ static uint8_t allRed(const uint8_t _init)
     return showFullWithInit(RED,_init);
 }
 
+static const uint8_t allRedBlinkProg[] =
+{
+	PAT_LOOP(0),
+		PAT_FILL(RED), PAT_WAIT(k2hOnRedMs),
+		PAT_FILL(BLACK), PAT_WAIT(k2hOffRedMs),
+	PAT_NEXT
+};
+
 static uint8_t allRedBlink(const uint8_t _init)
 {
-    static const Blink_t blinkDesc =
-    {
-            .on = k2hOnRedMs,
-            .off = k2hOffRedMs,
-            .pOnPhase = allRed,
-            .pOffPhase = showOff
-    };
-    return blink(_init, &blinkDesc);
+	return runPattern(_init, allRedBlinkProg);
 }
 
 static uint8_t allBlue(const uint8_t _init)
@@ -1512,223 +1601,123 @@ static uint8_t allBlue(const uint8_t _init)
 	return showFullWithInit(BLUE,_init);
 }
 
-static void fill2PixelsWithFade(const Colors_t _bright, const Colors_t _dark, const uint8_t _bottom, const uint8_t _top)
-{
-    const uint8_t bottom = (_bottom > _top ) ? _bottom : _top;
-    const uint8_t top =    (_bottom > _top ) ? _top : _bottom;
-    if (bottom - top > 1)
-    {
-        fill2Pixels(_dark, bottom, top);
-    }
 
-    if (bottom == top)
-    {
-        put2pixels(_bright,top);
-    }
-    else
-    {
-        put2pixels(_bright,top);
-        put2pixels(_bright,top + 1);
-    }
-}
+static const uint8_t oneByOneGreenProg[] =
+{
+	PAT_SET(1),
+	PAT_LOOP(0),
+		PAT_LOOP(greenPixelMs / (k2hOnMs + k2hOffMs)),
+			PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS, BLUE, NLEDS / 2 - 1 - 59, NLEDS / 2 - 1 - 59, 1),
+			PAT_HEAD_WITH_FADE(GREEN, GREEN10), PAT_WAIT(k2hOnMs),
+			PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS, BLUE, NLEDS / 2 - 1 - 59, NLEDS / 2 - 1 - 59, 1),
+			PAT_WAIT(k2hOffMs),
+		PAT_NEXT,
+		PAT_INC(58),
+	PAT_NEXT
+};
 
 static uint8_t oneByOneGreen(const uint8_t _init)
 {
-    static uint8_t onPhase = 0;
-    static uint32_t blinktimer = 0;
-    static uint32_t nextPostimer = 0;
-    static uint8_t pos = 0;
-    uint8_t changed = 0;
-    if ( 0 != _init )
-    {
-        onPhase = !0;
-        ResetTimer(&blinktimer);
-        ResetTimer(&nextPostimer);
-        changed = !0;
-        pos = 1;
-        showFull(BLACK);
-        put2pixels(BLUE,NLEDS / 2 - 1 - 59);
-        fill2PixelsWithFade(GREEN, GREEN10, NLEDS / 2 - 1, NLEDS / 2 - 1 - pos);
-    }
-    else
-    {
-        if (IsExpiredTimer(&nextPostimer,greenPixelMs) != 0)
-        {
-            pos = ( pos >= 58 ) ? 58 : pos + 1;
-            onPhase = !0;
-            ResetTimer(&blinktimer);
-            ResetTimer(&nextPostimer);
-            changed = !0;
-            showFull(BLACK);
-            put2pixels(BLUE,NLEDS / 2 - 1 - 59);
-            fill2PixelsWithFade(GREEN, GREEN10, NLEDS / 2 - 1, NLEDS / 2 - 1 - pos);
-        }
-        else
-        {
-        if (0 != onPhase)
-        {
-            if (IsExpiredTimer(&blinktimer,k2hOnMs) != 0)
-            {
-                showFull(BLACK);
-                ResetTimer(&blinktimer);
-                put2pixels(BLUE,NLEDS / 2 - 1 - 59);
-                onPhase = 0;
-                changed = !0;
-            }
-        }
-        else
-        {
-            if (IsExpiredTimer(&blinktimer,k2hOffMs) != 0)
-            {
-                ResetTimer(&blinktimer);
-                onPhase = !0;
-                changed = !0;
-                showFull(BLACK);
-                put2pixels(BLUE,NLEDS / 2- 1 - 59);
-                fill2PixelsWithFade(GREEN, GREEN10, NLEDS / 2 - 1, NLEDS / 2 - 1 - pos);
-            }
-        }
-        }
-    }
-    return changed;
+	return runPattern(_init, oneByOneGreenProg);
 }
 
 
+static const uint8_t oneByOneBlueProg[] =
+{
+	PAT_SET(59),
+	PAT_LOOP(0),
+		PAT_LOOP(bluePixelMs / (k2hOnMs + k2hOffMs)),
+			PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS, RED, 0, 0, 1),
+			PAT_HEAD_WITH_FADE(BLUE, BLUE10), PAT_WAIT(k2hOnMs),
+			PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS, RED, 0, 0, 1),
+			PAT_WAIT(k2hOffMs),
+		PAT_NEXT,
+		PAT_INC(59 + 12),
+	PAT_NEXT
+};
+
 static uint8_t oneByOneBlue(const uint8_t _init)
 {
-    static uint8_t onPhase = 0;
-    static uint32_t blinktimer = 0;
-    static uint32_t nextPostimer = 0;
-    static uint8_t pos = 0;
-    uint8_t changed = 0;
-    if ( 0 != _init )
-    {
-        onPhase = !0;
-        ResetTimer(&blinktimer);
-        ResetTimer(&nextPostimer);
-        changed = !0;
-        pos = 0;
-        showFull(BLACK);
-        put2pixels(RED,0);
-        fill2PixelsWithFade(BLUE, BLUE10, NLEDS / 2 - 1, NLEDS / 2 - 1 - (59 + pos));
-    }
-    else
-    {
-        if (IsExpiredTimer(&nextPostimer, bluePixelMs) != 0)
-        {
-            pos = ( pos >= 12 ) ? 12 : pos + 1;
-            onPhase = !0;
-            ResetTimer(&blinktimer);
-            ResetTimer(&nextPostimer);
-            changed = !0;
-            showFull(BLACK);
-            put2pixels(RED,0);
-            fill2PixelsWithFade(BLUE, BLUE10, NLEDS / 2 - 1, NLEDS / 2 - 1 -(59 + pos));
-        }
-        else
-        {
-        if (0 != onPhase)
-        {
-            if (IsExpiredTimer(&blinktimer,k2hOnMs) != 0)
-            {
-                showFull(BLACK);
-                ResetTimer(&blinktimer);
-                put2pixels(RED,0);
-                onPhase = 0;
-                changed = !0;
-            }
-        }
-        else
-        {
-            if (IsExpiredTimer(&blinktimer,k2hOffMs) != 0)
-            {
-                ResetTimer(&blinktimer);
-                onPhase = !0;
-                changed = !0;
-                showFull(BLACK);
-                put2pixels(RED,0);
-                fill2PixelsWithFade(BLUE, BLUE10, NLEDS / 2 - 1, NLEDS / 2 - 1 - (59 + pos));
-            }
-        }
-        }
-    }
-    return changed;
+	return runPattern(_init, oneByOneBlueProg);
 }
 
 static uint8_t k2hMode(uint32_t const ms,uint8_t * const nextState)
 {
-	const uint32_t phasesStart[] = {0, 24 * MIN, 44 * MIN, 64 * MIN, 84 * MIN};
-	const Phase_desc_t desc[] =
+#define K2H_PHASES_START(n) ((n) == 0 ? 0 : (4 + 20 * (n)) * MIN) /* 0, 24, 44, 64, 84 minutes */
+	static const Phase_desc_t desc[] =
 	{
-			{phasesStart[0] + 0 * S, darkPhase},
-			{phasesStart[0] + 14 * MIN, allGreenBlink},
-			{phasesStart[0] + 14 * MIN + 16 * S, oneByOneGreen},
-			{phasesStart[0] + 14 * MIN + 16 * S + 464 * S, oneByOneBlue},
-			{phasesStart[0] + 14 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
-
-			{phasesStart[1] + 5 * S, darkPhase},
-			{phasesStart[1] + 10 * MIN, allGreenBlink},
-			{phasesStart[1] + 10 * MIN + 16 * S, oneByOneGreen},
-			{phasesStart[1] + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
-			{phasesStart[1] + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
-
-			{phasesStart[2] + 5 * S, darkPhase},
-			{phasesStart[2] + 10 * MIN, allGreenBlink},
-			{phasesStart[2] + 10 * MIN + 16 * S, oneByOneGreen},
-			{phasesStart[2] + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
-			{phasesStart[2] + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
-
-			{phasesStart[3] + 5 * S, darkPhase},
-			{phasesStart[3] + 10 * MIN, allGreenBlink},
-			{phasesStart[3] + 10 * MIN + 16 * S, oneByOneGreen},
-			{phasesStart[3] + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
-			{phasesStart[3] + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
-
-			{phasesStart[4] + 5 * S, darkPhase},
-			{phasesStart[4] + 10 * MIN, allGreenBlink},
-			{phasesStart[4] + 10 * MIN + 16 * S, oneByOneGreen},
-			{phasesStart[4] + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
-			{phasesStart[4] + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
-
-			{phasesStart[4] + 10 * MIN + 16 * S + 464 * S + 120 * S + 5 * S, NULL}
+			{K2H_PHASES_START(0) + 0 * S, darkPhase},
+			{K2H_PHASES_START(0) + 14 * MIN, allGreenBlink},
+			{K2H_PHASES_START(0) + 14 * MIN + 16 * S, oneByOneGreen},
+			{K2H_PHASES_START(0) + 14 * MIN + 16 * S + 464 * S, oneByOneBlue},
+			{K2H_PHASES_START(0) + 14 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
+
+			{K2H_PHASES_START(1) + 5 * S, darkPhase},
+			{K2H_PHASES_START(1) + 10 * MIN, allGreenBlink},
+			{K2H_PHASES_START(1) + 10 * MIN + 16 * S, oneByOneGreen},
+			{K2H_PHASES_START(1) + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
+			{K2H_PHASES_START(1) + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
+
+			{K2H_PHASES_START(2) + 5 * S, darkPhase},
+			{K2H_PHASES_START(2) + 10 * MIN, allGreenBlink},
+			{K2H_PHASES_START(2) + 10 * MIN + 16 * S, oneByOneGreen},
+			{K2H_PHASES_START(2) + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
+			{K2H_PHASES_START(2) + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
+
+			{K2H_PHASES_START(3) + 5 * S, darkPhase},
+			{K2H_PHASES_START(3) + 10 * MIN, allGreenBlink},
+			{K2H_PHASES_START(3) + 10 * MIN + 16 * S, oneByOneGreen},
+			{K2H_PHASES_START(3) + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
+			{K2H_PHASES_START(3) + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
+
+			{K2H_PHASES_START(4) + 5 * S, darkPhase},
+			{K2H_PHASES_START(4) + 10 * MIN, allGreenBlink},
+			{K2H_PHASES_START(4) + 10 * MIN + 16 * S, oneByOneGreen},
+			{K2H_PHASES_START(4) + 10 * MIN + 16 * S + 464 * S, oneByOneBlue},
+			{K2H_PHASES_START(4) + 10 * MIN + 16 * S + 464 * S + 120 * S, allRedBlink},
+
+			{K2H_PHASES_START(4) + 10 * MIN + 16 * S + 464 * S + 120 * S + 5 * S, NULL}
 	};
-	return processPhaseTable(desc,nextState,ms);
+	static Timeline_t timeline;
+	if (timeline.desc == NULL)
+	{
+		timelineStart(&timeline,desc);
+	}
+	return processTimeline(&timeline,nextState,ms);
 }
 
-static uint8_t pitInviteMode(const uint32_t ms)
+/**
+ * @brief Pit invite mode. Strips in the configured color run to the top, the battery level is on the handle.
+ * Is played from a keyframe stream. Strip positions are the same as in @ref dispStrip
+ * @param ms time from the mode start. The stream starts at the mode start, so the frames change at multiples of 500ms
+ * @return nonzero means the led strip must be updated
+ */
+static uint8_t pitInviteMode(uint32_t const ms)
 {
-	uint8_t retval = 0;
-	static uint8_t oldPhase = 99;
-	const uint8_t phase = (ms / 500) % 6;
-	const uint8_t strips[6][5] =
+#define KF_INVITE_STRIP(n,color) KF_SPAN(1 + 15 * (n), 10, (color))
+	static const uint8_t stream[] =
 	{
-			{!0,  0,  0,  0,  0},
-			{!0, !0,  0,  0,  0},
-			{ 0, !0, !0,  0,  0},
-			{ 0,  0, !0, !0,  0},
-			{ 0,  0,  0, !0, !0},
-			{ 0,  0,  0,  0, !0}
+		KF_FRAME(500, 3), KF_SPAN(0, NLEDS / 2, BLACK), KF_INVITE_STRIP(0, KF_COLOR_INK), KF_SPAN(0, 1, KF_COLOR_POWER),
+		KF_FRAME(500, 2), KF_INVITE_STRIP(1, KF_COLOR_INK), KF_SPAN(0, 1, KF_COLOR_POWER),
+		KF_FRAME(500, 3), KF_INVITE_STRIP(0, BLACK), KF_INVITE_STRIP(2, KF_COLOR_INK), KF_SPAN(0, 1, KF_COLOR_POWER),
+		KF_FRAME(500, 3), KF_INVITE_STRIP(1, BLACK), KF_INVITE_STRIP(3, KF_COLOR_INK), KF_SPAN(0, 1, KF_COLOR_POWER),
+		KF_FRAME(500, 3), KF_INVITE_STRIP(2, BLACK), KF_INVITE_STRIP(4, KF_COLOR_INK), KF_SPAN(0, 1, KF_COLOR_POWER),
+		KF_FRAME(500, 2), KF_INVITE_STRIP(3, BLACK), KF_SPAN(0, 1, KF_COLOR_POWER),
+		KF_LOOP
 	};
-	const uint8_t * const conf = eeemuGetValue();
-	const uint8_t value = conf[CH_PITINVITE_COLOR];
-	const uint8_t maxValue = sizeof(num2color) / sizeof(num2color[0]) - 1;
-	const Colors_t color = num2color[(value > maxValue) ? maxValue : value];
-	if (phase != oldPhase)
+	static Keyframe_Player_t player;
+	const uint32_t now = GetTicksCounter();
+	if (player.stream == NULL)
 	{
-		retval = !0;
-		showFull(BLACK);
-
-		for (uint8_t strip = 0; strip < 5; strip++)
-		{
-			if (strips[phase][strip] != 0)
-			{
-				dispStrip(color,strip);
-			}
-		}
-		put2pixels(getPowerColor(),0);
-		oldPhase = phase;
+		const Config_t * const conf = eeemuGetConfig();
+		const uint8_t value = conf->pitInviteColor;
+		const uint8_t maxValue = sizeof(num2color) / sizeof(num2color[0]) - 1;
+		Keyframe_Start(&player, stream, num2color[(value > maxValue) ? maxValue : value], getPowerColor, now - ms);
 	}
-	return retval;
+	const uint8_t changed = Keyframe_Run(&player, now);
+	const uint32_t left = Keyframe_TimeToNext(&player, now);
+	timeToPhase = (left < timeToPhase) ? left : timeToPhase;
+	return changed;
 }
 /*********************** Iron man **********************************/
 #define LA (90)
@@ -1738,52 +1727,54 @@ static uint8_t pitInviteMode(const uint32_t ms)
 
 #define LC (150)
 #define LC1 (30)
-static uint8_t tlightPre(const uint8_t _init, const Colors_t _color)
-{
-    static uint32_t timer;
-    static uint8_t left;
-    uint8_t retval = 0;
-    if (0 != _init)
-    {
-        left = !0;
-        ResetTimer(&timer);
-        retval = !0;
-    }
-    else if (IsExpiredTimer(&timer, 500))
-    {
-        ResetTimer(&timer);
-        left = !left;
-        retval = !0;
-    }
-    if (retval != 0)
-    {
-        showFull(BLACK);
-        if (left != 0)
-        {
-            fill2Pixels(_color,0,11);
-        }
-        else
-        {
-            fill2Pixels(_color,60,71);
-        }
-    }
-    return retval;
-}
+/**
+ * @brief Pre-start pattern: the handle and the top halves of the strip blink by turns
+ */
+#define PAT_TLIGHT_PRE(color) \
+	PAT_LOOP(0), \
+		PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS, (color), 0, 11, 1), PAT_WAIT(500), \
+		PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS, (color), 60, 71, 1), PAT_WAIT(500), \
+	PAT_NEXT
+
+static const uint8_t tlightPreRedProg[] = {PAT_TLIGHT_PRE(RED)};
 
 static uint8_t tlightPreRed(const uint8_t _init)
 {
-	return tlightPre(_init, RED);
+	return runPattern(_init, tlightPreRedProg);
 }
 
+static const uint8_t tlightPreGreenProg[] = {PAT_TLIGHT_PRE(GREEN)};
+
 static uint8_t tlightPreGreen(const uint8_t _init)
 {
-	return tlightPre(_init, GREEN);
+	return runPattern(_init, tlightPreGreenProg);
 }
 
+static const uint8_t tlightPreBlueProg[] = {PAT_TLIGHT_PRE(BLUE)};
+
 static uint8_t tlightPreBlue(const uint8_t _init)
 {
-	return tlightPre(_init, BLUE);
-}
+	return runPattern(_init, tlightPreBlueProg);
+}
+
+#define PAT_IRON_B_DOTS PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROWS | PAT_DOTS_MIRROR | PAT_DOTS_FROM_N | PAT_DOTS_TO_N, RED, 0, 6, 2)
+/* 1s blink, the dots move by one pixel every 24s. The first move is at the 12th "on" time */
+static const uint8_t ironB1_29Prog[] =
+{
+	PAT_SET(0),
+	PAT_WAIT(1 * S), PAT_FILL(BLACK), PAT_WAIT(1 * S),
+	PAT_LOOP(11),
+		PAT_IRON_B_DOTS, PAT_WAIT(1 * S),
+		PAT_FILL(BLACK), PAT_WAIT(1 * S),
+	PAT_NEXT,
+	PAT_LOOP(0),
+		PAT_INC(29),
+		PAT_LOOP(12),
+			PAT_IRON_B_DOTS, PAT_WAIT(1 * S),
+			PAT_FILL(BLACK), PAT_WAIT(1 * S),
+		PAT_NEXT,
+	PAT_NEXT
+};
 
 /**
  * @brief IronMan phase B (race) subphases 1-29. Last phase will be interrupted by the scheduler and changed to @ref ironB30
@@ -1792,171 +1783,76 @@ static uint8_t tlightPreBlue(const uint8_t _init)
  */
 static uint8_t ironB1_29(const uint8_t _init)
 {
-    static uint8_t subphase = 0; /* 0 based, 0:29 */
-    static uint8_t on = 0;
-    static uint32_t blinkTimer = 0;
-    static uint32_t subphaseTimer = 0;
-    const uint32_t subphasePeriod = 24 * S;
-    const uint8_t nphases = 30;
-    const uint32_t blinkPeriod = 1 * S;
-    uint8_t retval = 0;
-
-    if (_init != 0)
-    {
-        subphase = 0;
-        ResetTimer(&blinkTimer);
-        ResetTimer(&subphaseTimer);
-        on = 0;
-    }
-    if (IsExpiredTimer(&subphaseTimer, subphasePeriod) != 0)
-    {
-        subphase = (subphase >= nphases - 1 ) ? nphases - 1 : subphase + 1;
-        ResetTimer(&subphaseTimer);
-    }
-    if (IsExpiredTimer(&blinkTimer, blinkPeriod) != 0)
-    {
-        ResetTimer(&blinkTimer);
-        showFull(BLACK);
-        if (on != 0)
-        {
-            for (uint8_t i = subphase; i <= subphase + 6; i += 2)
-            {
-                put2pixels(RED,i);
-                put2pixels(RED,71 - i);
-            }
-        }
-        retval = !0;
-        on = !on;
-    }
-    return retval;
+	return runPattern(_init, ironB1_29Prog);
 }
 
-static uint8_t ironB30row(const uint8_t _init, const uint8_t _row)
-{
-    uint8_t changed = 0;
-    if (_init != 0)
-    {
-        showFull(BLACK);
-        for (uint8_t i = 29; i <= 29 + 6; i += 2)
-        {
-            putPixel(_row, i, RED);
-            putPixel(_row, 71 - i, RED);
-        }
 
-        changed = !0;
-    }
-    return changed;
-}
 
-static uint8_t ironB30row0(const uint8_t _init)
-{
-    return ironB30row(_init, 0);
-}
 
-static uint8_t ironB30row1(const uint8_t _init)
+static const uint8_t ironB30Prog[] =
 {
-    return ironB30row(_init, 1);
-}
-
+	PAT_LOOP(0),
+		PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROW0 | PAT_DOTS_MIRROR, RED, 29, 29 + 6, 2), PAT_WAIT(S / 2),
+		PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROW1 | PAT_DOTS_MIRROR, RED, 29, 29 + 6, 2), PAT_WAIT(S / 2),
+	PAT_NEXT
+};
 
 static uint8_t ironB30(const uint8_t _init)
 {
-    static const Blink_t blinkDesc =
-            {
-                    .on = S / 2,
-                    .off = S / 2,
-                    .pOnPhase = ironB30row0,
-                    .pOffPhase = ironB30row1
-            };
-    return blink(_init,&blinkDesc);
-}
+	return runPattern(_init, ironB30Prog);
+}
+
+/* n is twice the subphase: pixel pairs 2i, 2i + 1 for i = subphase, subphase + 2, ... subphase + 8 */
+#define PAT_IRON_C_DOTS \
+	PAT_FILL(BLACK), \
+	PAT_DOTS(PAT_DOTS_ROWS | PAT_DOTS_MIRROR | PAT_DOTS_FROM_N | PAT_DOTS_TO_N, GREEN, 0, 16, 4), \
+	PAT_DOTS(PAT_DOTS_ROWS | PAT_DOTS_MIRROR | PAT_DOTS_FROM_N | PAT_DOTS_TO_N, GREEN, 1, 17, 4)
+/* 1s blink, the dots move every 15s that is in the middle of the blink period every other time */
+static const uint8_t ironC1_10Prog[] =
+{
+	PAT_SET(0),
+	PAT_LOOP(0),
+		PAT_LOOP(7),
+			PAT_WAIT(1 * S), PAT_FILL(BLACK),
+			PAT_WAIT(1 * S), PAT_IRON_C_DOTS,
+		PAT_NEXT,
+		PAT_WAIT(1 * S), PAT_FILL(BLACK),
+		PAT_INC(2 * 9), PAT_INC(2 * 9),
+		PAT_LOOP(7),
+			PAT_WAIT(1 * S), PAT_IRON_C_DOTS,
+			PAT_WAIT(1 * S), PAT_FILL(BLACK),
+		PAT_NEXT,
+		PAT_WAIT(1 * S),
+		PAT_INC(2 * 9), PAT_INC(2 * 9),
+		PAT_IRON_C_DOTS,
+	PAT_NEXT
+};
+
 static uint8_t ironC1_10(const uint8_t _init)
 {
-    static uint8_t subphase = 0; /* 0 based, 0:28 */
-    static uint8_t on = 0;
-    static uint32_t blinkTimer = 0;
-    static uint32_t subphaseTimer = 0;
-    const uint32_t subphasePeriod = 15 * S;
-    const uint8_t nphases = 10;
-    const uint32_t blinkPeriod = 1 * S;
-    uint8_t retval = 0;
-
-    if (_init != 0)
-    {
-        subphase = 0;
-        ResetTimer(&blinkTimer);
-        ResetTimer(&subphaseTimer);
-        on = 0;
-    }
-    if (IsExpiredTimer(&subphaseTimer, subphasePeriod) != 0)
-    {
-        subphase = (subphase >= nphases - 1 ) ? nphases - 1 : subphase + 1;
-        ResetTimer(&subphaseTimer);
-    }
-    if (IsExpiredTimer(&blinkTimer, blinkPeriod) != 0)
-    {
-        ResetTimer(&blinkTimer);
-        showFull(BLACK);
-        if (on != 0)
-        {
-            for (uint8_t i = subphase; i <= subphase + 9; i += 2)
-            {
-                put2pixels(GREEN, i * 2 + 0);
-                put2pixels(GREEN, i * 2 + 1);
-                put2pixels(GREEN, 71 - (i * 2 + 0));
-                put2pixels(GREEN, 71 - (i * 2 + 1));
-            }
-        }
-        retval = !0;
-        on = !on;
-    }
-    return retval;
-
+	return runPattern(_init, ironC1_10Prog);
 }
 
-static uint8_t ironC11green(const uint8_t _init,const uint8_t _row)
-{
-    uint8_t changed = 0;
-    if (_init != 0)
-    {
-        showFull(BLACK);
-        for (uint8_t i = 18; i < 54; i++)
-        {
-            putPixel(_row, i, GREEN);
-        }
 
-        changed = !0;
-    }
-    return changed;
-}
 
-static uint8_t ironC11green0(const uint8_t _init)
-{
-    return ironC11green(_init, 0);
-}
 
-static uint8_t ironC11green1(const uint8_t _init)
+static const uint8_t ironC11Prog[] =
 {
-    return ironC11green(_init, 1);
-}
-
+	PAT_LOOP(0),
+		PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROW0, GREEN, 18, 53, 1), PAT_WAIT(S / 2),
+		PAT_FILL(BLACK), PAT_DOTS(PAT_DOTS_ROW1, GREEN, 18, 53, 1), PAT_WAIT(S / 2),
+	PAT_NEXT
+};
 
 static uint8_t ironC11(const uint8_t _init)
 {
-    static const Blink_t blinkDesc =
-            {
-                    .on = S / 2,
-                    .off = S / 2,
-                    .pOnPhase = ironC11green0,
-                    .pOffPhase = ironC11green1
-            };
-    return blink(_init,&blinkDesc);
+	return runPattern(_init, ironC11Prog);
 }
 
 
 static uint8_t ironmanMode(uint32_t const ms,uint8_t * const nextState)
 {
-    static uint8_t firstTime = !0;
+    static Timeline_t timeline;
     static Phase_desc_t phaseTable[] =
             {
                     {.start = 0, .pPhase = tlightPreRed},
@@ -1985,9 +1881,8 @@ static uint8_t ironmanMode(uint32_t const ms,uint8_t * const nextState)
                     {.start = (5 + LA + 3 * (LB + LC + LC1) + LB) * S, darkPhase},
                     {.start = (5 + LA + 3 * (LB + LC + LC1) + LB + LA) * S, NULL}
                 };
-    if (firstTime)
+    if (timeline.desc == NULL)
     {
-        firstTime = 0;
         const uint32_t rand1 = genRandom(7,15) * S;
         const uint32_t rand2 = genRandom(1,5) * S / 2;
         const uint8_t nelements = sizeof(phaseTable) / sizeof(phaseTable[0]);
@@ -2001,13 +1896,14 @@ static uint8_t ironmanMode(uint32_t const ms,uint8_t * const nextState)
         {
             phaseTable[rand2pahse].start += rand2;
         }
+        timelineStart(&timeline,phaseTable);
     }
-    return processPhaseTable(phaseTable, nextState, ms);
+    return processTimeline(&timeline, nextState, ms);
 }
 
 static uint8_t pit2(uint32_t const ms,uint8_t * const nextState)
 {
-    static uint8_t firstTime = !0;
+    static Timeline_t timeline;
     static Phase_desc_t phaseTable[] =
             {
                     {.start = 0, .pPhase = tlightPreRed},
@@ -2024,9 +1920,8 @@ static uint8_t pit2(uint32_t const ms,uint8_t * const nextState)
 					{.start = (20 + 40 + 80 + 40 + 20 + 40 + 80 + 40) * S, .pPhase = allRed}, /* 360 */
                     {.start = (20 + 40 + 80 + 40 + 20 + 40 + 80 + 40 + 40) * S, NULL} /* 400 */
                 };
-    if (firstTime)
+    if (timeline.desc == NULL)
     {
-        firstTime = 0;
         const uint32_t rand1 = genRandom(2,6) * S;
         const uint32_t rand2 = genRandom(1,5) * S / 2;
         const uint8_t nrandom_elements  = 3;
@@ -2040,8 +1935,9 @@ static uint8_t pit2(uint32_t const ms,uint8_t * const nextState)
         {
             phaseTable[rand2pahse].start += rand2;
         }
+        timelineStart(&timeline,phaseTable);
     }
-    return processPhaseTable(phaseTable, nextState, ms);
+    return processTimeline(&timeline, nextState, ms);
 }
 
 /**
@@ -2065,7 +1961,7 @@ static uint8_t lock(void)
       if (IsExpiredTimer(&timer,19000) != 0)
       {
         ResetTimer(&timer);
-        setBrightness(eeemuGetValue()[CH_BRIGHTNESS]);
+        setBrightness(eeemuGetConfig()->brightness);
 
         for (uint8_t i = 1; i < 10; i++)
         {
@@ -2104,12 +2000,14 @@ void led_control(uint32_t const ms)
 
 	static States_t state = STATE_IDLE;
 	uint8_t isPressed = IsPressed(B_CONFIG);
-	const uint8_t * const conf = eeemuGetValue();
-	const Working_Mode_t mode = conf[CH_MODE];
-	const uint8_t brightness = conf[CH_BRIGHTNESS];
+	const Config_t * const conf = eeemuGetConfig();
+	const Working_Mode_t mode = conf->mode;
+	const uint8_t brightness = conf->brightness;
 	setBrightness(brightness);
 	uint8_t changed = 0;
 	uint8_t nextState = 0;
+	timeToPhase = UINT32_MAX;
+	Clock_ResetNextExpiry();
 	switch(state)
 	{
 	case STATE_IDLE:
@@ -2212,9 +2110,79 @@ void led_control(uint32_t const ms)
 	default:
 		break;
 	}
+	/* Phase functions that are written with software timers wait for them */
+	const uint32_t toExpiry = Clock_TimeToNextExpiry();
+	timeToPhase = (toExpiry < timeToPhase) ? toExpiry : timeToPhase;
 	if (changed != 0)
 	{
 		sendDataToStrip();
 	}
+	else
+	{
+		refreshStrip();
+	}
+}
+
+uint32_t led_control_TimeToPhase(void)
+{
+	return timeToPhase;
+}
+
+const Pattern_Desc_t * led_control_GetPatterns(uint8_t * const n)
+{
+	static const Pattern_Desc_t Patterns[] =
+	{
+		{"tlight", tlightProg, sizeof(tlightProg)},
+		{"tlightReverse", tlightReverseProg, sizeof(tlightReverseProg)},
+		{"tlightForward", tlightForwardProg, sizeof(tlightForwardProg)},
+		{"show234", show234Prog, sizeof(show234Prog)},
+		{"show1245", show1245Prog, sizeof(show1245Prog)},
+		{"show15", show15Prog, sizeof(show15Prog)},
+		{"darkPhase", darkPhaseProg, sizeof(darkPhaseProg)},
+		{"allGreenBlink", allGreenBlinkProg, sizeof(allGreenBlinkProg)},
+		{"allRedBlink", allRedBlinkProg, sizeof(allRedBlinkProg)},
+		{"oneByOneGreen", oneByOneGreenProg, sizeof(oneByOneGreenProg)},
+		{"oneByOneBlue", oneByOneBlueProg, sizeof(oneByOneBlueProg)},
+		{"tlightPreRed", tlightPreRedProg, sizeof(tlightPreRedProg)},
+		{"tlightPreGreen", tlightPreGreenProg, sizeof(tlightPreGreenProg)},
+		{"tlightPreBlue", tlightPreBlueProg, sizeof(tlightPreBlueProg)},
+		{"ironB1_29", ironB1_29Prog, sizeof(ironB1_29Prog)},
+		{"ironB30", ironB30Prog, sizeof(ironB30Prog)},
+		{"ironC1_10", ironC1_10Prog, sizeof(ironC1_10Prog)},
+		{"ironC11", ironC11Prog, sizeof(ironC11Prog)}
+	};
+	*n = sizeof(Patterns) / sizeof(Patterns[0]);
+	return Patterns;
 }
 
+/**
+ * @brief Phase of the timeline benchmark, it does nothing so only the table processing is timed
+ * @param init not used
+ * @return zero, the strip is not changed
+ */
+static uint8_t benchPhase(const uint8_t init)
+{
+	(void)init;
+	return 0;
+}
+
+uint8_t led_control_TimelineStep(const uint32_t ms, uint8_t * const ended)
+{
+	/* The shape of the pit stop timeline with the default config */
+	static const Phase_desc_t Desc[] =
+	{
+		{0 * S, benchPhase},
+		{25 * S, benchPhase},
+		{30 * S, benchPhase},
+		{45 * S, benchPhase},
+		{55 * S, benchPhase},
+		{60 * S, benchPhase},
+		{62 * S, NULL}
+	};
+	static Timeline_t timeline;
+	if (ms == 0)
+	{
+		timelineStart(&timeline, Desc);
+	}
+	return processTimeline(&timeline, ended, ms);
+}
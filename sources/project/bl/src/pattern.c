@@ -0,0 +1,165 @@
+/**
+ * @file pattern.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains led pattern interpreter. Ops draw to the led strip buffer by @ref led_strip functions,
+ * the frame is shown when the interpreter stops at a wait or at the end.
+ */
+#include <stddef.h>
+#include "pattern.h"
+#include "project_conf.h"
+
+/**
+ * @brief Executes @ref PAT_OP_DOTS
+ * @param p interpreter state
+ * @param args op arguments: flags, color, from, to, step
+ */
+static void patternDots(const Pattern_t * const p, const uint8_t * const args)
+{
+	const uint8_t flags = args[0];
+	const Colors_t color = (Colors_t)args[1];
+	const int16_t shift = ((flags & PAT_DOTS_NEG_N) != 0) ? -(int16_t)p->n : (int16_t)p->n;
+	const int16_t from = (int16_t)args[2] + (((flags & PAT_DOTS_FROM_N) != 0) ? shift : 0);
+	const int16_t to = (int16_t)args[3] + (((flags & PAT_DOTS_TO_N) != 0) ? shift : 0);
+	const uint8_t step = (args[4] == 0) ? 1 : args[4];
+	for (int16_t i = (from < 0) ? 0 : from; i <= to && i < NLEDS / 2; i += step)
+	{
+		for (uint8_t row = 0; row < 2; row++)
+		{
+			if ((flags & (PAT_DOTS_ROW0 << row)) != 0)
+			{
+				putPixel(row, (uint8_t)i, color);
+				if ((flags & PAT_DOTS_MIRROR) != 0)
+				{
+					putPixel(row, (uint8_t)(NLEDS / 2 - 1 - i), color);
+				}
+			}
+		}
+	}
+}
+
+void Pattern_Start(Pattern_t * const p, const uint8_t * const prog, const pPowerColorFunc_t getPowerColor, const uint32_t now)
+{
+	p->prog = prog;
+	p->getPowerColor = getPowerColor;
+	p->wake = now;
+	p->pc = 0;
+	p->n = 0;
+	p->depth = 0;
+	p->fault = 0;
+}
+
+uint8_t Pattern_Run(Pattern_t * const p, const uint32_t now)
+{
+	uint8_t changed = 0;
+	uint8_t run = ((int32_t)(now - p->wake) >= 0);
+	for (uint8_t steps = 0; run != 0 && steps < PATTERN_MAX_STEPS; steps++)
+	{
+		const uint8_t * const op = p->prog + p->pc;
+		switch ((Pattern_Op_t)op[0])
+		{
+		case PAT_OP_FILL:
+			showFull((Colors_t)op[1]);
+			changed = !0;
+			p->pc += 2;
+			break;
+		case PAT_OP_STRIP:
+			dispStrip((Colors_t)op[1], op[2]);
+			changed = !0;
+			p->pc += 3;
+			break;
+		case PAT_OP_STRIPS:
+			dispStrips((Colors_t)op[1], p->n);
+			changed = !0;
+			p->pc += 2;
+			break;
+		case PAT_OP_STRIPS_REV:
+			dispStripsRevese((Colors_t)op[1], p->n);
+			changed = !0;
+			p->pc += 2;
+			break;
+		case PAT_OP_DOTS:
+			patternDots(p, op + 1);
+			changed = !0;
+			p->pc += 6;
+			break;
+		case PAT_OP_POWER:
+			if (p->getPowerColor != NULL)
+			{
+				put2pixels(p->getPowerColor(), 0);
+				changed = !0;
+			}
+			p->pc += 1;
+			break;
+		case PAT_OP_SET:
+			p->n = op[1];
+			p->pc += 2;
+			break;
+		case PAT_OP_INC:
+			p->n = (p->n >= op[1]) ? op[1] : p->n + 1;
+			p->pc += 2;
+			break;
+		case PAT_OP_DEC:
+			p->n = (p->n <= op[1]) ? op[1] : p->n - 1;
+			p->pc += 2;
+			break;
+		case PAT_OP_WAIT:
+			p->wake += (uint32_t)op[1] | ((uint32_t)op[2] << 8);
+			p->pc += 3;
+			run = ((int32_t)(now - p->wake) >= 0);
+			break;
+		case PAT_OP_LOOP:
+			if (p->depth == PATTERN_LOOP_DEPTH)
+			{
+				p->fault = !0; /* The body would run with the wrong loop */
+				run = 0;
+				break;
+			}
+			p->loops[p->depth].start = p->pc + 2;
+			p->loops[p->depth].left = op[1];
+			p->depth++;
+			p->pc += 2;
+			break;
+		case PAT_OP_NEXT:
+			if (p->depth == 0)
+			{
+				p->fault = !0;
+				run = 0;
+			}
+			else if (p->loops[p->depth - 1].left == 0 || --p->loops[p->depth - 1].left != 0)
+			{
+				p->pc = p->loops[p->depth - 1].start;
+			}
+			else
+			{
+				p->depth--;
+				p->pc += 1;
+			}
+			break;
+		case PAT_OP_END:
+			run = 0;
+			break;
+		default:
+			p->fault = !0;
+			run = 0;
+			break;
+		}
+	}
+	return changed;
+}
+
+uint32_t Pattern_TimeToWake(const Pattern_t * const p, const uint32_t now)
+{
+	uint32_t left = 0;
+	if (p->prog == NULL || p->prog[p->pc] == PAT_OP_END || p->fault != 0)
+	{
+		left = UINT32_MAX;
+	}
+	else if ((int32_t)(now - p->wake) < 0)
+	{
+		left = p->wake - now;
+	}
+	return left;
+}
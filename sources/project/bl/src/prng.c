@@ -1,6 +1,7 @@
 /**
  * @file prng.c
- * @brief contains function for generation pseudo-rundonm number sequence for slalom light. x[n+1] = (a*x[n] + b) mod m is used
+ * @brief contains function for generation pseudo-rundonm number sequence for slalom light. x[n+1] = (a*x[n] + b) mod m is used.
+ * The sequence is kept in RAM, the flash keeps a value @ref PRNG_RESERVE steps ahead that is written once per @ref PRNG_RESERVE values
  * @author Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 17-11-2019
@@ -12,8 +13,23 @@ enum
 {
 	a = 5, /**< a param from the formula */
 	b = 17,/**< b param from the formula */
+	PRNG_RESERVE = 16 /**< Number of values reserved by one write of the seed to the flash */
 };
 
+static uint16_t state; /**< The last generated value */
+static uint8_t reserved = 0; /**< Number of values that can be generated before the seed is written again */
+static uint8_t loaded = 0; /**< Nonzero if @ref state was read from the flash */
+
+/**
+ * @brief The next value of the sequence
+ * @param x current value
+ * @return next value
+ */
+static uint16_t nextValue(const uint16_t x)
+{
+	return (a * x + b) & 0x7fff;
+}
+
 /**
  * @brief gets the next random value of the sequence
  * @param min minimal value
@@ -22,13 +38,29 @@ enum
  */
 uint16_t genRandom(const uint16_t min,const uint16_t max)
 {
-	uint16_t random = eeemuSeedGet();
-	if (random == 0xFFFF)
+	if (reserved == 0)
 	{
-		random = getEntropy() % 0x8000;
+		if (loaded == 0)
+		{
+			state = eeemuSeedGet();
+			if (state == 0xFFFF)
+			{
+				state = getEntropy() % 0x8000;
+			}
+			loaded = !0;
+		}
+		/* The value PRNG_RESERVE steps ahead is stored so the next start never repeats the values used now */
+		uint16_t ahead = state;
+		for (uint8_t i = 0; i < PRNG_RESERVE; i++)
+		{
+			ahead = nextValue(ahead);
+		}
+		eeemuSeedSet(ahead);
+		reserved = PRNG_RESERVE;
 	}
-	random = (a * random +b) & 0x7fff;
-	eeemuSeedSet(random);
+	state = nextValue(state);
+	reserved--;
+	const uint16_t random = state;
 	const uint16_t mod = max - min + 1;
 	uint8_t p;
 	for (p = 15; p > 0; p--)
@@ -8,9 +8,71 @@
  * @version 1.00
  * @brief Contains configuration constants for the project
  */
+
+/**
+ * @brief Led bit encoder kernels. @ref LED_ENCODER selects the one that is used by @ref rgbw.c
+ */
+#define ENCODER_BITWISE 0 /**< Tests every bit of every color */
+#define ENCODER_TABLE   1 /**< Expands every color nibble to four CCR values through a table */
+
+#ifndef LED_ENCODER
+#define LED_ENCODER ENCODER_TABLE /**< Encoder kernel. Can be overridden by -DLED_ENCODER=... */
+#endif
+
+/**
+ * @brief Pixel formats. @ref PIXEL_FORMAT selects the color order on the wire and if there is a white channel
+ */
+#define PIXEL_FORMAT_GRBW 0 /**< SK6812 rgbw strips */
+#define PIXEL_FORMAT_RGBW 1 /**< Rgbw strips with red first */
+#define PIXEL_FORMAT_GRB  2 /**< WS2812B strips */
+#define PIXEL_FORMAT_RGB  3 /**< Rgb strips with red first */
+
+#ifndef PIXEL_FORMAT
+#define PIXEL_FORMAT PIXEL_FORMAT_GRBW /**< Pixel format. Can be overridden by -DPIXEL_FORMAT=... */
+#endif
+
+#if (PIXEL_FORMAT == PIXEL_FORMAT_GRBW) || (PIXEL_FORMAT == PIXEL_FORMAT_RGBW)
+#define PIXEL_HAS_W 1 /**< The strip has a white channel */
+#else
+#define PIXEL_HAS_W 0 /**< The strip has no white channel */
+#endif
+
+#ifndef LED_GAMMA
+#define LED_GAMMA 0 /**< Nonzero to apply gamma 2.0 correction to the colors. Can be overridden by -DLED_GAMMA=1 */
+#endif
+
+#ifndef CRC_SOFTWARE
+#define CRC_SOFTWARE 0 /**< Nonzero to calculate crc by a table in software instead of the crc unit (host builds). Can be overridden by -DCRC_SOFTWARE=1 */
+#endif
+
+#ifndef LED_PHASE_EXACT
+#define LED_PHASE_EXACT 1 /**< Nonzero to run led control exactly at the phase start instead of the next 100ms step. Can be overridden by -DLED_PHASE_EXACT=0 */
+#endif
+
+/**
+ * @brief Strip wiring. @ref STRIP_LAYOUT selects how the two rows of the display are connected
+ */
+#define STRIP_LAYOUT_SERIAL   0 /**< One chain on PA0. The second row is the continuation of the first one going backwards */
+#define STRIP_LAYOUT_PARALLEL 1 /**< Every row is a separate chain going forward: row 0 on PA0, row 1 on PA6. Both are sent at the same time */
+
+#ifndef STRIP_LAYOUT
+#define STRIP_LAYOUT STRIP_LAYOUT_SERIAL /**< Strip wiring. Can be overridden by -DSTRIP_LAYOUT=... */
+#endif
+
+#if STRIP_LAYOUT == STRIP_LAYOUT_PARALLEL
+#define STRIP_CHANNELS 2 /**< Number of outputs driven concurrently */
+#else
+#define STRIP_CHANNELS 1 /**< Number of outputs driven concurrently */
+#endif
+
+#ifndef STRIP_LEDS
+#define STRIP_LEDS 144 /**< Number of leds in the strip. Only the strip driver (rgbw.c, timer_dma.c) can be built with another length by -DSTRIP_LEDS=..., the display code is made for 144 */
+#endif
+
 enum
 {
-	NLEDS 	= 			144,	/**< Number of leds in the strip */
+	NLEDS 	= 			STRIP_LEDS,	/**< Number of leds in the strip */
+	CHANNEL_LEDS =      NLEDS / STRIP_CHANNELS, /**< Number of leds driven by one output */
 	T1MIN 	= 			10, 	/**< Minimum time from going out of pitlane to finish line */
     T1MIN2 	= 			10, 	/**< Minimum time from turning the stick on and going out from the pitlane */
     T2MIN 	=   		7,  	/**< Minimum time from intermediate point to crossing finish line */
@@ -21,7 +83,8 @@ enum
 	TLIGHT_MAX= 		100,	/**< Max tlight random time (10s) */
 	PODNOS_MODE_MIN =   1,      /**< Min length of stop-and-go  mode in seconds */
 	PODNOS_MODE_MAX =   50,     /**< Max length of stop-and-go  mode in seconds */
-	MAX_BRIGHNESS_LEVELS = 4 /**< Number of brightness levels */
+	MAX_BRIGHNESS_LEVELS = 4, /**< Number of brightness levels */
+	STRIP_REFRESH_MS =  2000   /**< The whole strip is resent at least this often even if nothing changed. Recovers leds corrupted by EMI */
 };
 
 #endif /* SOURCES_PROJECT_CONF_PROJECT_CONF_H_ */
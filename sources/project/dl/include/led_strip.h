@@ -11,7 +11,7 @@
 #include <stdint.h>
 
 /**
- * @brief colors names. Should be the same if using rgb/rgbw strips
+ * @brief colors names. Should be the same if using rgb/rgbw strips. On rgb strips white is mixed from red, green and blue
  */
 typedef enum
 {
@@ -134,8 +134,72 @@ void displayNumber(const Colors_t colorL, const Colors_t colorR,const uint8_t Nu
  */
 uint8_t blink(const uint8_t init, const Blink_t * const _blink);
 /**
- * @brief Sends the led buffer to the led strip.
+ * @brief Sends the led buffer to the led strip. Only leds from the beginning of the chain up to the last changed one are sent,
+ * the rest of the leds keep their colors. Nothing is sent if nothing was changed or the frame is the same as the sent one
+ * (compared by fingerprint). The whole strip is sent if it was not sent for @ref STRIP_REFRESH_MS.
  */
 void sendDataToStrip(void);
+/**
+ * @brief Sends the whole led buffer if it was not sent for @ref STRIP_REFRESH_MS. Must be called periodically when there is nothing to update
+ */
+void refreshStrip(void);
+/**
+ * @brief Returns number of frames sent by @ref sendDataToStrip and @ref refreshStrip
+ * @return counter
+ */
+uint32_t getStripSentFrames(void);
+/**
+ * @brief Returns number of @ref sendDataToStrip calls that did not send anything because the frame was not changed
+ * @return counter
+ */
+uint32_t getStripSuppressedFrames(void);
+
+#ifdef FRAME_TRACE
+enum
+{
+	FRAME_TRACE_LEN = 64 /**< Number of the last frames kept in @ref frameTrace */
+};
+
+/**
+ * @brief Frame trace entry
+ */
+typedef struct
+{
+	uint32_t time; /**< Tick when the frame was sent */
+	uint32_t hash; /**< FNV-1a hash of the frame */
+}Frame_Trace_Entry_t;
+
+/**
+ * @brief Ring of the last sent frames. Refreshes of the same frame are not put
+ */
+typedef struct
+{
+	Frame_Trace_Entry_t entries[FRAME_TRACE_LEN]; /**< Entry of the frame number n is at n % @ref FRAME_TRACE_LEN */
+	uint32_t count; /**< Number of traced frames */
+}Frame_Trace_t;
+
+/**
+ * @brief Frame trace. Is compiled in with -DFRAME_TRACE only and is read by debugger to compare a mode run
+ * with a recorded one: the first differing entry shows the frame and the time where the runs diverge
+ */
+extern volatile Frame_Trace_t frameTrace;
+#endif
+
+#ifdef RGBW_BENCHMARK
+/**
+ * @brief Cycles taken by a full render (@ref showFull + @ref dispStrips). Is read by debugger
+ */
+extern volatile uint32_t ledStripRenderCycles;
+/**
+ * @brief Measures a full render by the cycle counter and puts the result to @ref ledStripRenderCycles
+ */
+void ledStrip_Benchmark(void);
+/**
+ * @brief Writes the color to every led one by one. The host bench times the pixel write with it
+ * @param color Color index
+ * @param scaled nonzero to scale the color at every write as it was done before the palette, zero to copy it from the palette
+ */
+void ledStrip_FillPixels(const Colors_t color, const uint8_t scaled);
+#endif
 
 #endif /* SOURCES_PROJECT_DL_INCLUDE_LED_STRIP_H_ */
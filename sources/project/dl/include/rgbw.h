@@ -5,27 +5,93 @@
  * @a Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 21-11-2019
- * @version 1.00
+ * @version 1.10
  * @brief Contains prototypes and data types for SK6812 led strip driver
  */
 #include <stdint.h>
+#include "project_conf.h"
 
 /**
- * @brief Struct defining color for each led
+ * @brief Struct defining color for each led. Components are declared in the order they are sent, see @ref PIXEL_FORMAT.
+ * So the encoder just sends the struct bytes one by one
  */
 typedef struct
 {
+#if (PIXEL_FORMAT == PIXEL_FORMAT_RGBW) || (PIXEL_FORMAT == PIXEL_FORMAT_RGB)
 	uint8_t R; /**< Red component (0-255) */
 	uint8_t G; /**< Green component (0-255) */
+#else
+	uint8_t G; /**< Green component (0-255) */
+	uint8_t R; /**< Red component (0-255) */
+#endif
 	uint8_t B; /**< Blue component (0-255) */
-	uint8_t W;
+#if PIXEL_HAS_W
+	uint8_t W; /**< White component (0-255) */
+#endif
 } Led_t;
 
+#if PIXEL_HAS_W
+/**
+ * @brief Led_t initializer that does not depend on the pixel format
+ */
+#define LED_INIT(r,g,b,w) {.R = (r), .G = (g), .B = (b), .W = (w)}
+#else
+#define LED_SAT(x) (((x) > 255) ? 255 : (x))
+/**
+ * @brief Led_t initializer that does not depend on the pixel format. White is added to all the colors if there is no white channel
+ */
+#define LED_INIT(r,g,b,w) {.R = LED_SAT((r) + (w)), .G = LED_SAT((g) + (w)), .B = LED_SAT((b) + (w))}
+#endif
+
+/**
+ * @brief Sends first nleds leds of every channel to the strip followed by the reset pulse. The rest of the leds keep their colors. Does not wait for the transfer:
+ * data is copied and is sent as soon as the previous frame is done. If there is already a frame waiting
+ * it's replaced and counted as dropped, its length is kept if it's longer.
+ * @param Leds Pointer to the array of led data. Channel n takes @ref CHANNEL_LEDS leds starting from n * @ref CHANNEL_LEDS
+ * @param nleds Number of leds to send for every channel (up to @ref CHANNEL_LEDS each). Channels with 0 are not touched
+ */
+void displayStrip(const Led_t * const Leds, const uint16_t * const nleds);
+/**
+ * @brief Returns number of frames sent to the first channel of the strip
+ * @return counter
+ */
+uint32_t rgbwGetSentFrames(void);
+/**
+ * @brief Returns number of frames that were replaced by the newer ones before being sent
+ * @return counter
+ */
+uint32_t rgbwGetDroppedFrames(void);
+
+#ifdef RGBW_BENCHMARK
+/**
+ * @brief Encoder kernels benchmark results. Is read by debugger
+ */
+typedef struct
+{
+	uint32_t bitwise; /**< Cycles per led of @ref ENCODER_BITWISE kernel */
+	uint32_t table;   /**< Cycles per led of @ref ENCODER_TABLE kernel */
+} RgbwBenchmark_t;
+
+extern volatile RgbwBenchmark_t rgbwBenchmark;
+
+/**
+ * @brief Encoder kernel: converts leds to CCR values, 8 per color
+ */
+typedef void (*pRgbwKernel_t)(const Led_t * const Leds, uint8_t * const Bits, const uint16_t n);
+
+/**
+ * @brief Returns the encoder kernel. The host bench times both kernels with it on the same leds
+ * @param encoder @ref ENCODER_BITWISE or @ref ENCODER_TABLE
+ * @return kernel
+ */
+pRgbwKernel_t rgbw_GetKernel(const uint8_t encoder);
+
 /**
- * @brief Sends data to the strip. Number of leds is @ref NLEDS
- * @param Leds Pointer to the array of led data
+ * @brief Measures both encoder kernels by the cycle counter and puts results to @ref rgbwBenchmark.
+ * Must be called when no transfer is in progress
  */
-void displayStrip(Led_t * const Leds);
+void rgbw_Benchmark(void);
+#endif
 
 
 #endif /* SOURCES_PROJECT_DL_INCLUDE_RGBW_H_ */
@@ -31,27 +31,89 @@ typedef struct
  */
 static const Led_t colors[] =
 {
-                            /* R,G,B,W */
-		[BLACK]=			{0,   0,  0,  0 },
-		[RED] =				{255, 0,  0,  0 },
-		[GREEN]= 			{0,   255,0,  0 },
-		[BLUE]=				{0,   0,  255,0 },
-		[WHITE]=			{0,   0,  0, 255},
-		[YELLOW]=			{255, 255,0,  15},
-		[MAGENTA]=    		{255, 0,  255,20},
-		[CYAN]=       		{0, 255,  255,20},
-		[DARK_RED]=   		{50,  0,  0,  0 },
-		[ORANGE]=			{100,50,  0,  0 },
-		[REDDER]=			{200,50,  0,  0 },
-		[GREEN10]=          {0,   26, 0,  0 },
-		[BLUE10]=           {0,   0,  26, 0 }
+                                     /* R,G,B,W */
+		[BLACK]=			LED_INIT(0,   0,  0,  0 ),
+		[RED] =				LED_INIT(255, 0,  0,  0 ),
+		[GREEN]= 			LED_INIT(0,   255,0,  0 ),
+		[BLUE]=				LED_INIT(0,   0,  255,0 ),
+		[WHITE]=			LED_INIT(0,   0,  0, 255),
+		[YELLOW]=			LED_INIT(255, 255,0,  15),
+		[MAGENTA]=    		LED_INIT(255, 0,  255,20),
+		[CYAN]=       		LED_INIT(0, 255,  255,20),
+		[DARK_RED]=   		LED_INIT(50,  0,  0,  0 ),
+		[ORANGE]=			LED_INIT(100,50,  0,  0 ),
+		[REDDER]=			LED_INIT(200,50,  0,  0 ),
+		[GREEN10]=          LED_INIT(0,   26, 0,  0 ),
+		[BLUE10]=           LED_INIT(0,   0,  26, 0 )
 };
 
+enum
+{
+	NCOLORS = sizeof(colors) / sizeof(colors[0]) /**< Number of colors */
+};
+
+/**
+ * @brief @ref colors resolved for the current brightness (and gamma). Pixel writes copy from it
+ */
+static Led_t palette[NCOLORS];
+
+/**
+ * @brief Brightness level @ref palette is built for. @ref MAX_BRIGHNESS_LEVELS means it's not built yet
+ */
+static uint8_t paletteLevel = MAX_BRIGHNESS_LEVELS;
+
 /**
  * @brief Buffer for storing led pixel data
  */
 static Led_t leds[NLEDS];
 
+/**
+ * @brief Number of leds from the beginning of every chain that were changed since the last @ref sendDataToStrip.
+ * Only this prefix is sent, the rest of the leds keep their colors. The whole chain is sent first time.
+ */
+static uint16_t dirtyLeds[STRIP_CHANNELS] =
+{
+		CHANNEL_LEDS,
+#if STRIP_CHANNELS > 1
+		CHANNEL_LEDS,
+#endif
+};
+
+/**
+ * @brief Fingerprints of the channel slices of @ref leds that were sent last time
+ */
+static uint32_t sentPrints[STRIP_CHANNELS];
+
+/**
+ * @brief Forced refresh timer
+ */
+static uint32_t refreshTimer;
+
+/**
+ * @brief Number of frames sent to the strip
+ */
+static uint32_t sentFrames = 0;
+
+/**
+ * @brief Number of frames that were requested but not sent because the leds did not change
+ */
+static uint32_t suppressedFrames = 0;
+
+/**
+ * @brief Converts display coordinates to the led index in @ref leds
+ * @param row Row (0 or 1)
+ * @param pos Position in the row (0 - NLEDS/2-1)
+ * @return led index. Row 1 goes backwards in @ref STRIP_LAYOUT_SERIAL and forward from the second channel in @ref STRIP_LAYOUT_PARALLEL
+ */
+static inline uint16_t ledIndex(const uint8_t row, const uint8_t pos)
+{
+#if STRIP_LAYOUT == STRIP_LAYOUT_PARALLEL
+	return (row == 0) ? pos : NLEDS / 2 + pos;
+#else
+	return (row == 0) ? pos : NLEDS - pos - 1;
+#endif
+}
+
 /**
  * @brief brightness level descriptor. For fractional numbers multiplier and divider is used.
  */
@@ -87,8 +149,89 @@ static void applyBrightness(const Led_t * const in, Led_t * const out)
 	tmp = in->B * coefs[brighness].mul;
 	out->B = tmp / coefs[brighness].div;
 
+#if PIXEL_HAS_W
 	tmp = in->W * coefs[brighness].mul;
 	out->W = tmp / coefs[brighness].div;
+#endif
+}
+
+#if LED_GAMMA
+/**
+ * @brief Applies gamma 2.0 to the color component. Nonzero values stay nonzero
+ * @param v component
+ * @return corrected component
+ */
+static uint8_t gamma2(const uint8_t v)
+{
+	return (uint8_t)(((uint16_t)v * v + 254u) / 255u);
+}
+
+/**
+ * @brief Applies gamma to all the components of the led
+ * @param led led data
+ */
+static void applyGamma(Led_t * const led)
+{
+	led->R = gamma2(led->R);
+	led->G = gamma2(led->G);
+	led->B = gamma2(led->B);
+#if PIXEL_HAS_W
+	led->W = gamma2(led->W);
+#endif
+}
+#endif
+
+/**
+ * @brief Rebuilds @ref palette for the current brightness if the level was changed
+ */
+static void updatePalette(void)
+{
+	if (paletteLevel != getBrightness())
+	{
+		for (uint8_t i = 0; i < NCOLORS; i++)
+		{
+			Led_t led = colors[i];
+#if LED_GAMMA
+			applyGamma(&led);
+#endif
+			applyBrightness(&led,&palette[i]);
+		}
+		paletteLevel = getBrightness();
+	}
+}
+
+/**
+ * @brief Puts led data to the out buffer and moves @ref dirtyLeds of the led channel if the led is changed
+ * @param idx Led index in @ref leds
+ * @param led Led data
+ */
+static void setLed(const uint16_t idx, const Led_t * const led)
+{
+	Led_t * const dst = leds + idx;
+	if (dst->R != led->R || dst->G != led->G || dst->B != led->B
+#if PIXEL_HAS_W
+			|| dst->W != led->W
+#endif
+			)
+	{
+		const uint8_t ch = idx / CHANNEL_LEDS;
+		const uint16_t top = idx % CHANNEL_LEDS + 1;
+		*dst = *led;
+		if (top > dirtyLeds[ch])
+		{
+			dirtyLeds[ch] = top;
+		}
+	}
+}
+
+/**
+ * @brief Puts the color resolved for the current brightness to the out buffer
+ * @param idx Led index in the chain
+ * @param color Color index
+ */
+static inline void setLedColor(const uint16_t idx, const Colors_t color)
+{
+	setLed(idx,&palette[color]);
 }
 
 /**
@@ -103,37 +246,26 @@ static void displayDigit(const Colors_t color,uint8_t digit,uint8_t column)
   column = (column > 1) ? 1 : column;
   const uint8_t maxDigit = ((NLEDS / 2) / 4) * 3 + (NLEDS / 2) % 4;
   digit = (digit > maxDigit) ? maxDigit : digit;
-  int16_t pos = column * (NLEDS -1);
-  const int8_t inc = (column == 0) ? 1 : -1;
+  uint8_t pos = 0;
   for (uint8_t i = 0; i < digit / 3; i++)
   {
     for (uint8_t k = 0; k < 3; k++)
     {
-      applyBrightness(&colors[color],leds + pos);
-      pos+=inc;
+      setLedColor(ledIndex(column,pos),color);
+      pos++;
     }
-    leds[pos] = colors[BLACK];
-    pos+=inc;
+    setLed(ledIndex(column,pos),&colors[BLACK]);
+    pos++;
   }
 
   for (uint8_t i = 0; i < digit % 3; i++)
   {
-    applyBrightness(&colors[color],leds + pos);
-    pos+=inc;
-  }
-  if (inc > 0)
-  {
-	  for (;pos < NLEDS / 2;pos += inc)
-	  {
-		  leds[pos]=colors[BLACK];
-	  }
+    setLedColor(ledIndex(column,pos),color);
+    pos++;
   }
-  else
+  for (;pos < NLEDS / 2;pos++)
   {
-	  for (;pos >= NLEDS / 2; pos += inc)
-	  {
-		  leds[pos]=colors[BLACK];
-	  }
+    setLed(ledIndex(column,pos),&colors[BLACK]);
   }
 }
 
@@ -147,24 +279,14 @@ void setBrightness(const uint8_t brighness_a)
 	{
 		Brightness = MAX_BRIGHNESS_LEVELS - 1;
 	}
+	updatePalette();
 }
 
 void putPixel(const uint8_t row,const uint8_t pos, const Colors_t color)
 {
-	if (pos < NLEDS / 2)
+	if (pos < NLEDS / 2 && row < 2)
 	{
-		switch(row)
-		{
-		case 0:
-			applyBrightness(&colors[color],leds + pos);
-			break;
-		case 1:
-			applyBrightness(&colors[color],leds + NLEDS - pos - 1);
-			break;
-		default:
-			break;
-
-		}
+		setLedColor(ledIndex(row,pos),color);
 	}
 }
 
@@ -177,11 +299,10 @@ void put2pixels(const Colors_t color,const uint8_t pos)
 
 void showFull(const Colors_t color)
 {
-  Led_t led;
-  applyBrightness(&colors[color],&led);
-  for (uint8_t i = 0; i < NLEDS; i++)
+  const Led_t * const led = &palette[color];
+  for (uint16_t i = 0; i < NLEDS; i++)
   {
-    leds[i] = led;
+    setLed(i,led);
   }
 }
 
@@ -358,8 +479,162 @@ uint8_t blink(const uint8_t init, const Blink_t * const _blink)
     return changed;
 }
 
+/**
+ * @brief Calculates FNV-1a hash of the channel slice of @ref leds
+ * @param ch channel
+ * @return hash
+ */
+static uint32_t fingerprint(const uint8_t ch)
+{
+	const uint8_t * data = (const uint8_t *)(leds + ch * CHANNEL_LEDS);
+	uint32_t hash = 2166136261u;
+	for (uint16_t i = 0; i < CHANNEL_LEDS * sizeof(Led_t); i++)
+	{
+		hash ^= *data++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+#ifdef FRAME_TRACE
+volatile Frame_Trace_t frameTrace;
+
+/**
+ * @brief Puts the time and the hash of all channels of the new frame to @ref frameTrace
+ */
+static void traceFrame(void)
+{
+	uint32_t hash = 2166136261u;
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		hash = (hash ^ sentPrints[ch]) * 16777619u;
+	}
+	volatile Frame_Trace_Entry_t * const entry = frameTrace.entries + frameTrace.count % FRAME_TRACE_LEN;
+	entry->time = GetTicksCounter();
+	entry->hash = hash;
+	frameTrace.count++;
+}
+#endif
+
+/**
+ * @brief Sends dirty prefixes of the channels whose fingerprint differs from the sent one
+ * @param force nonzero to send all the channels completely
+ */
+static void sendFrame(const uint8_t force)
+{
+	uint8_t send = 0;
+#ifdef FRAME_TRACE
+	uint8_t newFrame = 0;
+#endif
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		if (force != 0)
+		{
+			dirtyLeds[ch] = CHANNEL_LEDS;
+		}
+		if (dirtyLeds[ch] != 0)
+		{
+			const uint32_t print = fingerprint(ch);
+			if (print != sentPrints[ch] || force != 0)
+			{
+#ifdef FRAME_TRACE
+				newFrame |= (print != sentPrints[ch]);
+#endif
+				sentPrints[ch] = print;
+				send = !0;
+			}
+			else
+			{
+				dirtyLeds[ch] = 0; /* Changed back to what the strip shows */
+			}
+		}
+	}
+	if (send != 0)
+	{
+		displayStrip(leds,dirtyLeds);
+		ResetTimer(&refreshTimer);
+		sentFrames++;
+#ifdef FRAME_TRACE
+		if (newFrame != 0)
+		{
+			traceFrame();
+		}
+#endif
+	}
+	else
+	{
+		suppressedFrames++;
+	}
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		dirtyLeds[ch] = 0;
+	}
+}
+
 void sendDataToStrip(void)
 {
-	displayStrip(leds);
+	sendFrame(IsExpiredTimer(&refreshTimer,STRIP_REFRESH_MS));
+}
+
+void refreshStrip(void)
+{
+	if (IsExpiredTimer(&refreshTimer,STRIP_REFRESH_MS) != 0)
+	{
+		sendFrame(!0);
+	}
 }
 
+uint32_t getStripSentFrames(void)
+{
+	return sentFrames;
+}
+
+uint32_t getStripSuppressedFrames(void)
+{
+	return suppressedFrames;
+}
+
+#ifdef RGBW_BENCHMARK
+volatile uint32_t ledStripRenderCycles;
+
+/**
+ * @brief Pixel write as it was done before @ref palette: the color is scaled at every write
+ * @param idx Led index in the chain
+ * @param color Color index
+ */
+static void setLedColorScaled(const uint16_t idx, const Colors_t color)
+{
+	Led_t led = colors[color];
+	Led_t scaled;
+#if LED_GAMMA
+	applyGamma(&led);
+#endif
+	applyBrightness(&led,&scaled);
+	setLed(idx,&scaled);
+}
+
+void ledStrip_FillPixels(const Colors_t color, const uint8_t scaled)
+{
+	updatePalette();
+	for (uint16_t i = 0; i < NLEDS; i++)
+	{
+		if (scaled != 0)
+		{
+			setLedColorScaled(i,color);
+		}
+		else
+		{
+			setLedColor(i,color);
+		}
+	}
+}
+
+void ledStrip_Benchmark(void)
+{
+	setBrightness(MAX_BRIGHNESS_LEVELS - 2);
+	const uint32_t start = GetCycleCounter();
+	showFull(RED);
+	dispStrips(GREEN,5);
+	ledStripRenderCycles = GetCycleCounter() - start;
+}
+#endif
@@ -3,9 +3,16 @@
  * @a Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 21-11-2019
- * @version 1.00
+ * @version 1.60
  * @brief Contains SK6812 led strip driver implementation.
- * The driver converts rgbw led data to serial array of short and long PWM pulses that are sent by dma to timer2 and use it's ch1 out
+ * The driver converts rgbw led data to serial array of short and long PWM pulses that are sent by dma to timer2 and use it's ch1 out.
+ * Conversion is done on the fly: dma runs in circular mode over two small halves and the half that has been sent is
+ * refilled with the next @ref STREAM_LEDS leds from the dma interrupt. So ram usage does not depend on the strip length.
+ * Short pulse and reset widths are checked against the strip datasheet at compile time.
+ * Encoder kernel is selected by @ref LED_ENCODER. Color order and the number of colors per led are selected by @ref PIXEL_FORMAT.
+ * @ref displayStrip does not wait: the frame is copied to the pending slot and is sent when the current one is done.
+ * Only the requested prefix of the chain is sent. Leds after it keep their colors until the data reaches them.
+ * With @ref STRIP_LAYOUT_PARALLEL every channel streams its own half of the frame from its own buffer at the same time.
  *
  */
 #include "rgbw.h"
@@ -13,78 +20,319 @@
 #include "led_control.h"
 #include "led_strip.h"
 #include "project_conf.h"
+#ifdef RGBW_BENCHMARK
+#include "clock.h"
+#endif
 
-#define CCR_0 20 /* 0.5us */
-#define CCR_1 64 /* 1.2us */
-#define RESET_BITS 40
+#define CCR_0 20 /* 0.3125us */
+#define CCR_1 64 /* 1.0us */
 
+#if PIXEL_HAS_W
+/* SK6812 timing, ns */
+#define T0H_NS     300u
+#define T0L_NS     900u
+#define TOL_NS     150u
+#define RESET_NS 80000u
+#else
+/* WS2812B timing, ns */
+#define T0H_NS     400u
+#define T0L_NS     850u
+#define TOL_NS     150u
+#define RESET_NS 50000u
+#endif
+
+/**
+ * @brief Converts timer ticks to ns
+ */
+#define TICKS_NS(t) ((uint32_t)(((uint64_t)(t) * 1000000000u) / STRIP_TIMER_CLOCK_HZ))
 /**
- * @brief Led array bits. Contains one byte for bit so each led takes 32bytes. Also @ref RESET_BITS are added and one byte to switch the out off
+ * @brief Checks that the pulse of the given timer ticks is within the tolerance of the datasheet value
  */
-static uint8_t BitData[NLEDS * 8 * 4 + RESET_BITS + 1];
+#define PULSE_OK(t,ns) ((TICKS_NS(t) + TOL_NS >= (ns)) && (TICKS_NS(t) <= (ns) + TOL_NS))
+
+/* The long pulse (1.0us high, 0.31us low) is the timing the strips were run with. It's longer than the datasheet T1H
+ * and its low part is shorter than the SK6812 T1L, the strips take it as one anyway. test_wire measures all of the
+ * widths on the host and lists these deviations, a new timing has to be validated on a real strip first */
+_Static_assert(PULSE_OK(CCR_0, T0H_NS), "T0H is out of the strip tolerance");
+_Static_assert(PULSE_OK(STRIP_BIT_TICKS - CCR_0, T0L_NS), "T0L is out of the strip tolerance");
+
+enum
+{
+	BITS_PER_LED = 8 * sizeof(Led_t), /**< Each led takes 8 bits per color, 32 bits for rgbw and 24 bits for rgb formats */
+	STREAM_LEDS = 4, /**< Number of leds in one half of the buffer. One half takes 168us (rgbw) or 126us (rgb) to be sent and is also used as a reset pulse */
+	TAIL_HALVES = 2 /**< Number of zero halves sent after the last led. The first one is the reset pulse, the second one makes CCR1 zero before stop */
+};
+
+_Static_assert(TICKS_NS(STRIP_BIT_TICKS * STREAM_LEDS * BITS_PER_LED) >= RESET_NS, "One zero half is shorter than the reset pulse");
 
 /**
- * @brief Converts leds array to serial bit array
- * @param Leds input array. @ref BitData is used as out
+ * @brief Stream state of one output channel. Every channel sends its own @ref CHANNEL_LEDS slice of the frame
  */
-static void ConvertLeds(Led_t * const Leds)
+typedef struct
 {
-	uint8_t i,k;
+	/**
+	 * @brief Led array bits. Contains one byte for bit. Two halves of @ref STREAM_LEDS leds each.
+	 * It's declared as words to be filled by @ref ConvertLedsTable word by word
+	 */
+	uint32_t BitData[2 * STREAM_LEDS * BITS_PER_LED / sizeof(uint32_t)];
+	Led_t * Front; /**< The frame slice being sent */
+	Led_t * Back; /**< The pending frame slice */
+	volatile uint8_t Pending; /**< Nonzero if @ref Back holds a frame that was not sent yet */
+	uint16_t FrontLeds; /**< Number of leds to send from @ref Front */
+	uint16_t BackLeds; /**< Number of leds to send from @ref Back */
+	uint16_t StreamPos; /**< The index of the next led to be converted */
+	uint8_t TailHalves; /**< Number of zero halves already put to the buffer after the last led */
+} Stream_t;
 
-	for (i=0; i < RESET_BITS; i++)
-	{
-		BitData[i] = 0;
-	}
-	BitData[sizeof(BitData) - 1] = 0;
-	for (i=0; i < NLEDS; i++)
+/**
+ * @brief Frame buffers. One of them is being sent and the other one holds the frame waiting to be sent
+ */
+static Led_t Frames[2][NLEDS];
+
+static Stream_t Streams[STRIP_CHANNELS] =
+{
+		{.Front = Frames[0], .Back = Frames[1]},
+#if STRIP_CHANNELS > 1
+		{.Front = Frames[0] + CHANNEL_LEDS, .Back = Frames[1] + CHANNEL_LEDS},
+#endif
+};
+/**
+ * @brief Number of frames started on the first channel
+ */
+static volatile uint32_t SentFrames = 0;
+/**
+ * @brief Number of frames that were replaced in the pending slot before being sent
+ */
+static volatile uint32_t DroppedFrames = 0;
+
+#if (LED_ENCODER == ENCODER_BITWISE) || defined(RGBW_BENCHMARK)
+/**
+ * @brief Converts leds array to serial bit array testing every bit
+ * @param Leds input array
+ * @param Bits output array. @ref BITS_PER_LED bytes per led
+ * @param n number of leds to convert
+ */
+static void ConvertLedsBitwise(const Led_t * const Leds, uint8_t * const Bits, const uint16_t n)
+{
+	uint16_t i;
+	uint8_t c;
+	uint8_t k;
+
+	for (i=0; i < n; i++)
 	{
-		Led_t CurrLed;
-		CurrLed.R = Leds[i].R;
-		CurrLed.G = Leds[i].G;
-		CurrLed.B = Leds[i].B;
-		CurrLed.W = Leds[i].W;
-		for ( k=0; k < 8; k++)
+		const uint8_t * const Colors = (const uint8_t *)&Leds[i];
+		uint8_t * const Out = Bits + i * BITS_PER_LED;
+		for (c = 0; c < sizeof(Led_t); c++)
 		{
-			if ((CurrLed.G & (1 << k)) != 0 )
-			{
-				BitData[RESET_BITS + i * 32 + 7 - k] = CCR_1;
-			}
-			else
-			{
-				BitData[RESET_BITS + i * 32 + 7 - k] = CCR_0;
-			}
-			if ((CurrLed.R & (1 << k)) != 0 )
-			{
-				BitData[RESET_BITS + i * 32 + 8 + 7 - k] = CCR_1;
-			}
-			else
+			const uint8_t Color = Colors[c];
+			for ( k=0; k < 8; k++)
 			{
-				BitData[RESET_BITS + i * 32 + 8 + 7 -  k] = CCR_0;
+				if ((Color & (1 << k)) != 0 )
+				{
+					Out[c * 8 + 7 - k] = CCR_1;
+				}
+				else
+				{
+					Out[c * 8 + 7 - k] = CCR_0;
+				}
 			}
-			if ((CurrLed.B & (1 << k)) != 0 )
-			{
-				BitData[RESET_BITS + i * 32 + 16 + 7 - k] = CCR_1;
-			}
-			else
+		}
+	}
+}
+#endif
+
+#if (LED_ENCODER == ENCODER_TABLE) || defined(RGBW_BENCHMARK)
+#define NIBBLE_BIT(n,b) ((((n) & (1u << (b))) != 0) ? (uint32_t)CCR_1 : (uint32_t)CCR_0)
+#define NIBBLE(n) (NIBBLE_BIT(n,3) | NIBBLE_BIT(n,2) << 8 | NIBBLE_BIT(n,1) << 16 | NIBBLE_BIT(n,0) << 24)
+
+/**
+ * @brief CCR values for every nibble packed to a word. Msb goes first so it's in the lowest (first in memory) byte
+ */
+static const uint32_t NibbleBits[16] =
+{
+		NIBBLE(0),  NIBBLE(1),  NIBBLE(2),  NIBBLE(3),
+		NIBBLE(4),  NIBBLE(5),  NIBBLE(6),  NIBBLE(7),
+		NIBBLE(8),  NIBBLE(9),  NIBBLE(10), NIBBLE(11),
+		NIBBLE(12), NIBBLE(13), NIBBLE(14), NIBBLE(15)
+};
+
+/**
+ * @brief Converts leds array to serial bit array using @ref NibbleBits. Two words are written per color byte.
+ * Led_t bytes are already in the wire order so the array is encoded as a plain byte stream
+ * @param Leds input array
+ * @param Bits output array. @ref BITS_PER_LED bytes per led. Must be word aligned
+ * @param n number of leds to convert
+ */
+static void ConvertLedsTable(const Led_t * const Leds, uint8_t * const Bits, const uint16_t n)
+{
+	uint32_t * Out = (uint32_t *)(void *)Bits;
+	const uint8_t * Colors = (const uint8_t *)Leds;
+	for (uint16_t i = 0; i < n * sizeof(Led_t); i++)
+	{
+		const uint8_t Color = *Colors++;
+		*Out++ = NibbleBits[Color >> 4];
+		*Out++ = NibbleBits[Color & 0x0F];
+	}
+}
+#endif
+
+#if LED_ENCODER == ENCODER_TABLE
+#define ConvertLeds ConvertLedsTable
+#else
+#define ConvertLeds ConvertLedsBitwise
+#endif
+
+/**
+ * @brief Takes the pending frame to be sent. Is called with dma interrupt disabled or from it
+ * @param ch channel
+ */
+static void takePendingFrame(const uint8_t ch)
+{
+	Stream_t * const s = Streams + ch;
+	Led_t * const tmp = s->Front;
+	s->Front = s->Back;
+	s->Back = tmp;
+	s->FrontLeds = s->BackLeds;
+	s->Pending = 0;
+	s->StreamPos = 0;
+	s->TailHalves = 0;
+	if (ch == 0)
+	{
+		SentFrames++;
+	}
+}
+
+/**
+ * @brief Refills one half of @ref BitData. Is called from the dma interrupt.
+ * Only @ref Stream_t::FrontLeds leds are sent, the reset pulse follows them
+ * A pending frame is started right after the first zero (reset) half so frames go back to back
+ * @param ch channel
+ * @param half The half to refill
+ * @param size Half size in bytes
+ * @return nonzero while there is something to send
+ */
+static uint8_t FillHalf(const uint8_t ch, uint8_t * const half, const uint16_t size)
+{
+	Stream_t * const s = Streams + ch;
+	uint8_t retVal = !0;
+	uint16_t used = 0;
+	if (s->StreamPos >= s->FrontLeds && s->TailHalves != 0 && s->Pending != 0)
+	{
+		takePendingFrame(ch);
+	}
+	if (s->StreamPos < s->FrontLeds)
+	{
+		const uint16_t n = (s->FrontLeds - s->StreamPos < STREAM_LEDS) ? s->FrontLeds - s->StreamPos : STREAM_LEDS;
+		ConvertLeds(s->Front + s->StreamPos, half, n);
+		s->StreamPos += n;
+		used = n * BITS_PER_LED;
+	}
+	else if (s->TailHalves < TAIL_HALVES)
+	{
+		s->TailHalves++;
+	}
+	else
+	{
+		retVal = 0;
+	}
+	if (retVal != 0)
+	{
+		for (uint16_t i = used; i < size; i++)
+		{
+			half[i] = 0;
+		}
+	}
+	return retVal;
+}
+
+void displayStrip(const Led_t * const Leds, const uint16_t * const nleds)
+{
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		Stream_t * const s = Streams + ch;
+		const Led_t * const src = Leds + ch * CHANNEL_LEDS;
+		uint16_t n = (nleds[ch] > CHANNEL_LEDS) ? CHANNEL_LEDS : nleds[ch];
+		tim2_DisableIrq();
+		if (s->Pending != 0)
+		{
+			s->Pending = 0;
+			if (ch == 0)
 			{
-				BitData[RESET_BITS + i * 32 + 16 + 7 - k] = CCR_0;
+				DroppedFrames++;
 			}
-			if ((CurrLed.W & (1 << k)) != 0 )
+			n = (s->BackLeds > n) ? s->BackLeds : n; /* Leds changed by the dropped frame must be sent too */
+		}
+		tim2_EnableIrq();
+
+		if (n != 0)
+		{
+			for (uint16_t i = 0; i < n; i++)
 			{
-				BitData[RESET_BITS + i * 32 + 24 + 7 - k] = CCR_1;
+				s->Back[i] = src[i];
 			}
-			else
+
+			tim2_DisableIrq();
+			s->BackLeds = n;
+			s->Pending = !0;
+			if (tim2_IsBusy(ch) == 0)
 			{
-				BitData[RESET_BITS + i * 32 + 24 + 7 - k] = CCR_0;
+				takePendingFrame(ch);
+				tim2_set_data(ch,(uint8_t *)s->BitData,sizeof(s->BitData),FillHalf);
+				tim2_TransferBits(ch);
 			}
-
+			tim2_EnableIrq();
 		}
 	}
 }
 
-void displayStrip(Led_t * const Leds)
+uint32_t rgbwGetSentFrames(void)
+{
+	return SentFrames;
+}
+
+uint32_t rgbwGetDroppedFrames(void)
+{
+	return DroppedFrames;
+}
+
+#ifdef RGBW_BENCHMARK
+volatile RgbwBenchmark_t rgbwBenchmark;
+
+/**
+ * @brief Runs one kernel over @ref NLEDS leds in chunks of @ref STREAM_LEDS as it's done by @ref FillHalf
+ * @param kernel the kernel
+ * @param Leds input leds
+ * @return cycles per led
+ */
+static uint32_t benchmarkKernel(const pRgbwKernel_t kernel, const Led_t * const Leds)
+{
+	const uint32_t start = GetCycleCounter();
+	for (uint16_t i = 0; i < NLEDS; i += STREAM_LEDS)
+	{
+		kernel(Leds, (uint8_t *)Streams[0].BitData, STREAM_LEDS);
+	}
+	return (GetCycleCounter() - start) / NLEDS;
+}
+
+void rgbw_Benchmark(void)
+{
+	static const Led_t Leds[STREAM_LEDS] =
+	{
+			LED_INIT(0x00, 0xFF, 0x5A, 0x0F),
+			LED_INIT(0x81, 0x42, 0x24, 0x18),
+			LED_INIT(0xAA, 0x55, 0x33, 0xCC),
+			LED_INIT(0x12, 0x34, 0x56, 0x78)
+	};
+	while (tim2_IsBusy(0) != 0)
+	{
+
+	}
+	rgbwBenchmark.bitwise = benchmarkKernel(ConvertLedsBitwise, Leds);
+	rgbwBenchmark.table = benchmarkKernel(ConvertLedsTable, Leds);
+}
+
+pRgbwKernel_t rgbw_GetKernel(const uint8_t encoder)
 {
-	ConvertLeds(Leds);
-	tim2_set_data(BitData,sizeof(BitData));
-	tim2_TransferBits();
+	return (encoder == ENCODER_TABLE) ? ConvertLedsTable : ConvertLedsBitwise;
 }
+#endif
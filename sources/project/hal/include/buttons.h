@@ -9,21 +9,16 @@
 #ifndef SOURCE_BLL_BUTTONS_H_
 #define SOURCE_BLL_BUTTONS_H_
 
-/**
- * @brief number of @ref Button_Process function call per second
- */
-#define CALLS_PER_SECOND 100
-
 #include <stdint.h>
 
 /**
- * \brief Number of tics to assume the button state is stable.
+ * \brief Time in ms when edges after the accepted one are ignored as bounces
  */
-#define BUTTONWAIT (CALLS_PER_SECOND / 20)
+#define BUTTON_DEBOUNCE_MS 50
 /**
- * \brief Number of tics to assume the button is long pressed.
+ * \brief Time in ms to assume the button is long pressed.
  */
-#define BUTTONLONGWAIT (CALLS_PER_SECOND * 2)
+#define BUTTON_LONG_MS 2000
 
 /**
  * @brief Buttons id
@@ -34,14 +29,42 @@ typedef enum {
 } Buttons_id_t;
 
 /**
- * \brief Initializes the buttons driver
+ * @brief Button events
+ */
+typedef enum
+{
+	BUTTON_EVENT_NONE = 0, /**< No events in the queue */
+	BUTTON_EVENT_PRESS,    /**< The button was pressed */
+	BUTTON_EVENT_RELEASE,  /**< The button was released */
+	BUTTON_EVENT_LONG      /**< The button has been pressed for @ref BUTTON_LONG_MS */
+} ButtonEvent_t;
+
+/**
+ * \brief Initializes the buttons driver and enables the button EXTI interrupt
  */
 void Buttons_Init(void);
 /**
- * \brief Processes the button. Must be called from the timer interrupt
- * \param button_no The button number.
+ * \brief Processes edges captured since the last call, updates the button state and puts events to the queue.
+ * Must be called periodically, at least every @ref BUTTON_LONG_MS / 10
+ * \param Button_id The button number.
+ */
+void Button_Process(const Buttons_id_t Button_id);
+/**
+ * @brief Takes the oldest event from the button queue
+ * @param button_id The button number.
+ * @return event or @ref BUTTON_EVENT_NONE if the queue is empty
+ */
+ButtonEvent_t Button_GetEvent(const Buttons_id_t button_id);
+/**
+ * @brief Drops all events of the button
+ * @param button_id The button number.
+ */
+void Button_FlushEvents(const Buttons_id_t button_id);
+/**
+ * @brief Returns number of edges and events that were dropped because the queues were full
+ * @return counter
  */
-void Button_Process(uint8_t button_no);
+uint32_t Button_GetOverflows(void);
 
 
 void WaitButtonPress(Buttons_id_t button); /**< Wait for button is pressed (with debouncing) */
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #define CPU_FREQ 64000000ul
 #define SYSTICK_FREQ 1000
+#define SLEEP_MAX_MS 200 /**< Longest sleep. Must be less than 262ms (24 bit systick at 64MHz) and the watchdog timeout */
 
 /**
  * @brief Inits HSE as a main clock. PLL is setup to *8
@@ -20,11 +21,22 @@
 void Clock_HSE_Init(void);
 
 /**
- * @brief Returns number of milliseconds from timebase start
+ * @brief Returns number of milliseconds from timebase start. It's correct during @ref Clock_Sleep too
  * @return milliscenonds
  */
 uint32_t GetTicksCounter(void);
 void Systick_Init(void);
+/**
+ * @brief Sleeps (WFI) for up to ms milliseconds. Systick is reprogrammed not to wake the cpu every tick.
+ * Any other interrupt wakes the cpu earlier. A long period that was already started is not shortened.
+ * @param ms time to the next job, up to @ref SLEEP_MAX_MS. 0 returns immediately
+ */
+void Clock_Sleep(uint32_t ms);
+/**
+ * @brief Returns the part of time spent in @ref Clock_Sleep, measured over about 1s windows
+ * @return percent
+ */
+uint8_t Clock_GetSleepPercent(void);
 
 /**
  * @brief Resets software timer
@@ -33,6 +45,26 @@ void Systick_Init(void);
 void ResetTimer(uint32_t * const Timer);
 uint8_t IsExpiredTimer(uint32_t * const Timer, const uint32_t Timeout);
 uint32_t ReadTimer(uint32_t * const Timer);
+/**
+ * @brief Forgets the timers checked by @ref IsExpiredTimer before
+ */
+void Clock_ResetNextExpiry(void);
+/**
+ * @brief Returns time to the nearest expiry of the timers that were checked by @ref IsExpiredTimer
+ * since @ref Clock_ResetNextExpiry and had not expired then. Timers that were reset after the check are not tracked
+ * @return ms, 0 if it has already come, UINT32_MAX if no timer was checked
+ */
+uint32_t Clock_TimeToNextExpiry(void);
+
+/**
+ * @brief Starts DWT cycle counter
+ */
+void CycleCounter_Init(void);
+/**
+ * @brief Returns number of cpu cycles from @ref CycleCounter_Init. Wraps every 67s at 64MHz
+ * @return cycles
+ */
+uint32_t GetCycleCounter(void);
 
 
 #endif /* SOURCE_DL_CLOCK_H_ */
@@ -0,0 +1,27 @@
+#ifndef SOURCES_PROJECT_HAL_INCLUDE_CRC_H_
+#define SOURCES_PROJECT_HAL_INCLUDE_CRC_H_
+/**
+ * @file crc.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains crc32 prototypes. The crc is the one of the STM32F1 crc unit: polynomial 0x04C11DB7, initial value 0xFFFFFFFF,
+ * 32-bit words are fed most significant bit first, no final xor. With @ref CRC_SOFTWARE the same crc is calculated by a table
+ */
+#include <stdint.h>
+
+/**
+ * @brief Enables the crc unit clock
+ */
+void Crc_Init(void);
+
+/**
+ * @brief Calculates crc32 of the words
+ * @param data words
+ * @param nwords number of words
+ * @return crc
+ */
+uint32_t Crc32(const uint32_t * const data, const uint16_t nwords);
+
+#endif /* SOURCES_PROJECT_HAL_INCLUDE_CRC_H_ */
@@ -6,30 +6,69 @@
  * @author Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 19-11-2019
- * @version 1.00
+ * @version 1.20
  * @brief eeprom emulation header in pair with @ref eeemu.c
  */
 #ifndef SOURCES_PROJECT_HAL_INCLUDE_EEEMU_H_
 #define SOURCES_PROJECT_HAL_INCLUDE_EEEMU_H_
 
-#define MAX_STORED 9 /**< The number of stored params. All params are one byte size */
-
 #include <stdint.h>
+
+#define CONFIG_VERSION 1 /**< Version of @ref Config_t. Must be incremented when fields are added */
+
+/**
+ * @brief Stored config. All fields are one byte size. New fields must be added to the end only: records of older versions
+ * are read as a prefix of the structure and the new fields get default values
+ */
+typedef struct
+{
+	uint8_t brightness;     /**< Brightness */
+	uint8_t mode;           /**< Selected work mode */
+	uint8_t tseq;           /**< Total pitstop time */
+	uint8_t t1;             /**< T1 Time in seconds */
+	uint8_t t2;             /**< T2 Time in seconds */
+	uint8_t tlightMin;      /**< Tlight random part minimal value in 1/10s */
+	uint8_t tlightMax;      /**< Tlight random part maximal value in 1/10s */
+	uint8_t podnosModeTime; /**< Stop-and-go mode time */
+	uint8_t pitInviteColor; /**< The color of pitlane invitation mode */
+}Config_t;
+
+/**
+ * @brief Flash wear statistics. Erase counters are kept in the page headers so they survive resets and are exact.
+ * Write counters are not stored, they are estimates: @ref eeemu_Init derives them from the erase counters assuming
+ * every page was filled before it was erased, plus the fill level of the active page, then every write increments them.
+ * A page rewritten early (a cut seed write, a seed page of older firmware) is counted as full.
+ * Pages written by older firmware have no counters so counting starts from zero for them.
+ */
+typedef struct
+{
+	uint32_t configErases[2]; /**< Erases of every config page */
+	uint32_t seedErases;      /**< Erases of the seed page */
+	uint32_t configWrites;    /**< Estimate of the config records written, derived from the erases */
+	uint32_t seedWrites;      /**< Estimate of the seeds written, derived from the erases */
+	uint16_t failedJobs;      /**< Erase or program jobs that failed or did not match at read back since reset */
+}Eeemu_Stats_t;
+
 /**
- * @brief Eeprom emulation subsystem init. It finds the index of the last saved config
+ * @brief Flash wear statistics. It's global to be read over SWD, @ref Eeemu_Stats_t.failedJobs is changed from the flash interrupt
+ */
+extern volatile Eeemu_Stats_t eeemuStats;
+
+/**
+ * @brief Eeprom emulation subsystem init. It finds the last saved config, checks it and converts it to the current version
  */
 void eeemu_Init(void);
 
 /**
- * @brief returns  the pointer to the last stored configuration. Size is @ref MAX_STORED
- *
+ * @brief returns the last stored configuration. It's a RAM copy that was checked at @ref eeemu_Init
+ * @return config
  */
-uint8_t * eeemuGetValue(void);
+const Config_t * eeemuGetConfig(void);
 /**
- * @brief stores config block to the eeprom emulation page
- * @param value pointer to the block of values. Size is @ref MAX_STORED
+ * @brief stores config to the eeprom emulation page
+ * @param config config
  */
-void eeemu_write(uint8_t * const value);
+void eeemu_write(const Config_t * const config);
 /**
  * @brief Returns previous saved prng value.
  * @return the value
@@ -40,6 +79,12 @@ uint16_t eeemuSeedGet(void);
  * @param seed the value
  */
 void eeemuSeedSet(const uint16_t seed);
+/**
+ * @brief Returns the wear of the most worn page of the config or the seed storage
+ * @param seed nonzero for the seed page
+ * @return wear in percents of the flash endurance, up to 99 to fit the two digit display
+ */
+uint8_t eeemuGetWear(const uint8_t seed);
 
 
 #endif /* SOURCES_PROJECT_HAL_INCLUDE_EEEMU_H_ */
@@ -0,0 +1,69 @@
+#ifndef SOURCES_PROJECT_HAL_INCLUDE_FLASH_H_
+#define SOURCES_PROJECT_HAL_INCLUDE_FLASH_H_
+/**
+ * @file flash.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.10
+ * @brief Contains asynchronous flash erase/program driver prototypes. Jobs are queued and done in order one by one,
+ * every next step is started from the flash end of operation interrupt.
+ * A job is started only when the led strip is not being sent: the F103 has one flash bank, so the cpu stalls on
+ * every flash fetch while the flash is busy and the strip dma interrupt that refills the bit buffer would be late.
+ * Every finished job is read back: a page must be erased and programmed halfwords must match the data
+ */
+#include <stdint.h>
+
+/**
+ * @brief Job completion callback. Is called from the flash interrupt, or from a waiting call if the job has timed out
+ * @param ok nonzero if the flash reported no error and the read back matches
+ */
+typedef void (*pFlashDone_t)(const uint8_t ok);
+
+enum
+{
+	FLASH_QUEUE_LEN = 8,     /**< Maximal number of queued jobs */
+	FLASH_JOB_HALFWORDS = 8, /**< Maximal number of halfwords programmed by one job */
+	FLASH_PAGE_SIZE = 1024,  /**< Page size in bytes */
+	FLASH_ENDURANCE = 10000, /**< Guaranteed number of erase cycles of a page, see the STM32F103x8 datasheet */
+	FLASH_TIMEOUT_MS = 50    /**< A wait fails the jobs if none is done for this time. Page erase takes up to 40ms */
+};
+
+/**
+ * @brief Enables the flash interrupt
+ */
+void Flash_Init(void);
+
+/**
+ * @brief Queues page erase. Waits if the queue is full, see @ref FLASH_TIMEOUT_MS
+ * @param page page address
+ * @param done completion callback or NULL
+ */
+void Flash_Erase(volatile uint16_t * const page, const pFlashDone_t done);
+
+/**
+ * @brief Queues programming of halfwords. Data is copied to the job so it can be a local variable. Waits if the queue is full, see @ref FLASH_TIMEOUT_MS
+ * @param dst flash address. Must be erased
+ * @param src data
+ * @param n number of halfwords, up to @ref FLASH_JOB_HALFWORDS
+ * @param done completion callback or NULL
+ */
+void Flash_Program(volatile uint16_t * const dst, const uint16_t * const src, const uint8_t n, const pFlashDone_t done);
+
+/**
+ * @brief Starts the next job if the flash and the led strip are idle. Is called from the main loop
+ */
+void Flash_Process(void);
+
+/**
+ * @brief Checks if there are jobs that are not done
+ * @return nonzero if busy
+ */
+uint8_t Flash_IsBusy(void);
+
+/**
+ * @brief Waits until all queued jobs are done. Jobs are failed if none is done for @ref FLASH_TIMEOUT_MS
+ */
+void Flash_Flush(void);
+
+#endif /* SOURCES_PROJECT_HAL_INCLUDE_FLASH_H_ */
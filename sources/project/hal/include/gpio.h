@@ -19,6 +19,7 @@ typedef enum
 {
 	GPIO_HEARTBEAT = 0,/**< HEARTBEAT led */
 	GPIO_WS_OUT,       /**< Led strip out */
+	GPIO_WS_OUT2,      /**< Led strip out of the second row (parallel layout) */
 	GPIO_BUTTON,       /**< Button in */
 	GPIO_TOTAL         /**< Total number of GPIOs */
 }Gpio_Desc_t;
@@ -44,5 +45,10 @@ uint8_t Gpio_Read_Bit ( Gpio_Desc_t Gpio);
  * @param Pin Pointer where pin number will be placed. Must not be NULL
  */
 void Gpio_Get_Alt_PortPin(const Gpio_Desc_t Gpio,GPIO_TypeDef ** const Port,uint8_t * const Pin);
+/**
+ * @brief Routes the input pin to its EXTI line and enables interrupt request on both edges. NVIC is not touched
+ * @param Gpio input pin id
+ */
+void Gpio_Exti_Init(const Gpio_Desc_t Gpio);
 
 #endif /* SOURCE_DL_GPIO_H_ */
@@ -0,0 +1,78 @@
+#ifndef SOURCES_PROJECT_HAL_INCLUDE_PROFILER_H_
+#define SOURCES_PROJECT_HAL_INCLUDE_PROFILER_H_
+/**
+ * @file profiler.h
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains cpu profiler prototypes. Tasks and interrupts are measured by the DWT cycle counter.
+ * Is compiled in with -DPROFILING only, otherwise @ref PROFILE_START and @ref PROFILE_END are empty
+ */
+#include <stdint.h>
+#include "clock.h"
+
+/**
+ * @brief Measured code sections
+ */
+typedef enum
+{
+	PROF_TASK_HEARTBEAT = 0, /**< Heartbeat task */
+	PROF_TASK_LED_CONTROL,  /**< Led control task */
+	PROF_ISR_SYSTICK,       /**< Systick interrupt */
+	PROF_ISR_BUTTON,        /**< Button EXTI interrupt */
+	PROF_ISR_ADC_DMA,       /**< Adc dma interrupt */
+	PROF_ISR_STRIP_DMA,     /**< Strip dma interrupts */
+	PROF_ISR_FLASH,         /**< Flash end of operation interrupt */
+	PROF_TOTAL              /**< Number of sections */
+} Prof_Id_t;
+
+/**
+ * @brief Statistics of one section in cpu cycles
+ */
+typedef struct
+{
+	uint32_t calls; /**< Number of calls */
+	uint32_t min;   /**< Minimal cycles per call */
+	uint32_t avg;   /**< Average cycles per call. Is updated by @ref Profiler_Update */
+	uint32_t max;   /**< Maximal cycles per call */
+	uint64_t total; /**< Total cycles */
+} Prof_Entry_t;
+
+/**
+ * @brief Profiler statistics. Is read by debugger
+ */
+typedef struct
+{
+	Prof_Entry_t entries[PROF_TOTAL]; /**< Per section statistics */
+	uint8_t cpuLoad; /**< Percent of time not spent in sleep */
+} Profiler_t;
+
+#ifdef PROFILING
+extern volatile Profiler_t Profiler;
+
+/**
+ * @brief Adds one call of the section
+ * @param id section
+ * @param cycles cycles taken by the call
+ */
+void Profiler_Add(const Prof_Id_t id, const uint32_t cycles);
+/**
+ * @brief Recalculates averages and cpu load. Is called from the main loop
+ */
+void Profiler_Update(void);
+
+/**
+ * @brief Starts measuring of a section. Must be paired with @ref PROFILE_END in the same block
+ */
+#define PROFILE_START() const uint32_t profStart = GetCycleCounter()
+/**
+ * @brief Adds cycles from @ref PROFILE_START to the section
+ */
+#define PROFILE_END(id) Profiler_Add((id), GetCycleCounter() - profStart)
+#else
+#define PROFILE_START()
+#define PROFILE_END(id)
+#endif
+
+#endif /* SOURCES_PROJECT_HAL_INCLUDE_PROFILER_H_ */
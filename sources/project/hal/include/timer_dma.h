@@ -5,23 +5,62 @@
  * @author Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 21-11-2019
- * @version 1.00
- * @brief Contains timer2+dma driver prototypes to send data to led strip
+ * @version 1.20
+ * @brief Contains timer2+dma driver prototypes to send data to led strip.
+ * Channel 0 is timer2 ch1 (PA0). With @ref STRIP_LAYOUT_PARALLEL channel 1 is timer3 ch1 (PA6)
  */
+#include <stdint.h>
+#include "project_conf.h"
+
+#define STRIP_TIMER_CLOCK_HZ 64000000u /**< Timer clock */
+#define STRIP_BIT_TICKS      84u       /**< Timer period. One bit is sent every period (1.3125us) */
+
 /**
- * @brief Initialization of tim2+dma
+ * @brief Callback that refills one half of the circular bit buffer while the other half is being sent
+ * @param ch channel
+ * @param half Pointer to the half to refill
+ * @param size Half size in bytes
+ * @return nonzero while the stream continues, 0 to stop the transfer
+ */
+typedef uint8_t (*pFillHalf_t)(const uint8_t ch, uint8_t * const half, const uint16_t size);
+
+/**
+ * @brief Initialization of tim2+dma and tim3+dma for every channel used
  */
 void tim2_Init(void);
 /**
- * @brief Sets data to be sent
- * @param addr bit array address
- * @param size bit array size
+ * @brief Sets the circular buffer and its refill callback
+ * @param ch channel
+ * @param addr bit array address. Both halves of it are refilled by @ref fill
+ * @param size bit array size. Must be even
+ * @param fill refill callback. Is called from the DMA interrupt
+ */
+void tim2_set_data(const uint8_t ch, uint8_t * const addr, const uint16_t size, pFillHalf_t const fill);
+/**
+ * @brief Starts actual transfer. Does not wait: nothing is done if the channel is busy, the running stream gets
+ * the next data from its @ref pFillHalf_t callback. May be called with dma interrupts disabled
+ * @param ch channel
+ */
+void tim2_TransferBits(const uint8_t ch);
+/**
+ * @brief Checks if the transfer is in progress
+ * @param ch channel
+ * @return nonzero if the stream has not been stopped yet
+ */
+uint8_t tim2_IsBusy(const uint8_t ch);
+/**
+ * @brief Disables dma interrupts of all channels to change data that is used by @ref pFillHalf_t callback
+ */
+void tim2_DisableIrq(void);
+/**
+ * @brief Enables dma interrupts back
  */
-void tim2_set_data(uint8_t * const addr, const uint16_t size);
+void tim2_EnableIrq(void);
 /**
- * @brief Starts actual transfer
+ * @brief Returns number of half buffers that were not refilled in time on all channels
+ * @return underrun counter
  */
-void tim2_TransferBits(void);
+uint32_t tim2_GetUnderruns(void);
 
 
 #endif /* SOURCES_PROJECT_HAL_INCLUDE_TIMER_DMA_H_ */
@@ -10,6 +10,7 @@
 
 #include <stm32f1xx.h>
 #include "adc.h"
+#include "profiler.h"
 
 static volatile uint16_t Adc_Buf[ADC_AVG];
 
@@ -71,6 +72,7 @@ void DMA1_Channel1_IRQHandler(void);
  */
 void DMA1_Channel1_IRQHandler(void)
 {
+	PROFILE_START();
 	if ((DMA1->ISR & DMA_ISR_TCIF1) != 0)
 	{
 		DMA1->IFCR = DMA_IFCR_CTCIF1;
@@ -84,6 +86,7 @@ void DMA1_Channel1_IRQHandler(void)
 			tmp = Adc_Buf[i];
 		}
 	}
+	PROFILE_END(PROF_ISR_ADC_DMA);
 }
 
 /**
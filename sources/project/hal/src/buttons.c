@@ -3,13 +3,17 @@
  * @em mikl74@yahoo.com
  * @author Mykhaylo Shcherbak
  * @date 29-08-2016
- * @version 1.00
+ * @version 1.10
  * @brief Buttons driver with debouncing and long press detection.
+ * Edges are caught by EXTI interrupt with their time and are debounced by the time, so short presses are not lost
+ * between @ref Button_Process calls. Presses, releases and long presses are reported as events.
  */
 
 #include <stdint.h>
 #include "buttons.h"
 #include "gpio.h"
+#include "clock.h"
+#include "profiler.h"
 
 /**
  * @brief describes the current state of the button
@@ -25,15 +29,37 @@ enum ButtonState { NotExists=0, /**< No such button. Ignore all functions *///!<
 
 typedef uint8_t (*pButtonFunc_t)(void);
 
+enum
+{
+	EDGE_QUEUE = 16, /**< Edge queue length. Must be a power of 2 */
+	EVENT_QUEUE = 8  /**< Event queue length. Must be a power of 2 */
+};
+
 /**
  * @brief The button  description
  */
 typedef struct {
   enum ButtonState state; /**< The button state */
   pButtonFunc_t buttonFunc;
-  uint16_t count; /**< Tics counter */
+  uint8_t level; /**< Debounced level. Nonzero if pressed */
+  uint8_t raw; /**< Level after the last edge */
+  uint8_t longSent; /**< Nonzero if @ref BUTTON_EVENT_LONG was sent for the current press */
+  uint32_t changeTime; /**< Tick when @ref level was changed */
+  uint32_t rawTime; /**< Tick of the last edge */
+  ButtonEvent_t events[EVENT_QUEUE]; /**< Event queue */
+  uint8_t eventHead; /**< Event queue write index */
+  uint8_t eventTail; /**< Event queue read index */
 } Buttons_t;
 
+/**
+ * @brief Edge captured by the EXTI interrupt
+ */
+typedef struct
+{
+	uint32_t time; /**< Tick of the edge */
+	uint8_t level; /**< Pin level after the edge */
+} Edge_t;
+
 static uint8_t ButtonState(void)
 {
 	return Gpio_Read_Bit(GPIO_BUTTON); /* Button is NC, if pressed, high level is on the pin */
@@ -42,63 +68,148 @@ static uint8_t ButtonState(void)
 /**
  * @brief Button state array
  */
-static volatile  Buttons_t Buttons[B_MAX]={{Released,ButtonState,0}};
+static Buttons_t Buttons[B_MAX]={{Released,ButtonState,0,0,0,0,0,{BUTTON_EVENT_NONE},0,0}};
+
+/**
+ * @brief Edges of @ref B_CONFIG. Single producer (EXTI interrupt), single consumer (@ref Button_Process) queue, so no locking is needed
+ */
+static volatile Edge_t Edges[EDGE_QUEUE];
+static volatile uint8_t EdgeHead = 0; /**< Is written by the interrupt only */
+static volatile uint8_t EdgeTail = 0; /**< Is written by @ref Button_Process only */
+static volatile uint32_t EdgeOverflows = 0;
+static uint32_t EventOverflows = 0;
+
+void EXTI2_IRQHandler(void);
+/**
+ * @brief EXTI interrupt of @ref GPIO_BUTTON (PA2). Puts the edge time and the pin level to the edge queue
+ */
+void EXTI2_IRQHandler(void)
+{
+	PROFILE_START();
+	EXTI->PR = EXTI_PR_PR2;
+	const uint8_t head = EdgeHead;
+	const uint8_t next = (head + 1) & (EDGE_QUEUE - 1);
+	if (next != EdgeTail)
+	{
+		Edges[head].time = GetTicksCounter();
+		Edges[head].level = ButtonState();
+		EdgeHead = next;
+	}
+	else
+	{
+		EdgeOverflows++; /* The level is recovered by the next Button_Process */
+	}
+	PROFILE_END(PROF_ISR_BUTTON);
+}
+
+/**
+ * @brief Puts the event to the button event queue
+ * @param button the button
+ * @param event the event
+ */
+static void pushEvent(Buttons_t * const button, const ButtonEvent_t event)
+{
+	const uint8_t next = (button->eventHead + 1) & (EVENT_QUEUE - 1);
+	if (next != button->eventTail)
+	{
+		button->events[button->eventHead] = event;
+		button->eventHead = next;
+	}
+	else
+	{
+		EventOverflows++;
+	}
+}
+
+/**
+ * @brief Applies the level of the last edge if @ref BUTTON_DEBOUNCE_MS has passed from the previous level change.
+ * The change is dated by the edge so the following one is not taken for a bounce
+ * @param button the button
+ * @param time current time
+ */
+static void settle(Buttons_t * const button, const uint32_t time)
+{
+	if (button->raw != button->level && (int32_t)(time - button->changeTime) >= BUTTON_DEBOUNCE_MS)
+	{
+		button->level = button->raw;
+		button->changeTime = button->rawTime;
+		button->longSent = 0;
+		pushEvent(button, (button->level != 0) ? BUTTON_EVENT_PRESS : BUTTON_EVENT_RELEASE);
+	}
+}
+
+/**
+ * @brief Debounces one edge. The first edge changes the level at once, the following ones are kept for @ref BUTTON_DEBOUNCE_MS
+ * and the last of them is applied after that
+ * @param button the button
+ * @param time edge time
+ * @param level level after the edge
+ */
+static void processEdge(Buttons_t * const button, const uint32_t time, const uint8_t level)
+{
+	settle(button, time);
+	if (level != button->raw)
+	{
+		button->raw = level;
+		button->rawTime = time;
+	}
+	settle(button, time);
+}
 
 void Button_Process(const Buttons_id_t Button_id)
 {
-	volatile Buttons_t *button=Buttons+Button_id;
-	if (button->state==NotExists) return;
-	if ( button->buttonFunc() == 0) /* Button is released */
-		switch (button->state)
+	Buttons_t * const button = Buttons + Button_id;
+	if (button->state == NotExists) return;
+	if (Button_id == B_CONFIG)
+	{
+		while (EdgeTail != EdgeHead)
 		{
-
-		case LongReleased:
-			return;
-		case SteadyReleased:
-			if ((button->count++)>=BUTTONLONGWAIT)
-			{
-				button->count=BUTTONLONGWAIT;
-				button->state=LongReleased;
-			}
-			return;
-		case Released:
-			if ((button->count++)>=BUTTONWAIT)
-			{
-				button->count=BUTTONWAIT;
-				button->state=SteadyReleased;
-			}
-			return;
-		default:
-			button->count=0;
-			button->state=Released;
-			return;
+			const uint8_t tail = EdgeTail;
+			processEdge(button, Edges[tail].time, Edges[tail].level);
+			EdgeTail = (tail + 1) & (EDGE_QUEUE - 1);
 		}
-	else
+	}
+	const uint32_t now = GetTicksCounter();
+	processEdge(button, now, button->buttonFunc()); /* The level after bounces or lost edges */
+	const uint32_t held = now - button->changeTime;
+	if (button->level != 0)
 	{
-		switch (button->state)
-		{ /* Button is pressed */
-		case LongPressed:
-			return;
-		case SteadyPressed:
-			if ((button->count++)>=BUTTONLONGWAIT)
-			{
-				button->count=BUTTONLONGWAIT;
-				button->state=LongPressed;
-			}
-			return;
-		case Pressed:
-			if ((button->count++)>=BUTTONWAIT)
-			{
-				button->count=BUTTONWAIT;
-				button->state=SteadyPressed;
-			}
-			return;
-		default:
-			button->count=0;
-			button->state=Pressed;
-			return;
+		if (button->longSent == 0 && held >= BUTTON_LONG_MS)
+		{
+			button->longSent = !0;
+			pushEvent(button, BUTTON_EVENT_LONG);
 		}
+		button->state = (held < BUTTON_DEBOUNCE_MS) ? Pressed : ((button->longSent != 0) ? LongPressed : SteadyPressed);
 	}
+	else
+	{
+		button->state = (held < BUTTON_DEBOUNCE_MS) ? Released : ((held >= BUTTON_LONG_MS) ? LongReleased : SteadyReleased);
+	}
+}
+
+ButtonEvent_t Button_GetEvent(const Buttons_id_t button_id)
+{
+	ButtonEvent_t event = BUTTON_EVENT_NONE;
+	Buttons_t * const button = Buttons + button_id;
+	if (button_id < B_MAX && button->eventTail != button->eventHead)
+	{
+		event = button->events[button->eventTail];
+		button->eventTail = (button->eventTail + 1) & (EVENT_QUEUE - 1);
+	}
+	return event;
+}
+
+void Button_FlushEvents(const Buttons_id_t button_id)
+{
+	if (button_id < B_MAX)
+	{
+		Buttons[button_id].eventTail = Buttons[button_id].eventHead;
+	}
+}
+
+uint32_t Button_GetOverflows(void)
+{
+	return EdgeOverflows + EventOverflows;
 }
 
 void Buttons_Init(void)
@@ -109,20 +220,31 @@ void Buttons_Init(void)
   /* Use initial state for filling array */
   for (b=0; b < B_MAX; b++)
   {
-	  Buttons[b].state=(Buttons[b].buttonFunc() == 0) ? Released : Pressed;
+	  Buttons[b].level = Buttons[b].buttonFunc();
+	  Buttons[b].raw = Buttons[b].level;
+	  Buttons[b].state = (Buttons[b].level == 0) ? Released : Pressed;
+	  Buttons[b].changeTime = GetTicksCounter();
   }
+  Gpio_Exti_Init(GPIO_BUTTON);
+  NVIC_EnableIRQ(EXTI2_IRQn);
 }
 
 void WaitButtonPress(Buttons_id_t button)
 {
    if (Buttons[button].state==NotExists) return;
-   while (Buttons[button].state!=SteadyPressed&&Buttons[button].state!=LongPressed);
+   while (Buttons[button].state!=SteadyPressed&&Buttons[button].state!=LongPressed)
+   {
+	   Button_Process(button);
+   }
 }
 
 void WaitButtonRelease(Buttons_id_t button)
 {
    if (Buttons[button].state==NotExists) return;
-   while (Buttons[button].state!=SteadyReleased&&Buttons[button].state!=LongReleased);
+   while (Buttons[button].state!=SteadyReleased&&Buttons[button].state!=LongReleased)
+   {
+	   Button_Process(button);
+   }
 }
 
 
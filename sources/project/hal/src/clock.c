@@ -8,8 +8,40 @@
 #include "stm32f1xx.h"
 #include "clock.h"
 #include "gpio.h"
+#include "profiler.h"
 
+enum
+{
+	TICK_CYCLES = CPU_FREQ / SYSTICK_FREQ /**< Cpu cycles per tick */
+};
+
+/**
+ * @brief Ticks counter at the beginning of the current systick period
+ */
 static volatile uint32_t Counter = 0;
+/**
+ * @brief Length of the current systick period in ticks
+ */
+static volatile uint32_t curStep = 1;
+/**
+ * @brief Length of the next systick period in ticks. It's loaded to the timer on reload
+ */
+static volatile uint32_t nextStep = 1;
+
+/**
+ * @brief Sleep statistics of the current window in cycles
+ */
+static uint32_t sleepCycles = 0;
+static uint32_t totalCycles = 0;
+static uint32_t lastStamp = 0;
+static uint8_t sleepPercent = 0;
+
+/**
+ * @brief The nearest expiry of the timers checked by @ref IsExpiredTimer since @ref Clock_ResetNextExpiry.
+ * Is a hint for the scheduler so it's not protected from interrupts
+ */
+static uint32_t nextExpiry;
+static uint8_t nextExpiryValid; /**< Nonzero if @ref nextExpiry was set */
 
 /**
  * @brief Inits HSE as a main clock. PLL is setup to *9
@@ -43,14 +75,55 @@ void Clock_HSE_Init(void)
  */
 void Systick_Init(void)
 {
-	SysTick_Config( CPU_FREQ / SYSTICK_FREQ);
+	SysTick_Config(TICK_CYCLES);
+	DBGMCU->CR |= DBGMCU_CR_DBG_SLEEP; /* Keep debugger connected while in WFI */
 }
 
 void SysTick_Handler(void);
 
+/**
+ * @brief Adds the period that has just finished to the counter. The period that has just been loaded is @ref nextStep,
+ * the following ones are 1 tick long again
+ */
 void SysTick_Handler(void)
 {
-	Counter++;
+	PROFILE_START();
+	Counter += curStep;
+	curStep = nextStep;
+	if (nextStep != 1)
+	{
+		nextStep = 1;
+		SysTick->LOAD = TICK_CYCLES - 1;
+	}
+	PROFILE_END(PROF_ISR_SYSTICK);
+}
+
+/**
+ * @brief Returns the time in cpu cycles. Wraps every 67s. Takes into account the part of the systick period that has elapsed
+ * and the period that has been reloaded but not yet added by the interrupt
+ * @return cycles
+ */
+static uint32_t getCycles(void)
+{
+	uint32_t cnt;
+	uint32_t step;
+	uint32_t next;
+	uint32_t pend;
+	uint32_t val;
+	do
+	{
+		cnt = Counter;
+		step = curStep;
+		next = nextStep;
+		pend = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+		val = SysTick->VAL;
+	} while (cnt != Counter || pend != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));
+	if (pend != 0)
+	{
+		cnt += step; /* VAL belongs to the new period already */
+		step = next;
+	}
+	return cnt * TICK_CYCLES + (step * TICK_CYCLES - 1 - val);
 }
 
 /**
@@ -59,7 +132,7 @@ void SysTick_Handler(void)
  */
 void ResetTimer(uint32_t * const Timer)
 {
-	*Timer = Counter;
+	*Timer = GetTicksCounter();
 }
 
 /**
@@ -70,16 +143,105 @@ void ResetTimer(uint32_t * const Timer)
  */
 uint8_t IsExpiredTimer(uint32_t * const Timer, const uint32_t Timeout)
 {
-	return Counter >= *Timer + Timeout ;
+	const uint32_t expiry = *Timer + Timeout;
+	const uint8_t expired = GetTicksCounter() >= expiry;
+	if (expired == 0 && (nextExpiryValid == 0 || expiry < nextExpiry))
+	{
+		nextExpiry = expiry;
+		nextExpiryValid = !0;
+	}
+	return expired;
+}
+
+void Clock_ResetNextExpiry(void)
+{
+	nextExpiryValid = 0;
+}
+
+uint32_t Clock_TimeToNextExpiry(void)
+{
+	uint32_t left = UINT32_MAX;
+	if (nextExpiryValid != 0)
+	{
+		const uint32_t now = GetTicksCounter();
+		left = (nextExpiry > now) ? nextExpiry - now : 0;
+	}
+	return left;
 }
 
 uint32_t ReadTimer(uint32_t * const Timer)
 {
-	return Counter - *Timer;
+	return GetTicksCounter() - *Timer;
 }
 
 uint32_t GetTicksCounter(void)
 {
-	return Counter;
+	uint32_t cnt;
+	uint32_t step;
+	uint32_t val;
+	do
+	{
+		cnt = Counter;
+		step = curStep;
+		val = SysTick->VAL;
+	} while (cnt != Counter);
+	if (step != 1)
+	{
+		const uint32_t elapsed = (step * TICK_CYCLES - 1 - val) / TICK_CYCLES;
+		cnt += (elapsed < step) ? elapsed : step - 1;
+	}
+	return cnt;
+}
+
+void Clock_Sleep(uint32_t ms)
+{
+	if (ms != 0)
+	{
+		ms = (ms > SLEEP_MAX_MS) ? SLEEP_MAX_MS : ms;
+		const uint32_t start = getCycles();
+		__disable_irq();
+		if (ms > 1 && curStep == 1 && nextStep == 1)
+		{
+			/* The current 1 tick period ends first, then the long one is loaded */
+			nextStep = ms - 1;
+			SysTick->LOAD = nextStep * TICK_CYCLES - 1;
+			if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0 && SysTick->VAL < TICK_CYCLES)
+			{
+				/* The 1 tick period had reloaded before LOAD was written, so it's running again and the interrupt
+				 * would take the long period for it. The sleep is set up again after the interrupt */
+				nextStep = 1;
+				SysTick->LOAD = TICK_CYCLES - 1;
+			}
+		}
+		__WFI(); /* Wakes up on a pending interrupt even if they are disabled */
+		__enable_irq();
+		const uint32_t end = getCycles();
+		sleepCycles += end - start;
+		totalCycles += end - lastStamp;
+		lastStamp = end;
+		if (totalCycles >= CPU_FREQ)
+		{
+			sleepPercent = (uint8_t)(sleepCycles / (totalCycles / 100u));
+			sleepCycles = 0;
+			totalCycles = 0;
+		}
+	}
+}
+
+uint8_t Clock_GetSleepPercent(void)
+{
+	return sleepPercent;
+}
+
+void CycleCounter_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t GetCycleCounter(void)
+{
+	return DWT->CYCCNT;
 }
 
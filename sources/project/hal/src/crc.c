@@ -0,0 +1,57 @@
+/**
+ * @file crc.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains crc32 implementation by the crc unit or by a nibble table in software
+ */
+#include "crc.h"
+#include "project_conf.h"
+#if CRC_SOFTWARE == 0
+#include "stm32f1xx.h"
+#endif
+
+#if CRC_SOFTWARE == 0
+void Crc_Init(void)
+{
+	RCC->AHBENR |= RCC_AHBENR_CRCEN;
+}
+
+uint32_t Crc32(const uint32_t * const data, const uint16_t nwords)
+{
+	CRC->CR = CRC_CR_RESET;
+	for (uint16_t i = 0; i < nwords; i++)
+	{
+		CRC->DR = data[i];
+	}
+	return CRC->DR;
+}
+#else
+/**
+ * @brief crc of every nibble value shifted to the top of the word
+ */
+static const uint32_t crcTable[16] =
+{
+	0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9, 0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+	0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61, 0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD
+};
+
+void Crc_Init(void)
+{
+}
+
+uint32_t Crc32(const uint32_t * const data, const uint16_t nwords)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for (uint16_t i = 0; i < nwords; i++)
+	{
+		crc ^= data[i];
+		for (uint8_t n = 0; n < 8; n++)
+		{
+			crc = (crc << 4) ^ crcTable[crc >> 28];
+		}
+	}
+	return crc;
+}
+#endif
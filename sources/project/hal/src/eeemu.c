@@ -6,62 +6,113 @@
  * @author Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 19-11-2019
- * @version 1.00
- * @brief eeprom emulation implementation
+ * @version 1.50
+ * @brief eeprom emulation implementation. Flash is written by the asynchronous flash driver, the current values are kept in RAM.
+ * Page headers keep the page erase counters for @ref eeemuStats
  *
  */
 
 #include "eeemu.h"
 #include <stdint.h>
 #include <string.h>
-#include "stm32f1xx.h"
+#include "flash.h"
+#include "crc.h"
 
 /**
- * @brief Storage element structure
+ * @brief Config record. It's protected by crc32 of the first three words
  */
 typedef struct
 {
-	uint8_t stored[MAX_STORED]; /**< Data itself */
+	uint8_t version; /**< @ref CONFIG_VERSION of the firmware that has written the record */
+	uint8_t stored[11]; /**< @ref Config_t and the space for new fields */
+	uint32_t crc; /**< CRC32 protection */
+} eeemu_record_s;
+
+/**
+ * @brief union for the config record
+ */
+typedef union
+{
+	uint32_t words[sizeof(eeemu_record_s)/sizeof(uint32_t)]; /**< Record as words for the crc calculation */
+	uint16_t raw[sizeof(eeemu_record_s)/sizeof(uint16_t)]; /**< Record as halfwords for the flash programming */
+	eeemu_record_s structured; /**< Structured data */
+}eeemu_record_t;
+
+_Static_assert(sizeof(Config_t) <= sizeof(((eeemu_record_s *)0)->stored), "Config does not fit the record");
+
+/**
+ * @brief Storage element of the firmware before @ref CONFIG_VERSION 1. It's read only to convert the config
+ */
+typedef struct
+{
+	uint8_t stored[9]; /**< Data itself */
 	uint8_t crc8; /**< CRC8 protection */
 } eeemu_storage_s;
 
 /**
- * @brief union for the storage element
+ * @brief union for the old storage element
  */
 typedef union
 {
-	uint16_t raw[sizeof(eeemu_storage_s) % sizeof(uint16_t) == 1 ? sizeof(eeemu_storage_s)/sizeof(uint16_t) + 1 : sizeof(eeemu_storage_s)/sizeof(uint16_t)]; /**< Storage element alligned to 2bytes size as a raw array*/
+	uint16_t raw[sizeof(eeemu_storage_s)/sizeof(uint16_t)]; /**< Storage element as a raw array */
 	eeemu_storage_s structured; /**< Structured data */
 }eeemu_storage_t;
 
 enum
 {
-	MAXSTORAGE = 1024/sizeof(eeemu_storage_t), /**< Maximum number of storage elements in the page */
-	DEFAULT_VALUE = 0, /**< Default values for the storage elements */
-	SEED_NOT_INITED = 0xFFFF /**< Value to find first uninited element for seed storage. seed/prng is 15bits long so 0xFFFF is not a valid number */
+	PAGE_HALFWORDS = 1024/sizeof(uint16_t), /**< Page size */
+	RECORD_HALFWORDS = sizeof(eeemu_record_t)/sizeof(uint16_t), /**< Config record size */
+	OLD_HALFWORDS = sizeof(eeemu_storage_t)/sizeof(uint16_t), /**< Old storage element size */
+	MAXSTORAGE = 1024/sizeof(eeemu_record_t), /**< Maximum number of config records in the page */
+	OLD_MAXSTORAGE = 1024/sizeof(eeemu_storage_t), /**< Maximum number of old storage elements in the page */
+	SEED_NOT_INITED = 0xFFFF, /**< Value to find first uninited element for seed storage. seed/prng is 15bits long so 0xFFFF is not a valid number */
+	EEEMU_PAGES = 2, /**< Number of config pages */
+	HEADER_MAGIC = 0xEE5B, /**< The first halfword of a page header. The page keeps config records */
+	FIRST_RECORD = 1, /**< Index of the first record in a page with a header. Header takes element 0 */
+	HEADER_ERASES = 5, /**< Index of the erase counter low halfword in the header of the page with config records */
+	SEEDS = 1024/sizeof(uint16_t), /**< Number of seeds in the page */
+	SEED_MAGIC = 0xA55E, /**< The first halfword of the seed page header. Bit 15 is set so it's not a valid seed */
+	SEED_FIRST = 3 /**< Index of the first seed in a page with a header: magic, erase counter low and high halfwords */
 };
 
 /**
- * @brief flash page for holding configs
+ * @brief Page formats
+ */
+typedef enum
+{
+	PAGE_INVALID = 0, /**< No valid header */
+	PAGE_RECORDS      /**< Header and config records */
+}Page_Format_t;
+
+/**
+ * @brief flash pages for holding configs. The first one is at the place of the old single page so configs written by older firmware are read.
+ * The page with a valid header and the newer sequence number is active, the other keeps the previous configs until the active page is full.
+ * When it's full the other page is erased, the new config is written to it and its header is written the last so the page swap is atomic.
+ * A power loss at any point leaves at least one page with a valid header and a valid config
  */
-static volatile eeemu_storage_t __attribute__((__section__ (".eeemu"))) eeemu_array[MAXSTORAGE];
+static volatile uint16_t __attribute__((__section__ (".eeemu"))) eeemu_array[PAGE_HALFWORDS];
+static volatile uint16_t __attribute__((__section__ (".eeemu2"))) eeemu_array2[PAGE_HALFWORDS]; /**< The second config page */
+static volatile uint16_t * const pages[EEEMU_PAGES] = {eeemu_array, eeemu_array2}; /**< Config pages */
 /**
  * @brief flash page for storing prng
  */
-static volatile uint16_t __attribute__((__section__ (".seed"))) seeds_array[1024/sizeof(uint16_t)];
-
-static uint16_t next_pos = 0;
+static volatile uint16_t __attribute__((__section__ (".seed"))) seeds_array[SEEDS];
 
+static uint8_t activePage = 0; /**< Page where the configs are written to */
+static uint8_t activeValid = 0; /**< Nonzero if @ref activePage has a valid header or configs written by older firmware */
+static uint16_t activeSeq = 0; /**< Sequence number of @ref activePage */
+static uint16_t next_pos = 0; /**< The first erased record of @ref activePage */
+static uint16_t seed_pos = SEED_NOT_INITED; /**< The last stored seed */
+static uint16_t seedFirst = 0; /**< The first seed of the seed page. 0 if the page was written by older firmware without a header */
+static uint16_t seedValue = SEED_NOT_INITED; /**< The last stored seed value. Flash is written later by the flash driver so values are kept in RAM */
+static const Config_t defaultConfig = {0}; /**< Config that is used if nothing is stored */
 /**
- * @brief Waiting for flash write operation complete
+ * @brief Size of the stored config for every @ref CONFIG_VERSION. Version 0 is the old storage element.
+ * A new entry must be added when @ref CONFIG_VERSION is incremented
  */
-inline static void  waitBusy(void)
-{
-	while ((FLASH->SR & FLASH_SR_BSY) != 0)
-	{
-
-	}
-}
+static const uint8_t configSize[CONFIG_VERSION + 1] = {sizeof(((eeemu_storage_s *)0)->stored), 9};
+static Config_t current; /**< The last stored config */
+volatile Eeemu_Stats_t eeemuStats;
 
 /**
  * @brief crc8 calcualation for data block
@@ -86,126 +137,361 @@ static uint8_t crc8(uint8_t *data, uint8_t const  len)
 }
 
 /**
- * @brief Erasing a flash page
- * @param addr flash page addr
+ * @brief Flash job completion callback. Counts failed jobs
+ * @param ok nonzero if the job succeeded
  */
-static void eeemuErasePage(uint32_t const addr)
+static void eeemuFlashDone(const uint8_t ok)
 {
-	waitBusy();
-	FLASH->KEYR = 0x45670123;
-	FLASH->KEYR = 0xCDEF89AB;
-	FLASH->CR |= FLASH_CR_PER;
-	FLASH->AR = addr;
-	FLASH->CR |= FLASH_CR_STRT;
-	waitBusy();
-	FLASH->CR &= ~FLASH_CR_PER;
-	FLASH->CR |= FLASH_CR_LOCK;
+	if (ok == 0 && eeemuStats.failedJobs != UINT16_MAX)
+	{
+		eeemuStats.failedJobs++;
+	}
 }
 
 /**
- * @brief Searching for the last stored prng
- * @return last stored value or @ref SEED_NOT_INITED if nothing is stored
+ * @brief Queues erasing of a flash page. The page reads as the old data until the job is done
+ * @param page flash page
+ */
+static void eeemuErasePage(volatile uint16_t * const page)
+{
+	Flash_Erase(page, eeemuFlashDone);
+}
+
+/**
+ * @brief Queues programming of halfwords to the erased flash. Jobs are done in order so the page swap order is kept
+ * @param dst flash address
+ * @param src data
+ * @param n number of halfwords
+ */
+static void eeemuProgram(volatile uint16_t * const dst, const uint16_t * const src, const uint16_t n)
+{
+	Flash_Program(dst, src, n, eeemuFlashDone);
+}
+
+/**
+ * @brief Erases the seed page and writes its header with the incremented erase counter
+ */
+static void eeemuEraseSeedPage(void)
+{
+	const uint32_t erases = eeemuStats.seedErases + 1;
+	const uint16_t header[SEED_FIRST] = {SEED_MAGIC, (uint16_t)erases, (uint16_t)(erases >> 16)};
+	eeemuErasePage(seeds_array);
+	/* The magic is written the last so a header cut by a power loss is not valid */
+	eeemuProgram(&seeds_array[1], &header[1], SEED_FIRST - 1);
+	eeemuProgram(&seeds_array[0], header, 1);
+	eeemuStats.seedErases = erases;
+	seedFirst = SEED_FIRST;
+}
+
+/**
+ * @brief Reads the erase counter of the page header
+ * @param raw header halfwords of the counter
+ * @return erase counter, 0 if it was not written
+ */
+static uint32_t readCounter(const volatile uint16_t * const raw)
+{
+	const uint32_t counter = (uint32_t)raw[0] | ((uint32_t)raw[1] << 16);
+	return (counter == UINT32_MAX) ? 0 : counter;
+}
+
+/**
+ * @brief Searching for the last stored prng. Seeds are written one by one and have bit 15 clear so the binary search is used
+ * @return last stored value index or @ref SEED_NOT_INITED if nothing is stored
  */
 static uint16_t getCurrentSeedIdx(void)
 {
-	uint16_t i;
-	for (i = 0; i < 1024/sizeof(seeds_array[0]); i++)
+	uint16_t first = seedFirst;
+	uint16_t last = SEEDS;
+	while (first < last)
 	{
-		if (0 != (seeds_array[i] & 0x8000))
+		const uint16_t mid = first + (last - first) / 2;
+		if (0 != (seeds_array[mid] & 0x8000))
 		{
-			break;
+			last = mid;
+		}
+		else
+		{
+			first = mid + 1;
 		}
 	}
-	return (i == 0) ? SEED_NOT_INITED : i - 1;
+	return (first == seedFirst) ? SEED_NOT_INITED : first - 1;
 }
 
+/**
+ * @brief Checks if the halfwords were not written after erase
+ * @param raw halfwords
+ * @param n number of halfwords
+ * @return nonzero if erased
+ */
+static uint8_t isErased(const volatile uint16_t * const raw, const uint8_t n)
+{
+	uint8_t erased = !0;
+	for (uint8_t i = 0; i < n; i++)
+	{
+		erased = erased && (raw[i] == 0xFFFF);
+	}
+	return erased;
+}
 
-void eeemu_write(uint8_t * const values)
+/**
+ * @brief Reads the config record and checks its crc
+ * @param raw record in the flash
+ * @param record out parameter. RAM copy of the record
+ * @return nonzero if the record is valid
+ */
+static uint8_t readRecord(const volatile uint16_t * const raw, eeemu_record_t * const record)
 {
-	uint8_t i = 0;
-	for (i = 0 ; i < sizeof(eeemu_storage_s)/sizeof(uint16_t); i++)
+	for (uint8_t i = 0; i < RECORD_HALFWORDS; i++)
 	{
-		if (eeemu_array[next_pos].raw[i] != 0xFFFF)
-		{
-			break;
-		}
+		record->raw[i] = raw[i];
 	}
+	return record->structured.crc == Crc32(record->words, sizeof(record->words)/sizeof(record->words[0]) - 1);
+}
 
-	if (i < sizeof(eeemu_storage_s)/sizeof(uint16_t) || next_pos == MAXSTORAGE) /* Wrong record or page full */
+/**
+ * @brief Reads the old storage element and checks its crc
+ * @param raw element in the flash
+ * @param element out parameter. RAM copy of the element
+ * @return nonzero if the element is valid
+ */
+static uint8_t readOld(const volatile uint16_t * const raw, eeemu_storage_t * const element)
+{
+	for (uint8_t i = 0; i < OLD_HALFWORDS; i++)
 	{
-		eeemuErasePage((uint32_t)(&eeemu_array[0]));
-		next_pos = 0;
+		element->raw[i] = raw[i];
 	}
-	eeemu_storage_t u;
-	memcpy(u.structured.stored,values,MAX_STORED);
-	u.structured.crc8 = crc8(values,MAX_STORED);
-	waitBusy();
-	FLASH->KEYR = 0x45670123;
-	FLASH->KEYR = 0xCDEF89AB;
-	FLASH->CR |= FLASH_CR_PG;
-	for (uint8_t i = 0; i < sizeof(eeemu_storage_t)/sizeof(uint16_t); i++ )
+	return element->structured.crc8 == crc8(element->structured.stored,sizeof(element->structured.stored));
+}
+
+/**
+ * @brief Reads the page header
+ * @param page page number
+ * @param seq out parameter. Page sequence number
+ * @return page format
+ */
+static Page_Format_t readHeader(const uint8_t page, uint16_t * const seq)
+{
+	const volatile uint16_t * const raw = pages[page];
+	Page_Format_t format = PAGE_INVALID;
+	*seq = raw[1];
+	if ((uint16_t)(raw[2] ^ raw[1]) == 0xFFFF && raw[3] == 0xFFFF && raw[4] == 0xFFFF)
 	{
-		eeemu_array[next_pos].raw[i] = u.raw[i];
-		waitBusy();
+		format = (raw[0] == HEADER_MAGIC) ? PAGE_RECORDS : PAGE_INVALID;
+	}
+	return format;
+}
+
+/**
+ * @brief Finds the first erased element of the page. Elements are written one by one so the written ones go first and
+ * the binary search is used
+ * @param page page number
+ * @param first the first element to look at
+ * @param size element size in halfwords
+ * @param n number of elements in the page
+ * @return element index, n if the page is full
+ */
+static uint16_t findEnd(const uint8_t page, uint16_t first, const uint8_t size, uint16_t n)
+{
+	while (first < n)
+	{
+		const uint16_t mid = first + (n - first) / 2;
+		if (isErased(pages[page] + mid * size, size))
+		{
+			n = mid;
+		}
+		else
+		{
+			first = mid + 1;
+		}
 	}
-	FLASH->CR &= ~FLASH_CR_PG;
-	FLASH->CR |= FLASH_CR_LOCK;
-	next_pos++;
+	return first;
+}
 
+/**
+ * @brief Converts stored config of any version to the current one. Fields are only added to the end of @ref Config_t
+ * so the stored data is its prefix and the rest gets default values
+ * @param data stored config
+ * @param size size of the stored config
+ */
+static void convertConfig(const uint8_t * const data, const uint8_t size)
+{
+	current = defaultConfig;
+	memcpy(&current, data, (size < sizeof(current)) ? size : sizeof(current));
 }
 
-void eeemu_Init(void)
+/**
+ * @brief Opens the page with config records: finds the first erased record and the last valid one before it.
+ * Only the records after an interrupted write are checked by crc
+ * @param page page number
+ */
+static void openPage(const uint8_t page)
 {
-	uint16_t i;
-	for (i = 0 ; i < MAXSTORAGE; i++)
+	activePage = page;
+	activeValid = !0;
+	next_pos = findEnd(page, FIRST_RECORD, RECORD_HALFWORDS, MAXSTORAGE);
+	for (uint16_t i = next_pos; i > FIRST_RECORD; i--)
 	{
+		eeemu_record_t record;
+		if (readRecord(pages[page] + (i - 1) * RECORD_HALFWORDS, &record))
+		{
+			/* Newer firmware keeps the older fields at the same place so its records are read as a prefix too */
+			const uint8_t version = record.structured.version;
+			convertConfig(record.structured.stored, (version <= CONFIG_VERSION) ? configSize[version] : sizeof(Config_t));
+			break;
+		}
+	}
+}
 
-		if (eeemu_array[i].structured.crc8 != crc8((uint8_t *)eeemu_array[i].structured.stored,MAX_STORED))
+/**
+ * @brief Reads the last valid config of the page that was written by older firmware without a header and converts it.
+ * The page is kept as it is and is taken as full, so the next write goes to the other page
+ * @param page page number
+ */
+static void openOldPage(const uint8_t page)
+{
+	const uint16_t end = findEnd(page, 0, OLD_HALFWORDS, OLD_MAXSTORAGE);
+	for (uint16_t i = end; i > 0; i--)
+	{
+		eeemu_storage_t element;
+		if (readOld(pages[page] + (i - 1) * OLD_HALFWORDS, &element))
 		{
+			convertConfig(element.structured.stored, sizeof(element.structured.stored));
 			break;
 		}
 	}
-	next_pos = i;
+	activePage = page;
+	activeValid = !0;
+	next_pos = MAXSTORAGE;
 }
 
-uint8_t * eeemuGetValue(void)
+void eeemu_write(const Config_t * const config)
 {
-	static uint8_t defVal[MAX_STORED] = {DEFAULT_VALUE};
-	uint8_t * retVal = defVal;
-	if (next_pos != 0)
+	eeemu_record_t u;
+	memset(&u, 0xFF, sizeof(u));
+	current = *config;
+	u.structured.version = CONFIG_VERSION;
+	memcpy(u.structured.stored, config, sizeof(Config_t));
+	u.structured.crc = Crc32(u.words, sizeof(u.words)/sizeof(u.words[0]) - 1);
+	if (activeValid == 0 || next_pos >= MAXSTORAGE) /* No valid page or page full: swap pages */
+	{
+		const uint8_t page = (activeValid == 0) ? 0 : activePage ^ 1;
+		const uint16_t seq = activeSeq + 1;
+		uint16_t header[RECORD_HALFWORDS];
+		memset(header, 0xFF, sizeof(header));
+		header[0] = HEADER_MAGIC;
+		header[1] = seq;
+		header[2] = (uint16_t)(seq ^ 0xFFFF);
+		header[HEADER_ERASES] = (uint16_t)(eeemuStats.configErases[page] + 1);
+		header[HEADER_ERASES + 1] = (uint16_t)((eeemuStats.configErases[page] + 1) >> 16);
+		eeemuErasePage(pages[page]);
+		eeemuProgram(pages[page] + FIRST_RECORD * RECORD_HALFWORDS, u.raw, RECORD_HALFWORDS);
+		/* The magic is written the last so a header cut by a power loss is not valid */
+		eeemuProgram(pages[page] + 1, &header[1], RECORD_HALFWORDS - 1);
+		eeemuProgram(pages[page], header, 1);
+		activePage = page;
+		activeValid = !0;
+		activeSeq = seq;
+		next_pos = FIRST_RECORD + 1;
+		eeemuStats.configErases[page]++;
+	}
+	else
+	{
+		eeemuProgram(pages[activePage] + next_pos * RECORD_HALFWORDS, u.raw, RECORD_HALFWORDS);
+		next_pos++;
+	}
+	eeemuStats.configWrites++;
+}
+
+void eeemu_Init(void)
+{
+	uint16_t seq[EEEMU_PAGES];
+	Page_Format_t format[EEEMU_PAGES];
+	current = defaultConfig;
+	activeValid = 0;
+	activeSeq = 0;
+	for (uint8_t page = 0; page < EEEMU_PAGES; page++)
+	{
+		format[page] = readHeader(page, &seq[page]);
+		eeemuStats.configErases[page] = (format[page] == PAGE_RECORDS) ? readCounter(pages[page] + HEADER_ERASES) : 0;
+	}
+	eeemuStats.configWrites = 0;
+	if (format[0] != PAGE_INVALID || format[1] != PAGE_INVALID)
+	{
+		uint8_t page = (format[1] != PAGE_INVALID) ? 1 : 0;
+		if (format[0] != PAGE_INVALID && format[1] != PAGE_INVALID)
+		{
+			page = ((int16_t)(seq[1] - seq[0]) > 0) ? 1 : 0;
+		}
+		activeSeq = seq[page];
+		openPage(page);
+		/* Every erase but the one of the active page was followed by filling the page */
+		const uint32_t erases = eeemuStats.configErases[0] + eeemuStats.configErases[1];
+		eeemuStats.configWrites = ((erases == 0) ? 0 : (erases - 1) * (MAXSTORAGE - FIRST_RECORD)) + next_pos - FIRST_RECORD;
+	}
+	else if (!isErased(eeemu_array, OLD_HALFWORDS)) /* Written by older firmware, without a header */
+	{
+		openOldPage(0);
+	}
+	seedFirst = (seeds_array[0] == SEED_MAGIC) ? SEED_FIRST : 0;
+	eeemuStats.seedErases = (seedFirst != 0) ? readCounter(&seeds_array[1]) : 0;
+	/* A page without a header is written by older firmware and starts with a seed, else its erase was cut by a power loss */
+	seed_pos = (seedFirst != 0 || (seeds_array[0] & 0x8000) == 0) ? getCurrentSeedIdx() : SEED_NOT_INITED;
+	seedValue = (SEED_NOT_INITED == seed_pos) ? SEED_NOT_INITED : seeds_array[seed_pos];
+	eeemuStats.seedWrites = ((eeemuStats.seedErases == 0) ? 0 : (eeemuStats.seedErases - 1) * (SEEDS - SEED_FIRST)) +
+			((SEED_NOT_INITED == seed_pos) ? 0 : seed_pos + 1 - seedFirst);
+	const uint16_t next = (SEED_NOT_INITED == seed_pos) ? seedFirst : seed_pos + 1;
+	if (next < SEEDS && seeds_array[next] != 0xFFFF) /* A seed write was cut by a power loss, the page is rewritten */
 	{
-		retVal = (uint8_t *)eeemu_array[next_pos - 1].structured.stored;
+		seed_pos = SEEDS - 1;
+	}
+	if (seed_pos == SEEDS - 1) /* The page is erased now rather than at the seed write in the middle of a mode start */
+	{
+		eeemuEraseSeedPage();
+		seed_pos = SEED_NOT_INITED;
+		if (seedValue != SEED_NOT_INITED)
+		{
+			eeemuProgram(&seeds_array[SEED_FIRST], &seedValue, 1);
+			seed_pos = SEED_FIRST;
+		}
 	}
-	return retVal;
+}
+
+const Config_t * eeemuGetConfig(void)
+{
+	return &current;
 }
 
 
 
 uint16_t eeemuSeedGet(void)
 {
-	const uint16_t pos = getCurrentSeedIdx();
-	return (SEED_NOT_INITED == pos) ? SEED_NOT_INITED : seeds_array[pos];
+	return seedValue;
 }
 
 void eeemuSeedSet(const uint16_t seed)
 {
-	uint16_t pos = getCurrentSeedIdx();
-	if ((SEED_NOT_INITED == pos) || (1024/sizeof(seeds_array[0]) - 1 == pos))
+	uint16_t pos = seed_pos;
+	if ((SEED_NOT_INITED == pos && seedFirst == 0) || (SEEDS - 1 == pos))
 	{
-		eeemuErasePage((uint32_t)(&seeds_array[0]));
-		pos = 0;
+		eeemuEraseSeedPage();
+		pos = SEED_FIRST;
 	}
 	else
 	{
-		pos++;
+		pos = (SEED_NOT_INITED == pos) ? seedFirst : pos + 1;
 	}
-	waitBusy();
-	FLASH->KEYR = 0x45670123;
-	FLASH->KEYR = 0xCDEF89AB;
-	FLASH->CR |= FLASH_CR_PG;
-	seeds_array[pos] = seed;
-	waitBusy();
-	FLASH->CR &= ~FLASH_CR_PG;
-	FLASH->CR |= FLASH_CR_LOCK;
+	seedValue = seed;
+	eeemuProgram(&seeds_array[pos], &seed, 1);
+	seed_pos = pos;
+	eeemuStats.seedWrites++;
+}
 
+uint8_t eeemuGetWear(const uint8_t seed)
+{
+	uint32_t erases = eeemuStats.seedErases;
+	if (seed == 0)
+	{
+		erases = (eeemuStats.configErases[0] > eeemuStats.configErases[1]) ? eeemuStats.configErases[0] : eeemuStats.configErases[1];
+	}
+	return (erases >= FLASH_ENDURANCE) ? 99 : (uint8_t)(erases * 100 / FLASH_ENDURANCE);
 }
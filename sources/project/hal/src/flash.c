@@ -0,0 +1,262 @@
+/**
+ * @file flash.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.20
+ * @brief Contains asynchronous flash erase/program driver. The queue is changed by the main loop (adding) and by the
+ * flash interrupt (removing), the start of a job is done with interrupts disabled
+ */
+#include <stddef.h>
+#include "stm32f1xx.h"
+#include "flash.h"
+#include "timer_dma.h"
+#include "clock.h"
+#include "profiler.h"
+
+/**
+ * @brief Job types
+ */
+typedef enum
+{
+	FLASH_JOB_ERASE = 0, /**< Page erase */
+	FLASH_JOB_PROGRAM    /**< Halfwords programming */
+}Flash_Job_Type_t;
+
+/**
+ * @brief Queued job
+ */
+typedef struct
+{
+	Flash_Job_Type_t type; /**< Job type */
+	uint8_t n; /**< Number of halfwords to program */
+	volatile uint16_t * addr; /**< Page address or the first halfword address */
+	uint16_t data[FLASH_JOB_HALFWORDS]; /**< Halfwords to program */
+	pFlashDone_t done; /**< Completion callback */
+}Flash_Job_t;
+
+static Flash_Job_t queue[FLASH_QUEUE_LEN]; /**< Job queue */
+static volatile uint8_t head = 0; /**< The oldest job */
+static volatile uint8_t count = 0; /**< Number of jobs in the queue */
+static volatile uint8_t running = 0; /**< Nonzero if the oldest job is started */
+static uint8_t pos = 0; /**< Halfword of the running program job */
+static uint8_t ok = 0; /**< Nonzero if the running job had no errors */
+
+/**
+ * @brief Checks if any strip channel is being sent
+ * @return nonzero if busy
+ */
+static uint8_t isStripBusy(void)
+{
+	uint8_t busy = 0;
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		busy = busy || tim2_IsBusy(ch);
+	}
+	return busy;
+}
+
+/**
+ * @brief Reads back the result of the job
+ * @param job finished job
+ * @return nonzero if the flash contains the expected data
+ */
+static uint8_t verifyJob(const Flash_Job_t * const job)
+{
+	uint8_t match = !0;
+	if (job->type == FLASH_JOB_ERASE)
+	{
+		const volatile uint16_t * const page = job->addr;
+		for (uint16_t i = 0; i < FLASH_PAGE_SIZE / sizeof(uint16_t) && match != 0; i++)
+		{
+			match = (page[i] == 0xFFFF);
+		}
+	}
+	else
+	{
+		const volatile uint16_t * const dst = job->addr;
+		for (uint8_t i = 0; i < job->n && match != 0; i++)
+		{
+			match = (dst[i] == job->data[i]);
+		}
+	}
+	return match;
+}
+
+/**
+ * @brief Starts the current step of the oldest job
+ */
+static void startStep(void)
+{
+	const Flash_Job_t * const job = queue + head;
+	if (job->type == FLASH_JOB_ERASE)
+	{
+		FLASH->CR |= FLASH_CR_PER;
+		FLASH->AR = (uint32_t)job->addr;
+		FLASH->CR |= FLASH_CR_STRT;
+	}
+	else
+	{
+		FLASH->CR |= FLASH_CR_PG;
+		job->addr[pos] = job->data[pos];
+	}
+}
+
+/**
+ * @brief Starts the oldest job if nothing is running. Must be called with interrupts disabled or from the flash interrupt
+ */
+static void startNext(void)
+{
+	if (running == 0 && count != 0 && isStripBusy() == 0 && (FLASH->SR & FLASH_SR_BSY) == 0)
+	{
+		running = !0;
+		pos = 0;
+		ok = !0;
+		FLASH->KEYR = 0x45670123;
+		FLASH->KEYR = 0xCDEF89AB;
+		FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
+		FLASH->CR |= FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+		startStep();
+	}
+}
+
+/**
+ * @brief Fails all queued jobs, the running one too. A late interrupt of the running job is ignored
+ */
+static void failJobs(void)
+{
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PG | FLASH_CR_EOPIE | FLASH_CR_ERRIE);
+	FLASH->CR |= FLASH_CR_LOCK;
+	running = 0;
+	while (count != 0)
+	{
+		const pFlashDone_t done = queue[head].done;
+		head = (head + 1) % FLASH_QUEUE_LEN;
+		count--;
+		if (done != NULL)
+		{
+			done(0);
+		}
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief Waits while the queue is longer than the length. If no job is finished for @ref FLASH_TIMEOUT_MS
+ * the flash or the strip is stuck and all the jobs are failed
+ * @param len queue length
+ */
+static void waitQueue(const uint8_t len)
+{
+	uint32_t timer;
+	uint8_t left = count;
+	ResetTimer(&timer);
+	while (count > len)
+	{
+		Flash_Process();
+		if (count != left)
+		{
+			left = count;
+			ResetTimer(&timer);
+		}
+		else if (ReadTimer(&timer) >= FLASH_TIMEOUT_MS)
+		{
+			failJobs();
+		}
+	}
+}
+
+/**
+ * @brief Adds a job to the queue. Waits while the queue is full
+ * @param job job to copy
+ */
+static void addJob(const Flash_Job_t * const job)
+{
+	waitQueue(FLASH_QUEUE_LEN - 1);
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	queue[(head + count) % FLASH_QUEUE_LEN] = *job;
+	count++;
+	startNext();
+	__set_PRIMASK(primask);
+}
+
+void Flash_Init(void)
+{
+	NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+void Flash_Erase(volatile uint16_t * const page, const pFlashDone_t done)
+{
+	const Flash_Job_t job = {.type = FLASH_JOB_ERASE, .n = 0, .addr = page, .done = done};
+	addJob(&job);
+}
+
+void Flash_Program(volatile uint16_t * const dst, const uint16_t * const src, const uint8_t n, const pFlashDone_t done)
+{
+	Flash_Job_t job = {.type = FLASH_JOB_PROGRAM, .n = (n > FLASH_JOB_HALFWORDS) ? FLASH_JOB_HALFWORDS : n, .addr = dst, .done = done};
+	for (uint8_t i = 0; i < job.n; i++)
+	{
+		job.data[i] = src[i];
+	}
+	addJob(&job);
+}
+
+void Flash_Process(void)
+{
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	startNext();
+	__set_PRIMASK(primask);
+}
+
+uint8_t Flash_IsBusy(void)
+{
+	return count != 0;
+}
+
+void Flash_Flush(void)
+{
+	waitQueue(0);
+}
+
+void FLASH_IRQHandler(void);
+/**
+ * @brief Flash end of operation and error interrupt. Programs the next halfword or finishes and reads back the job and starts the next one
+ */
+void FLASH_IRQHandler(void)
+{
+	PROFILE_START();
+	const uint32_t sr = FLASH->SR;
+	FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
+	if (running != 0)
+	{
+		const Flash_Job_t * const job = queue + head;
+		if ((sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) != 0)
+		{
+			ok = 0;
+		}
+		if (job->type == FLASH_JOB_PROGRAM && ok != 0 && ++pos < job->n)
+		{
+			startStep();
+		}
+		else
+		{
+			FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PG | FLASH_CR_EOPIE | FLASH_CR_ERRIE);
+			FLASH->CR |= FLASH_CR_LOCK;
+			ok = ok && verifyJob(job);
+			const pFlashDone_t done = job->done;
+			head = (head + 1) % FLASH_QUEUE_LEN;
+			count--;
+			running = 0;
+			if (done != NULL)
+			{
+				done(ok);
+			}
+			startNext();
+		}
+	}
+	PROFILE_END(PROF_ISR_FLASH);
+}
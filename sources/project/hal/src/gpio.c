@@ -33,6 +33,7 @@ typedef struct
 static const Gpio_Config_t Gpio_Config[GPIO_TOTAL]=
 {
 		[GPIO_WS_OUT]       = {.Port = GPIOA,.Pin = 0,  .Mode = GPIO_MODE_DO_NOT_TOUCH}, /* Nucleo pin cn7.28 */
+		[GPIO_WS_OUT2]      = {.Port = GPIOA,.Pin = 6,  .Mode = GPIO_MODE_DO_NOT_TOUCH}, /* Second row in parallel layout */
 		[GPIO_BUTTON]       = {.Port = GPIOA,.Pin = 2,  .Mode = GPIO_MODE_IN},
 		[GPIO_HEARTBEAT] 	= {.Port = GPIOC,.Pin = 13,	.Mode = GPIO_MODE_OUT	}
 };
@@ -132,3 +133,18 @@ void Gpio_Get_Alt_PortPin(const Gpio_Desc_t Gpio,GPIO_TypeDef ** const Port,uint
 		}
 	}
 }
+
+void Gpio_Exti_Init(const Gpio_Desc_t Gpio)
+{
+	if (Gpio < GPIO_TOTAL && GPIO_MODE_IN == Gpio_Config[Gpio].Mode)
+	{
+		const uint8_t pin = Gpio_Config[Gpio].Pin;
+		const uint32_t port = ((uint32_t)Gpio_Config[Gpio].Port - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE);
+		const uint8_t shift = (pin % 4) * 4;
+		AFIO->EXTICR[pin / 4] = (AFIO->EXTICR[pin / 4] & ~(0xFu << shift)) | (port << shift);
+		EXTI->RTSR |= 1u << pin;
+		EXTI->FTSR |= 1u << pin;
+		EXTI->PR = 1u << pin;
+		EXTI->IMR |= 1u << pin;
+	}
+}
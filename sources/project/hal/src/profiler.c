@@ -0,0 +1,45 @@
+/**
+ * @file profiler.c
+ * @author Mykhaylo Shcherbak
+ * @e mikl74@yahoo.com
+ * @date 16-10-2026
+ * @version 1.00
+ * @brief Contains cpu profiler implementation. Every section has one writer (a task or an interrupt) so no locking is needed.
+ * Task times include interrupts that came during the task
+ */
+#include "profiler.h"
+
+#ifdef PROFILING
+volatile Profiler_t Profiler;
+
+void Profiler_Add(const Prof_Id_t id, const uint32_t cycles)
+{
+	if (id < PROF_TOTAL)
+	{
+		volatile Prof_Entry_t * const e = Profiler.entries + id;
+		if (e->calls == 0 || cycles < e->min)
+		{
+			e->min = cycles;
+		}
+		if (cycles > e->max)
+		{
+			e->max = cycles;
+		}
+		e->total += cycles;
+		e->calls++;
+	}
+}
+
+void Profiler_Update(void)
+{
+	for (uint8_t id = 0; id < PROF_TOTAL; id++)
+	{
+		volatile Prof_Entry_t * const e = Profiler.entries + id;
+		if (e->calls != 0)
+		{
+			e->avg = (uint32_t)(e->total / e->calls);
+		}
+	}
+	Profiler.cpuLoad = 100 - Clock_GetSleepPercent();
+}
+#endif
@@ -3,23 +3,63 @@
  * @author Mykhaylo Shcherbak
  * @e mikl74@yahoo.com
  * @date 21-11-2019
- * @version 1.00
- * @brief Contains timer2+dma driver to send data to led strip
+ * @version 1.20
+ * @brief Contains timer2+dma driver to send data to led strip.
+ * DMA runs in circular mode over a buffer of two halves. Each half is refilled from the DMA interrupt while the other one is being sent.
+ * With @ref STRIP_LAYOUT_PARALLEL the second row is driven by timer3 ch1 and its own DMA channel at the same time.
  */
 
 #include <stddef.h>
 #include "stm32f1xx.h"
 #include "timer_dma.h"
 #include "gpio.h"
+#include "profiler.h"
+
+/**
+ * @brief Hardware used by one output channel. The timer drives its ch1 and requests DMA on update
+ */
+typedef struct
+{
+	TIM_TypeDef *Tim; /**< Timer */
+	uint32_t TimEn; /**< Timer clock enable bit in RCC->APB1ENR */
+	DMA_Channel_TypeDef *Dma; /**< DMA1 channel serving the timer update request */
+	uint8_t DmaFlagsPos; /**< Position of the channel flags in DMA1->ISR */
+	IRQn_Type Irq; /**< DMA channel interrupt */
+	Gpio_Desc_t Gpio; /**< Out pin */
+} Out_Config_t;
+
+static const Out_Config_t Out_Config[STRIP_CHANNELS] =
+{
+		{.Tim = TIM2, .TimEn = RCC_APB1ENR_TIM2EN, .Dma = DMA1_Channel2, .DmaFlagsPos = 4, .Irq = DMA1_Channel2_IRQn, .Gpio = GPIO_WS_OUT},
+#if STRIP_CHANNELS > 1
+		{.Tim = TIM3, .TimEn = RCC_APB1ENR_TIM3EN, .Dma = DMA1_Channel3, .DmaFlagsPos = 8, .Irq = DMA1_Channel3_IRQn, .Gpio = GPIO_WS_OUT2},
+#endif
+};
+
+/**
+ * @brief Output channel state
+ */
+typedef struct
+{
+	uint8_t *baddr; /**< Circular buffer */
+	uint16_t bsize; /**< Circular buffer size */
+	pFillHalf_t pFill; /**< Refill callback */
+	volatile uint8_t busy; /**< Nonzero while the stream is running */
+} Out_State_t;
+
+static Out_State_t Out_State[STRIP_CHANNELS];
+
+static volatile uint32_t underruns = 0;
 
 /**
  * @brief Inits pin to which the strip is connected as af push-pull
+ * @param Gpio pin id
  */
-static void pin_init(void)
+static void pin_init(const Gpio_Desc_t Gpio)
 {
 	GPIO_TypeDef *portOut;
 	uint8_t pinOut;
-	Gpio_Get_Alt_PortPin(GPIO_WS_OUT,&portOut,&pinOut);
+	Gpio_Get_Alt_PortPin(Gpio,&portOut,&pinOut);
 	if ( pinOut < 8 )
 	{
 		portOut->CRL |=  (0b11u<< (pinOut * 4)); /* 0b11 = 50Mhz */
@@ -37,53 +77,153 @@ static void pin_init(void)
 
 void tim2_Init(void)
 {
-	pin_init();
-	RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
-	TIM2->ARR = 84 - 1; /* 1.25us from 64Mhz */
-	TIM2->PSC = 0;
-	TIM2->CR1 = TIM_CR1_ARPE;
-	TIM2->DIER = TIM_DIER_UDE;
-	TIM2->CCMR1 &= ~(TIM_CCMR1_OC1M_0);
-	TIM2->CCMR1  |= TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 |  TIM_CCMR1_OC1PE;
-	TIM2->CCR1 = 0;
-	TIM2->CCER |= TIM_CCER_CC1E;
-	TIM2->EGR  |= TIM_EGR_UG;
-
 	RCC->AHBENR  |= RCC_AHBENR_DMA1EN;
-	DMA1_Channel2->CCR = DMA_CCR_DIR | /* DMA_CCR_CIRC | */ DMA_CCR_MINC  | DMA_CCR_PSIZE_0 | DMA_CCR_PL_1;
-	DMA1_Channel2->CPAR = (uint32_t)&TIM2->CCR1;
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		const Out_Config_t * const out = Out_Config + ch;
+		TIM_TypeDef * const tim = out->Tim;
+		pin_init(out->Gpio);
+		RCC->APB1ENR |= out->TimEn;
+		tim->ARR = STRIP_BIT_TICKS - 1; /* 1.3125us from 64Mhz */
+		tim->PSC = 0;
+		tim->CR1 = TIM_CR1_ARPE;
+		tim->DIER = TIM_DIER_UDE;
+		tim->CCMR1 &= ~(TIM_CCMR1_OC1M_0);
+		tim->CCMR1  |= TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 |  TIM_CCMR1_OC1PE;
+		tim->CCR1 = 0;
+		tim->CCER |= TIM_CCER_CC1E;
+		tim->EGR  |= TIM_EGR_UG;
 
-	TIM2->CR1 |= TIM_CR1_CEN;
+		out->Dma->CCR = DMA_CCR_DIR | DMA_CCR_CIRC | DMA_CCR_MINC  | DMA_CCR_PSIZE_0 | DMA_CCR_PL_1 |
+				DMA_CCR_HTIE | DMA_CCR_TCIE;
+		out->Dma->CPAR = (uint32_t)&tim->CCR1;
+		NVIC_EnableIRQ(out->Irq);
+	}
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		Out_Config[ch].Tim->CR1 |= TIM_CR1_CEN;
+	}
 }
 
-static uint32_t baddr = 0;
-static uint16_t bsize = 0;
-void tim2_set_data(uint8_t * const addr, const uint16_t size)
+void tim2_set_data(const uint8_t ch, uint8_t * const addr, const uint16_t size, pFillHalf_t const fill)
 {
-	if (addr != NULL && size != 0)
+	if (ch < STRIP_CHANNELS && addr != NULL && size != 0 && fill != NULL)
 	{
-		baddr = (uint32_t)addr;
-		bsize = size;
+		Out_State[ch].baddr = addr;
+		Out_State[ch].bsize = size;
+		Out_State[ch].pFill = fill;
 	}
 }
 
-void tim2_TransferBits(void)
+/**
+ * @brief Stops the stream. CCR1 keeps the last (zero) value so the out stays low
+ * @param ch channel
+ */
+static void stop(const uint8_t ch)
+{
+	Out_Config[ch].Dma->CCR &= ~DMA_CCR_EN;
+	Out_State[ch].busy = 0;
+}
+
+/**
+ * @brief Common part of DMA ISRs. Refills the half that has just been sent while the other one is being sent
+ * @param ch channel
+ */
+static void dmaIrq(const uint8_t ch)
 {
-	if (baddr |= 0 && bsize != 0)
+	PROFILE_START();
+	Out_State_t * const state = Out_State + ch;
+	const uint8_t pos = Out_Config[ch].DmaFlagsPos;
+	const uint32_t isr = DMA1->ISR >> pos;
+	const uint16_t half = state->bsize / 2;
+	if ((isr & (DMA_ISR_HTIF1 | DMA_ISR_TCIF1)) == (DMA_ISR_HTIF1 | DMA_ISR_TCIF1))
 	{
-		static uint8_t WasStarted = 0;
-		if (WasStarted != 0)
+		underruns++; /* Both halves were sent while the previous one was being refilled */
+	}
+	if ((isr & DMA_ISR_HTIF1) != 0)
+	{
+		DMA1->IFCR = DMA_IFCR_CHTIF1 << pos;
+		if (state->busy != 0 && state->pFill(ch, state->baddr, half) == 0)
 		{
-			while ((DMA1->ISR & DMA_ISR_TCIF2) == 0)
-			{
+			stop(ch);
+		}
+	}
+	if ((isr & DMA_ISR_TCIF1) != 0)
+	{
+		DMA1->IFCR = DMA_IFCR_CTCIF1 << pos;
+		if (state->busy != 0 && state->pFill(ch, state->baddr + half, half) == 0)
+		{
+			stop(ch);
+		}
+	}
+	PROFILE_END(PROF_ISR_STRIP_DMA);
+}
+
+void DMA1_Channel2_IRQHandler(void);
+/**
+ * @brief DMA ISR of the first (or the only) channel
+ */
+void DMA1_Channel2_IRQHandler(void)
+{
+	dmaIrq(0);
+}
 
-			}
+#if STRIP_CHANNELS > 1
+void DMA1_Channel3_IRQHandler(void);
+/**
+ * @brief DMA ISR of the second channel
+ */
+void DMA1_Channel3_IRQHandler(void)
+{
+	dmaIrq(1);
+}
+#endif
+
+void tim2_TransferBits(const uint8_t ch)
+{
+	/* A running stream is not restarted: it takes the next frame itself from the refill callback.
+	 * Waiting here would deadlock as the caller keeps the dma interrupt that stops the stream disabled */
+	if (ch < STRIP_CHANNELS && Out_State[ch].baddr != NULL && Out_State[ch].bsize != 0 && Out_State[ch].busy == 0)
+	{
+		Out_State_t * const state = Out_State + ch;
+		DMA_Channel_TypeDef * const dma = Out_Config[ch].Dma;
+		const uint16_t half = state->bsize / 2;
+		if (state->pFill(ch, state->baddr, half) != 0)
+		{
+			state->pFill(ch, state->baddr + half, half);
+			DMA1->IFCR = DMA_IFCR_CGIF1 << Out_Config[ch].DmaFlagsPos;
+			dma->CMAR = (uint32_t)state->baddr;
+			dma->CNDTR = state->bsize;
+			state->busy = !0;
+			dma->CCR |= DMA_CCR_EN;
 		}
+	}
+}
+
+uint8_t tim2_IsBusy(const uint8_t ch)
+{
+	return (ch < STRIP_CHANNELS) ? Out_State[ch].busy : 0;
+}
 
-		DMA1_Channel2->CCR &= ~DMA_CCR_EN;
-		DMA1_Channel2->CMAR = baddr;
-		DMA1_Channel2->CNDTR = bsize;
-		DMA1_Channel2->CCR |= DMA_CCR_EN;
-		WasStarted = !0;
+void tim2_DisableIrq(void)
+{
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		NVIC_DisableIRQ(Out_Config[ch].Irq);
 	}
+	__DSB();
+	__ISB();
+}
+
+void tim2_EnableIrq(void)
+{
+	for (uint8_t ch = 0; ch < STRIP_CHANNELS; ch++)
+	{
+		NVIC_EnableIRQ(Out_Config[ch].Irq);
+	}
+}
+
+uint32_t tim2_GetUnderruns(void)
+{
+	return underruns;
 }
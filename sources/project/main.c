@@ -110,8 +110,15 @@
 #include "timer_dma.h"
 #include "buttons.h"
 #include "eeemu.h"
+#include "flash.h"
+#include "crc.h"
 #include "watchdog.h"
 #include "adc.h"
+#include "profiler.h"
+#ifdef RGBW_BENCHMARK
+#include "rgbw.h"
+#include "led_strip.h"
+#endif
 
 /* This is test comment #0000 */
 /**
@@ -121,12 +128,19 @@ static void Init(void)
 {
 	Clock_HSE_Init();
 	Systick_Init();
+	CycleCounter_Init();
 	Gpio_Init();
 	Buttons_Init();
 	tim2_Init();
+	Flash_Init();
+	Crc_Init();
 	eeemu_Init();
 	Adc_Init();
         watchdog_Init();
+#ifdef RGBW_BENCHMARK
+	rgbw_Benchmark();
+	ledStrip_Benchmark();
+#endif
 }
 
 
@@ -135,7 +149,16 @@ void main(void)
 	Init();
 	while(1)
 	{
+#ifdef PROFILING
+		if (MainLoop_Iteration() != 0)
+		{
+			Profiler_Update();
+		}
+#else
 		MainLoop_Iteration();
+#endif
+		Flash_Process(); /* Queued flash jobs start when the strip is not being sent */
 		Reset_Watchdog();
+		Clock_Sleep(MainLoop_TimeToNextTask());
 	}
 }